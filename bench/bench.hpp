@@ -0,0 +1,221 @@
+/* pqRand: The precise quantile random package
+ * Copyright (C) 2017 Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ *
+ * This package is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the COPYRIGHT_NOTICE for more details.
+ *
+ * Under Section 7 of GPL version 3, you are granted additional
+ * permissions described in the GCC Runtime Library Exception, version
+ * 3.1, as published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License and
+ * a copy of the GCC Runtime Library Exception along with this package;
+ * see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+ * <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+*  @file bench.hpp
+*  @brief Timing and JSON utilities shared by the benchmarks in bench/ (run with "make bench").
+*
+*  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+*  @date 2017
+*/
+
+#ifndef PQR_BENCH
+#define PQR_BENCH
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm> // sort
+#include <cmath> // isfinite
+#include <cstdio>
+#include <cstdlib> // strtod
+#include <cstring> // strcmp
+
+namespace bench
+{
+	//! @brief Keep the compiler from discarding a value we only compute to time it.
+	template<typename T>
+	inline void Escape(T const& value)
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	//! @brief The command line options common to every benchmark.
+	struct options
+	{
+		double minSeconds; //!< The minimum time spent in each repetition.
+		size_t reps; //!< The number of repetitions (we report the median).
+		size_t maxThreads; //!< The maximum number of threads (0 => every hardware thread).
+		char const* outFile; //!< Where to write the JSON (nullptr => stdout).
+
+		options(): minSeconds(0.1), reps(5), maxThreads(0), outFile(nullptr) {}
+
+		/*! @brief Parse "--min-time <seconds>", "--reps <n>", "--threads <n>" and "--out <file>" 
+		 *  (return false on error).
+		*/
+		bool Parse(int const argc, char const* const* const argv)
+		{
+			for(int i = 1; i < argc; ++i)
+			{
+				if((i + 1) == argc)
+					return false;
+				else if(std::strcmp(argv[i], "--min-time") == 0)
+					minSeconds = std::strtod(argv[++i], nullptr);
+				else if(std::strcmp(argv[i], "--reps") == 0)
+					reps = size_t(std::strtoul(argv[++i], nullptr, 10));
+				else if(std::strcmp(argv[i], "--threads") == 0)
+					maxThreads = size_t(std::strtoul(argv[++i], nullptr, 10));
+				else if(std::strcmp(argv[i], "--out") == 0)
+					outFile = argv[++i];
+				else
+					return false;
+			}
+			return (minSeconds > 0.) and (reps > 0);
+		}
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief The median nanoseconds per call of \p op.
+	 *
+	 *  Each repetition calls \p op in batches (doubling the batch size)
+	 *  until at least \p minSeconds have elapsed, so that the clock's overhead is negligible.
+	*/
+	template<class op_t>
+	double NanosecondsPerCall(op_t&& op, options const& opts)
+	{
+		typedef std::chrono::steady_clock clock;
+
+		std::vector<double> perCall;
+		size_t batch = 1;
+
+		// Warm up (caches, branch predictors, lazy initialization)
+		for(size_t i = 0; i < 64; ++i)
+			op();
+
+		for(size_t rep = 0; rep < opts.reps; ++rep)
+		{
+			size_t calls = 0;
+			auto const begin = clock::now();
+			double elapsed;
+
+			do
+			{
+				for(size_t i = 0; i < batch; ++i)
+					op();
+				calls += batch;
+
+				elapsed = std::chrono::duration<double>(clock::now() - begin).count();
+
+				if(elapsed < 0.01 * opts.minSeconds)
+					batch *= 2; // Grow the batch while clock calls are significant
+			}
+			while(elapsed < opts.minSeconds);
+
+			perCall.push_back(1e9 * elapsed / double(calls));
+		}
+
+		std::sort(perCall.begin(), perCall.end());
+		return perCall[perCall.size() / 2];
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief Write a flat JSON document: { header fields, "results": [ {record}, ... ] }.
+	 *
+	 *  Non-finite numbers (e.g. a missing reference) are written as null.
+	*/
+	class json_writer
+	{
+		private:
+			FILE* out;
+			bool firstRecord;
+			bool firstField;
+			char padding[sizeof(FILE*) - 2 * sizeof(bool)]; // Explicit, so -Wpadded stays quiet
+
+			void Key(char const* const key)
+			{
+				std::fprintf(out, "%s\"%s\": ", firstField ? "" : ", ", key);
+				firstField = false;
+			}
+
+			void Number(double const value)
+			{
+				if(std::isfinite(value))
+					std::fprintf(out, "%.6g", value);
+				else
+					std::fprintf(out, "null");
+			}
+
+		public:
+			//! @brief Open the document (\p fileName = nullptr => stdout).
+			json_writer(char const* const fileName, char const* const benchmark):
+				out(fileName ? std::fopen(fileName, "w") : stdout),
+				firstRecord(true), firstField(true), padding()
+			{
+				if(not out) out = stdout;
+
+				std::fprintf(out, "{\n  \"benchmark\": \"%s\",\n  \"compiler\": \"%s\",\n  \"results\": [",
+					benchmark, __VERSION__);
+			}
+
+			~json_writer()
+			{
+				std::fprintf(out, "\n  ]\n}\n");
+				if(out not_eq stdout) std::fclose(out);
+			}
+
+			json_writer(json_writer const&) = delete;
+			json_writer& operator = (json_writer const&) = delete;
+
+			void BeginRecord()
+			{
+				std::fprintf(out, "%s\n    {", firstRecord ? "" : ",");
+				firstRecord = false;
+				firstField = true;
+			}
+
+			void EndRecord() {std::fprintf(out, "}"); std::fflush(out);}
+
+			void Field(char const* const key, std::string const& value)
+			{
+				Key(key);
+				std::fprintf(out, "\"%s\"", value.c_str());
+			}
+
+			void Field(char const* const key, double const value)
+			{
+				Key(key);
+				Number(value);
+			}
+
+			void Field(char const* const key, std::vector<double> const& values)
+			{
+				Key(key);
+				std::fprintf(out, "[");
+				for(size_t i = 0; i < values.size(); ++i)
+				{
+					if(i > 0) std::fprintf(out, ", ");
+					Number(values[i]);
+				}
+				std::fprintf(out, "]");
+			}
+	};
+}
+
+#endif
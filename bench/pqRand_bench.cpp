@@ -0,0 +1,339 @@
+// Throughput of the pqRand engine and of every distribution (run with "make bench").
+//
+// For each operation we measure the median ns/variate and the corresponding GB/s
+// (bytes of variates produced per second), alongside the closest equivalent
+// from the C++ standard library (std::mt19937_64 with the matching std::*_distribution).
+// The results are written as JSON (to stdout, or to the file given by --out),
+// so they can be compared across releases.
+//
+//		pqRand_bench.x [--min-time <seconds>] [--reps <n>] [--out <file.json>]
+
+#include "pqRand.hpp"
+#include "distributions.hpp"
+#include "bench.hpp"
+#include <random>
+#include <limits>
+#include <memory> // unique_ptr
+
+using namespace pqRand;
+
+// A placeholder for operations which have no standard library equivalent
+struct no_reference {};
+
+// The number of variates in each call to GetSample
+size_t static constexpr sampleSize = (size_t(1) << 14);
+
+////////////////////////////////////////////////////////////////////////
+
+// Write one record; ns_per_variate is converted to GB/s using the size of the variate
+static void Record(bench::json_writer& json, std::string const& name, std::string const& method,
+	size_t const bytes, double const ns, std::string const& reference, double const ref_ns)
+{
+	json.BeginRecord();
+	json.Field("name", name);
+	json.Field("method", method);
+	json.Field("bytes_per_variate", double(bytes));
+	json.Field("ns_per_variate", ns);
+	json.Field("GB_per_s", double(bytes) / ns);
+	json.Field("reference", reference);
+	json.Field("reference_ns_per_variate", ref_ns);
+	json.Field("reference_GB_per_s", double(bytes) / ref_ns);
+	json.Field("speedup", ref_ns / ns);
+	json.Field("isa", ISA_Name(ActiveISA())); // The tier of the array kernels (PQR_ISA overrides)
+	json.EndRecord();
+
+	std::fprintf(stderr, "%-32s %-12s %8.3f ns   (%s: %.3f ns)\n",
+		name.c_str(), method.c_str(), ns, reference.c_str(), ref_ns);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Time one variate from the std reference (NaN if there is none)
+template<class std_t>
+double Reference_Call(std_t& stdDist, std::mt19937_64& mt, bench::options const& opts)
+{
+	return bench::NanosecondsPerCall([&]() {bench::Escape(stdDist(mt));}, opts);
+}
+
+static double Reference_Call(no_reference&, std::mt19937_64&, bench::options const&)
+	{return std::numeric_limits<double>::quiet_NaN();}
+
+// Time a GetSample-like vector from the std reference (per variate)
+template<class std_t>
+double Reference_Sample(std_t& stdDist, std::mt19937_64& mt, bench::options const& opts)
+{
+	typedef decltype(stdDist(mt)) T;
+
+	// Not a std::vector, since std::vector<bool> is packed
+	return bench::NanosecondsPerCall([&]()
+		{
+			std::unique_ptr<T[]> sample(new T[sampleSize]);
+			for(size_t i = 0; i < sampleSize; ++i)
+				sample[i] = stdDist(mt);
+			bench::Escape(sample.get());
+		}, opts) / double(sampleSize);
+}
+
+static double Reference_Sample(no_reference&, std::mt19937_64&, bench::options const&)
+	{return std::numeric_limits<double>::quiet_NaN();}
+
+////////////////////////////////////////////////////////////////////////
+
+// A name with a parameter, e.g. "poisson(0.5)"
+static std::string Label(char const* const name, double const param)
+{
+	char label[64];
+	std::snprintf(label, sizeof(label), "%s(%g)", name, param);
+	return label;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Benchmark a pqRand distribution via operator() and GetSample,
+// and its std reference the same way.
+template<class dist_t, class std_t>
+void BenchDistribution(bench::json_writer& json, bench::options const& opts,
+	std::string const& name, dist_t const& dist, std_t stdDist, std::string const& reference)
+{
+	engine gen;
+	std::mt19937_64 mt(gen());
+	size_t const bytes = sizeof(decltype(dist(gen)));
+
+	Record(json, name, "operator()", bytes,
+		bench::NanosecondsPerCall([&]() {bench::Escape(dist(gen));}, opts),
+		reference, Reference_Call(stdDist, mt, opts));
+
+	Record(json, name, "GetSample", bytes,
+		bench::NanosecondsPerCall([&]()
+			{
+				auto const sample = dist.GetSample(sampleSize, gen);
+				bench::Escape(sample.data());
+			}, opts) / double(sampleSize),
+		reference, Reference_Sample(stdDist, mt, opts));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char const* const* argv)
+{
+	bench::options opts;
+
+	if(not opts.Parse(argc, argv))
+	{
+		std::fprintf(stderr, "usage: %s [--min-time <seconds>] [--reps <n>] [--out <file.json>]\n", argv[0]);
+		return 1;
+	}
+
+	bench::json_writer json(opts.outFile, "pqRand_bench");
+
+	// The engine's utility functions
+	{
+		engine gen;
+		std::mt19937_64 mt(gen());
+		std::uniform_real_distribution<double> stdUniform(0., 1.);
+		std::bernoulli_distribution stdBool(0.5);
+
+		Record(json, "engine", "operator()", sizeof(uint64_t),
+			bench::NanosecondsPerCall([&]() {bench::Escape(gen());}, opts),
+			"std::mt19937_64", bench::NanosecondsPerCall([&]() {bench::Escape(mt());}, opts));
+
+		Record(json, "engine", "U_uneven", sizeof(real_t),
+			bench::NanosecondsPerCall([&]() {bench::Escape(gen.U_uneven());}, opts),
+			"std::uniform_real_distribution", Reference_Call(stdUniform, mt, opts));
+
+		Record(json, "engine", "HalfU_uneven", sizeof(real_t),
+			bench::NanosecondsPerCall([&]() {bench::Escape(gen.HalfU_uneven());}, opts),
+			"std::uniform_real_distribution", Reference_Call(stdUniform, mt, opts));
+
+		Record(json, "engine", "U_even", sizeof(real_t),
+			bench::NanosecondsPerCall([&]() {bench::Escape(gen.U_even());}, opts),
+			"std::uniform_real_distribution", Reference_Call(stdUniform, mt, opts));
+
+		// A bool is one bit of entropy, but it occupies a byte
+		Record(json, "engine", "RandBool", sizeof(bool),
+			bench::NanosecondsPerCall([&]() {bench::Escape(gen.RandBool());}, opts),
+			"std::bernoulli_distribution", Reference_Call(stdBool, mt, opts));
+
+		// The quantile flip-flop's pattern (a variate, then a coin), with and without entropy recycling
+		{
+			engine recycler(gen);
+			recycler.RecycleEntropy(true);
+
+			Record(json, "engine", "U+RandBool_recycling", sizeof(real_t),
+				bench::NanosecondsPerCall([&]() {bench::Escape(recycler.HalfU_uneven()); bench::Escape(recycler.RandBool());}, opts),
+				"engine::HalfU_uneven+RandBool", 
+				bench::NanosecondsPerCall([&]() {bench::Escape(gen.HalfU_uneven()); bench::Escape(gen.RandBool());}, opts));
+		}
+
+		// Packed bools (per bool, to compare with RandBool)
+		{
+			std::vector<uint64_t> words(sampleSize / 64);
+
+			Record(json, "engine", "FillBools", sizeof(bool),
+				bench::NanosecondsPerCall([&]()
+					{
+						gen.FillBools(words.data(), sampleSize);
+						bench::Escape(words.data());
+					}, opts) / double(sampleSize),
+				"std::bernoulli_distribution", Reference_Sample(stdBool, mt, opts));
+		}
+
+		// Even uniforms for an array, compared to one U_even per variate
+		{
+			std::vector<real_t> sample(sampleSize);
+
+			Record(json, "engine", "Fill_U_even", sizeof(real_t),
+				bench::NanosecondsPerCall([&]()
+					{
+						gen.Fill_U_even(sample.data(), sampleSize);
+						bench::Escape(sample.data());
+					}, opts) / double(sampleSize),
+				"engine::U_even", bench::NanosecondsPerCall([&]()
+					{
+						for(auto& u : sample)
+							u = gen.U_even();
+						bench::Escape(sample.data());
+					}, opts) / double(sampleSize));
+		}
+
+		// Random signs for an array, compared to one ApplyRandomSign per variate
+		{
+			std::vector<real_t> victims(sampleSize, real_t(1));
+
+			Record(json, "engine", "ApplyRandomSigns", sizeof(real_t),
+				bench::NanosecondsPerCall([&]()
+					{
+						gen.ApplyRandomSigns(victims.data(), sampleSize);
+						bench::Escape(victims.data());
+					}, opts) / double(sampleSize),
+				"engine::ApplyRandomSign", bench::NanosecondsPerCall([&]()
+					{
+						for(auto& victim : victims)
+							gen.ApplyRandomSign(victim);
+						bench::Escape(victims.data());
+					}, opts) / double(sampleSize));
+		}
+
+		#if PRNG_CAN_JUMP
+		// Jump produces no variates; bytes_per_variate = 0 => GB_per_s = 0
+		Record(json, "engine", "Jump", 0,
+			bench::NanosecondsPerCall([&]() {gen.Jump(); bench::Escape(gen);}, opts),
+			"none", std::numeric_limits<double>::quiet_NaN());
+		#endif
+	}
+
+	// Every distribution
+	{
+		no_reference none;
+
+		BenchDistribution(json, opts, "uniform", uniform(-1., 3.),
+			std::uniform_real_distribution<real_t>(-1., 3.), "std::uniform_real_distribution");
+
+		BenchDistribution(json, opts, "uniform_integer<int64_t>", uniform_integer<int64_t>(-10, 1000),
+			std::uniform_int_distribution<int64_t>(-10, 999), "std::uniform_int_distribution");
+
+		// 1000 categories with random weights
+		{
+			engine gen;
+			std::vector<real_t> weights(1000);
+			for(auto& w : weights)
+				w = gen.U_even();
+				
+			BenchDistribution(json, opts, "discrete(1000)", discrete<>(weights),
+				std::discrete_distribution<uint32_t>(weights.begin(), weights.end()), "std::discrete_distribution");
+			
+			BenchDistribution(json, opts, "dynamic_discrete(1000)", dynamic_discrete<>(weights),
+				std::discrete_distribution<uint32_t>(weights.begin(), weights.end()), "std::discrete_distribution");
+		}
+		
+		// bernoulli is not a distribution (its packed output is its batch path)
+		{
+			engine gen;
+			std::mt19937_64 mt(gen());
+			bernoulli const coin(0.3);
+			std::bernoulli_distribution stdCoin(0.3);
+			std::vector<uint64_t> packed(sampleSize / 64);
+			
+			Record(json, "bernoulli(0.3)", "operator()", sizeof(bool),
+				bench::NanosecondsPerCall([&]() {bench::Escape(coin(gen));}, opts),
+				"std::bernoulli_distribution", Reference_Call(stdCoin, mt, opts));
+				
+			// A packed trial is one bit, but report it per trial (as a bool) to compare with the reference
+			Record(json, "bernoulli(0.3)", "FillPacked", sizeof(bool),
+				bench::NanosecondsPerCall([&]()
+					{
+						coin.FillPacked(packed.data(), sampleSize, gen);
+						bench::Escape(packed.data());
+					}, opts) / double(sampleSize),
+				"std::bernoulli_distribution", Reference_Sample(stdCoin, mt, opts));
+		}
+		
+		// Across means (the table is used below poisson::tableMean, PTRS/BTRS above)
+		for(real_t const mu : {0.5, 5., 50., 5e3, 5e6})
+		{
+			BenchDistribution(json, opts, Label("poisson", mu), poisson(mu),
+				std::poisson_distribution<uint64_t>(mu), "std::poisson_distribution");
+		}
+		
+		for(real_t const p : {0.005, 0.05, 0.3})
+		{
+			uint64_t const n = 1000;
+			
+			BenchDistribution(json, opts, Label("binomial(1000)", p), binomial(n, p),
+				std::binomial_distribution<uint64_t>(n, p), "std::binomial_distribution");
+		}
+		
+		BenchDistribution(json, opts, "standard_normal", standard_normal(),
+			std::normal_distribution<real_t>(0., 1.), "std::normal_distribution");
+
+		BenchDistribution(json, opts, "standard_normal_lowPrecision", standard_normal_lowPrecision(),
+			std::normal_distribution<real_t>(0., 1.), "std::normal_distribution");
+
+		BenchDistribution(json, opts, "normal", normal(1., 2.),
+			std::normal_distribution<real_t>(1., 2.), "std::normal_distribution");
+
+		// The same normal, by numerical inversion of its CDF (a table lookup and a polynomial)
+		BenchDistribution(json, opts, "inverted_cdf<normal>", inverted_cdf<normal>(normal(1., 2.)),
+			std::normal_distribution<real_t>(1., 2.), "std::normal_distribution");
+
+		BenchDistribution(json, opts, "log_normal", log_normal(0., 1.),
+			std::lognormal_distribution<real_t>(0., 1.), "std::lognormal_distribution");
+
+		// std::weibull_distribution(shape, scale)
+		BenchDistribution(json, opts, "weibull", weibull(2., 1.5),
+			std::weibull_distribution<real_t>(1.5, 2.), "std::weibull_distribution");
+
+		BenchDistribution(json, opts, "static_dist::weibull", static_dist::weibull(2., 1.5),
+			std::weibull_distribution<real_t>(1.5, 2.), "std::weibull_distribution");
+
+		BenchDistribution(json, opts, "pareto", pareto(1., 2.), none, "none");
+
+		BenchDistribution(json, opts, "exponential", exponential(2.),
+			std::exponential_distribution<real_t>(2.), "std::exponential_distribution");
+
+		// The static (CRTP) form, whose draw is inlined into the benchmark's loop
+		BenchDistribution(json, opts, "static_dist::exponential", static_dist::exponential(2.),
+			std::exponential_distribution<real_t>(2.), "std::exponential_distribution");
+
+		// Truncated deep in the tail (P ~ 1e-9), where rejection would keep one draw in 10^9
+		BenchDistribution(json, opts, "truncated<exponential>[20, 21]", truncated<exponential>(exponential(1.), 20., 21.), 
+			none, "none");
+
+		BenchDistribution(json, opts, "logistic", logistic(0., 1.), none, "none");
+
+		BenchDistribution(json, opts, "log_logistic", log_logistic(1., 3.), none, "none");
+
+		// std::gamma_distribution(shape, scale = 1/rate)
+		BenchDistribution(json, opts, "gammaDist", gammaDist(2., 3.),
+			std::gamma_distribution<real_t>(3., 0.5), "std::gamma_distribution");
+
+		// Marsaglia-Tsang, at the same parameters as Cheng's method (above), and for k < 1
+		BenchDistribution(json, opts, "gammaDist_MarsagliaTsang", gammaDist_MarsagliaTsang(2., 3.),
+			std::gamma_distribution<real_t>(3., 0.5), "std::gamma_distribution");
+
+		BenchDistribution(json, opts, "gammaDist_MarsagliaTsang(k=0.5)", gammaDist_MarsagliaTsang(2., 0.5),
+			std::gamma_distribution<real_t>(0.5, 0.5), "std::gamma_distribution");
+	}
+
+	return 0;
+}
@@ -0,0 +1,364 @@
+// Multi-threaded scaling and single-draw tail latency of pqRand (run with "make bench").
+//
+// Scaling: for 1..N threads, every thread draws from its own engine
+// (the master engine Jump()-ed once per thread, so the streams are orthogonal)
+// and its own copy of the distribution (some distributions cache variates, so they can't be shared).
+// We report the aggregate throughput and the scaling efficiency,
+//		efficiency(k) = throughput(k) / (k * throughput(1)).
+//
+// Tail latency: every single draw is timed with the TSC (rdtsc, fenced),
+// and the cycles are accumulated in a log-linear histogram, from which
+// we report p50/p99/p99.9/max (in cycles and ns). The rejection loops of
+// gammaDist and standard_normal::GetTwo, and the entropy top-up of U_uneven,
+// show up as the tail. The histograms are included in the JSON.
+//
+//		scaling_bench.x [--min-time <seconds>] [--threads <max>] [--out <file.json>]
+
+#include "pqRand.hpp"
+#include "distributions.hpp"
+#include "bench.hpp"
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+#if defined(__x86_64__) or defined(__i386__)
+	#include <x86intrin.h>
+	#define PQR_BENCH_HAS_TSC 1
+#else
+	#define PQR_BENCH_HAS_TSC 0
+#endif
+
+using namespace pqRand;
+
+////////////////////////////////////////////////////////////////////////
+
+// Read the timestamp counter (fenced, so the draw can't be reordered around it).
+// Without a TSC, fall back to steady_clock nanoseconds (and a TSC "frequency" of 1 GHz).
+static inline uint64_t Ticks()
+{
+	#if PQR_BENCH_HAS_TSC
+		_mm_lfence();
+		uint64_t const ticks = __rdtsc();
+		_mm_lfence();
+		return ticks;
+	#else
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	#endif
+}
+
+// Estimate ticks per nanosecond by comparing the TSC to steady_clock
+static double TicksPerNanosecond()
+{
+	auto const begin = std::chrono::steady_clock::now();
+	uint64_t const ticks0 = Ticks();
+
+	while(std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(50));
+
+	uint64_t const ticks1 = Ticks();
+	double const ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+
+	return double(ticks1 - ticks0) / ns;
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// A log-linear histogram of tick counts (like HdrHistogram):
+// values < 2^subBits are counted exactly; above, each power of two
+// is split into 2^subBits buckets (a relative resolution of 2^-subBits).
+class latency_histogram
+{
+	private:
+		static constexpr size_t subBits = 4;
+		static constexpr size_t subCount = (size_t(1) << subBits);
+		static constexpr size_t numBuckets = (64 - subBits + 1) * subCount;
+
+		std::vector<uint64_t> counts;
+		uint64_t total;
+		uint64_t max_;
+
+		static size_t Bucket(uint64_t const ticks)
+		{
+			if(ticks < subCount) return size_t(ticks);
+
+			size_t const log2 = size_t(63 - __builtin_clzll(ticks));
+			size_t const shift = log2 - subBits;
+
+			return (shift + 1) * subCount + size_t((ticks >> shift) - subCount);
+		}
+
+		// The smallest value in the bucket
+		static uint64_t LowerEdge(size_t const bucket)
+		{
+			if(bucket < subCount) return uint64_t(bucket);
+
+			size_t const shift = bucket / subCount - 1;
+
+			return uint64_t(subCount + bucket % subCount) << shift;
+		}
+
+	public:
+		latency_histogram(): counts(numBuckets, 0), total(0), max_(0) {}
+
+		void Add(uint64_t const ticks)
+		{
+			++counts[Bucket(ticks)];
+			++total;
+			max_ = std::max(max_, ticks);
+		}
+
+		void Merge(latency_histogram const& other)
+		{
+			for(size_t i = 0; i < numBuckets; ++i)
+				counts[i] += other.counts[i];
+			total += other.total;
+			max_ = std::max(max_, other.max_);
+		}
+
+		uint64_t Total() const {return total;}
+		uint64_t Max() const {return max_;}
+
+		// The lower edge of the bucket holding the q-th quantile
+		uint64_t Percentile(double const q) const
+		{
+			uint64_t const rank = uint64_t(q * double(total));
+			uint64_t seen = 0;
+
+			for(size_t i = 0; i < numBuckets; ++i)
+			{
+				seen += counts[i];
+				if(seen > rank) return LowerEdge(i);
+			}
+			return max_;
+		}
+
+		// The non-empty buckets, as [lowerEdge, count, lowerEdge, count, ...]
+		std::vector<double> Flatten() const
+		{
+			std::vector<double> flat;
+
+			for(size_t i = 0; i < numBuckets; ++i)
+			{
+				if(counts[i])
+				{
+					flat.push_back(double(LowerEdge(i)));
+					flat.push_back(double(counts[i]));
+				}
+			}
+			return flat;
+		}
+};
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// Each thread makes its own distribution, drawing from its own engine
+typedef std::function<std::unique_ptr<distribution<real_t>>()> factory_t;
+
+template<class dist_t, typename... args_t>
+static factory_t Factory(args_t... args)
+{
+	return [=]() {return std::unique_ptr<distribution<real_t>>(new dist_t(args...));};
+}
+
+// The engine's U_uneven, as a distribution (so it can be benchmarked the same way)
+class engine_U_uneven : public distribution<real_t>
+{
+	public:
+		real_t min() const {return 0;}
+		real_t max() const {return 1;}
+		real_t operator()(engine& gen) const {return gen.U_uneven();}
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// Run numThreads threads for minSeconds, each drawing from its own jumped engine.
+// Returns the aggregate draws per second of wall time, from the common start to the last join 
+// (the threads share one start and one stop, so a thread which starts late cannot overstate it); 
+// when timeEach, every draw is timed into hist.
+static double RunThreads(factory_t const& factory, engine const& master, size_t const numThreads,
+	double const minSeconds, bool const timeEach, latency_histogram& hist)
+{
+	std::vector<engine> gens(numThreads, master);
+	for(size_t t = 0; t < numThreads; ++t)
+	{
+		for(size_t j = 0; j < t; ++j)
+			gens[t].Jump();
+		gens[t].DiscardBitCache();
+	}
+
+	std::vector<latency_histogram> hists(numThreads);
+	std::vector<uint64_t> draws(numThreads, 0);
+	std::atomic<size_t> ready(0);
+	std::atomic<bool> go(false);
+	std::atomic<bool> stop(false);
+
+	auto const Worker = [&](size_t const t)
+	{
+		auto const dist = factory();
+		engine& gen = gens[t];
+		size_t constexpr batch = 1024; // Check the stop flag once per batch
+
+		// Start together, so the threads actually compete
+		ready.fetch_add(1);
+		while(not go.load())
+			std::this_thread::yield();
+
+		do
+		{
+			if(timeEach)
+			{
+				for(size_t i = 0; i < batch; ++i)
+				{
+					uint64_t const start = Ticks();
+					bench::Escape((*dist)(gen));
+					hists[t].Add(Ticks() - start);
+				}
+			}
+			else
+			{
+				for(size_t i = 0; i < batch; ++i)
+					bench::Escape((*dist)(gen));
+			}
+			draws[t] += batch;
+		}
+		while(not stop.load(std::memory_order_relaxed));
+	};
+
+	std::vector<std::thread> threads;
+	for(size_t t = 0; t < numThreads; ++t)
+		threads.emplace_back(Worker, t);
+	
+	// Once every thread has its distribution, start the clock and release them all at once
+	while(ready.load() < numThreads)
+		std::this_thread::yield();
+	
+	auto const begin = std::chrono::steady_clock::now();
+	go.store(true);
+	
+	std::this_thread::sleep_for(std::chrono::duration<double>(minSeconds));
+	stop.store(true);
+	
+	for(auto& thread : threads)
+		thread.join();
+	
+	double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	uint64_t totalDraws = 0;
+
+	for(size_t t = 0; t < numThreads; ++t)
+	{
+		totalDraws += draws[t];
+		hist.Merge(hists[t]);
+	}
+
+	return double(totalDraws) / seconds;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char const* const* argv)
+{
+	bench::options opts;
+
+	if(not opts.Parse(argc, argv))
+	{
+		std::fprintf(stderr, "usage: %s [--min-time <seconds>] [--threads <max>] [--out <file.json>]\n", argv[0]);
+		return 1;
+	}
+
+	size_t const maxThreads = (opts.maxThreads > 0) ? opts.maxThreads :
+		std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+
+	// The overhead of timing an empty draw, subtracted from every latency
+	uint64_t overhead;
+	{
+		latency_histogram empty;
+		for(size_t i = 0; i < (size_t(1) << 16); ++i)
+		{
+			uint64_t const start = Ticks();
+			empty.Add(Ticks() - start);
+		}
+		overhead = empty.Percentile(0.5);
+	}
+
+	double const ticksPerNs = TicksPerNanosecond();
+
+	std::vector<std::pair<std::string, factory_t>> const cases =
+	{
+		{"engine::U_uneven", Factory<engine_U_uneven>()},
+		{"uniform", Factory<uniform>(-1., 3.)},
+		{"standard_normal", Factory<standard_normal>()},
+		{"normal", Factory<normal>(1., 2.)},
+		{"log_normal", Factory<log_normal>(0., 1.)},
+		{"weibull", Factory<weibull>(2., 1.5)},
+		{"pareto", Factory<pareto>(1., 2.)},
+		{"exponential", Factory<exponential>(2.)},
+		{"logistic", Factory<logistic>(0., 1.)},
+		{"log_logistic", Factory<log_logistic>(1., 3.)},
+		{"gammaDist", Factory<gammaDist>(2., 3.)},
+		{"gammaDist_MarsagliaTsang", Factory<gammaDist_MarsagliaTsang>(2., 3.)},
+	};
+
+	bench::json_writer json(opts.outFile, "scaling_bench");
+	engine const master;
+
+	for(auto const& c : cases)
+	{
+		// Tail latency (one thread, every draw timed)
+		{
+			latency_histogram hist;
+			RunThreads(c.second, master, 1, opts.minSeconds, true, hist);
+
+			auto const Net = [&](uint64_t const ticks)
+				{return double((ticks > overhead) ? (ticks - overhead) : 0);};
+
+			json.BeginRecord();
+			json.Field("name", c.first);
+			json.Field("test", "latency");
+			json.Field("draws", double(hist.Total()));
+			json.Field("tsc_ticks_per_ns", ticksPerNs);
+			json.Field("timing_overhead_ticks", double(overhead));
+			json.Field("p50_ticks", Net(hist.Percentile(0.5)));
+			json.Field("p99_ticks", Net(hist.Percentile(0.99)));
+			json.Field("p999_ticks", Net(hist.Percentile(0.999)));
+			json.Field("max_ticks", Net(hist.Max()));
+			json.Field("p50_ns", Net(hist.Percentile(0.5)) / ticksPerNs);
+			json.Field("p99_ns", Net(hist.Percentile(0.99)) / ticksPerNs);
+			json.Field("p999_ns", Net(hist.Percentile(0.999)) / ticksPerNs);
+			json.Field("max_ns", Net(hist.Max()) / ticksPerNs);
+			json.Field("histogram_ticks_count", hist.Flatten()); // Raw (overhead included)
+			json.EndRecord();
+
+			std::fprintf(stderr, "%-20s latency  p50 %7.1f ns  p99 %7.1f ns  p99.9 %7.1f ns  max %9.1f ns\n",
+				c.first.c_str(), Net(hist.Percentile(0.5)) / ticksPerNs, Net(hist.Percentile(0.99)) / ticksPerNs,
+				Net(hist.Percentile(0.999)) / ticksPerNs, Net(hist.Max()) / ticksPerNs);
+		}
+
+		// Scaling (untimed draws, 1..maxThreads)
+		double single = 0.;
+
+		for(size_t k = 1; k <= maxThreads; ++k)
+		{
+			latency_histogram unused;
+			double const rate = RunThreads(c.second, master, k, opts.minSeconds, false, unused);
+			if(k == 1) single = rate;
+
+			json.BeginRecord();
+			json.Field("name", c.first);
+			json.Field("test", "scaling");
+			json.Field("threads", double(k));
+			json.Field("draws_per_s", rate);
+			json.Field("ns_per_variate_per_thread", 1e9 * double(k) / rate);
+			json.Field("efficiency", rate / (double(k) * single));
+			json.EndRecord();
+
+			std::fprintf(stderr, "%-20s %2lu threads  %8.2f Mdraws/s  efficiency %.3f\n",
+				c.first.c_str(), k, 1e-6 * rate, rate / (double(k) * single));
+		}
+	}
+
+	return 0;
+}
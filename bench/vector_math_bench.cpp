@@ -0,0 +1,383 @@
+// Accuracy and speed of libpqr's internal vector math (source/vector_math.hpp), run with "make bench".
+//
+// Accuracy: every function is evaluated on ~10^6 arguments per domain (uniform, log-uniform,
+// and near the points where precision is hardest, e.g. log1p and expm1 near zero),
+// in every tier up to pqRand::ActiveISA() (set PQR_ISA to restrict them).
+// We report the largest error in ulp (ours and libm's double functions') against the long double libm (64-bit mantissa,
+// so the reference is ~2^-11 ulp of double), check that every tier is bit-identical,
+// and check the special values (0, inf, NaN, ...) against libm's double functions.
+//
+// Speed: ns/value of the array loop in each tier, next to the same loop calling libm,
+// on the first (typical) domain of each function. Arguments with subnormal intermediates
+// are much slower (in both), so they are not timed.
+//
+//		vector_math_bench.x [--min-time <seconds>] [--reps <n>] [--out <file.json>]
+
+#include "pqRand.hpp"
+#include "bench.hpp"
+#include "../source/vector_math.hpp"
+#include <random>
+#include <functional>
+#include <cinttypes>
+
+using namespace pqRand;
+
+////////////////////////////////////////////////////////////////////////
+
+// One function: its vector form, libm's double form, and libm's long double form (the reference)
+struct exp_op
+{
+	static char const* Name() {return "exp";}
+	PQR_ALWAYS_INLINE static double Vector(double const x, double) {return vmath::Exp(x);}
+	static double Libm(double const x, double) {return std::exp(x);}
+	static long double Reference(double const x, double) {return expl(x);}
+};
+
+struct expm1_op
+{
+	static char const* Name() {return "expm1";}
+	PQR_ALWAYS_INLINE static double Vector(double const x, double) {return vmath::Expm1(x);}
+	static double Libm(double const x, double) {return std::expm1(x);}
+	static long double Reference(double const x, double) {return expm1l(x);}
+};
+
+struct log_op
+{
+	static char const* Name() {return "log";}
+	PQR_ALWAYS_INLINE static double Vector(double const x, double) {return vmath::Log(x);}
+	static double Libm(double const x, double) {return std::log(x);}
+	static long double Reference(double const x, double) {return logl(x);}
+};
+
+struct log1p_op
+{
+	static char const* Name() {return "log1p";}
+	PQR_ALWAYS_INLINE static double Vector(double const x, double) {return vmath::Log1p(x);}
+	static double Libm(double const x, double) {return std::log1p(x);}
+	static long double Reference(double const x, double) {return log1pl(x);}
+};
+
+struct pow_op
+{
+	static char const* Name() {return "pow";}
+	PQR_ALWAYS_INLINE static double Vector(double const x, double const y) {return vmath::Pow(x, y);}
+	static double Libm(double const x, double const y) {return std::pow(x, y);}
+	static long double Reference(double const x, double const y) {return powl(x, y);}
+};
+
+struct erfc_op
+{
+	static char const* Name() {return "erfc";}
+	PQR_ALWAYS_INLINE static double Vector(double const x, double) {return vmath::Erfc(x);}
+	static double Libm(double const x, double) {return std::erfc(x);}
+	static long double Reference(double const x, double) {return erfcl(x);}
+};
+
+////////////////////////////////////////////////////////////////////////
+
+// The array loop, compiled once per tier (as libpqr's kernels are)
+template<class op_t>
+PQR_ALWAYS_INLINE void Loop(double const* const x, double const* const y, double* const out, size_t const n)
+{
+	for(size_t i = 0; i < n; ++i)
+		out[i] = op_t::Vector(x[i], y[i]);
+}
+
+template<class op_t>
+void Loop_baseline(double const* const x, double const* const y, double* const out, size_t const n)
+	{Loop<op_t>(x, y, out, n);}
+
+template<class op_t>
+PQR_TARGET_AVX2 void Loop_avx2(double const* const x, double const* const y, double* const out, size_t const n)
+	{Loop<op_t>(x, y, out, n);}
+
+template<class op_t>
+PQR_TARGET_AVX512 void Loop_avx512(double const* const x, double const* const y, double* const out, size_t const n)
+	{Loop<op_t>(x, y, out, n);}
+
+template<class op_t>
+static void RunTier(isa const tier, double const* const x, double const* const y, double* const out, size_t const n)
+{
+	switch(tier)
+	{
+		case isa::avx512: Loop_avx512<op_t>(x, y, out, n); break;
+		case isa::avx2: Loop_avx2<op_t>(x, y, out, n); break;
+		default: Loop_baseline<op_t>(x, y, out, n); break;
+	}
+}
+
+// The tiers which this CPU supports (up to ActiveISA)
+static std::vector<isa> Tiers()
+{
+	std::vector<isa> tiers = {isa::baseline};
+	if(ActiveISA() >= isa::avx2) tiers.push_back(isa::avx2);
+	if(ActiveISA() >= isa::avx512) tiers.push_back(isa::avx512);
+	return tiers;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Is the bit pattern identical (any NaN matches any NaN)?
+static bool Identical(double const a, double const b)
+{
+	if(std::isnan(a) and std::isnan(b)) return true;
+	return vmath::Bits(a) == vmath::Bits(b);
+}
+
+// The error of result in units of the last place of the correctly rounded reference
+static double UlpError(double const result, long double const reference)
+{
+	if(std::isnan(result) and std::isnan(reference)) return 0.;
+	if(std::isnan(result) or std::isnan(reference)) return INFINITY;
+
+	double const rounded = double(reference);
+	if(std::isinf(rounded) or std::isinf(result))
+		return Identical(result, rounded) ? 0. : INFINITY;
+
+	int const exponent = (std::fpclassify(rounded) == FP_ZERO) ? -1022 : std::max(std::ilogb(rounded), -1022);
+	long double const ulp = std::ldexp(1.L, exponent - 52);
+
+	return double(std::fabs((long double)(result) - reference) / ulp);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// A domain of arguments (y is only used by pow)
+struct domain
+{
+	std::string name;
+	std::function<double(std::mt19937_64&)> x;
+	std::function<double(std::mt19937_64&, double)> y;
+	
+	~domain(); // Out-of-line (it destroys three members; inlining it only bloats the caller)
+};
+
+domain::~domain() {}
+
+static double Uniform(std::mt19937_64& gen, double const a, double const b)
+{
+	return std::uniform_real_distribution<double>(a, b)(gen);
+}
+
+// sign * 10^U(a, b)
+static double LogUniform(std::mt19937_64& gen, double const a, double const b, double const sign = 1.)
+{
+	return sign * std::pow(10., Uniform(gen, a, b));
+}
+
+static double RandomSign(std::mt19937_64& gen) {return (gen() bitand 1) ? 1. : -1.;}
+
+static double NoY(std::mt19937_64&, double) {return 0.;}
+
+////////////////////////////////////////////////////////////////////////
+
+template<class op_t>
+static void Accuracy(bench::json_writer& json, std::vector<domain> const& domains,
+	std::vector<double> const& specials, bench::options const& opts)
+{
+	size_t constexpr numArgs = size_t(1) << 20;
+	std::vector<isa> const tiers = Tiers();
+
+	for(auto const& dom : domains)
+	{
+		std::mt19937_64 gen(12345);
+		std::vector<double> x(numArgs), y(numArgs), out(numArgs), first(numArgs);
+
+		for(size_t i = 0; i < numArgs; ++i)
+		{
+			x[i] = dom.x(gen);
+			y[i] = dom.y(gen, x[i]);
+		}
+
+		bool identical = true;
+		double maxUlp = 0., worstX = 0., worstY = 0., libmMaxUlp = 0.;
+
+		for(size_t t = 0; t < tiers.size(); ++t)
+		{
+			RunTier<op_t>(tiers[t], x.data(), y.data(), (t == 0) ? first.data() : out.data(), numArgs);
+
+			if(t > 0)
+			{
+				for(size_t i = 0; i < numArgs; ++i)
+					identical = identical and Identical(first[i], out[i]);
+			}
+		}
+
+		for(size_t i = 0; i < numArgs; ++i)
+		{
+			long double const reference = op_t::Reference(x[i], y[i]);
+			libmMaxUlp = std::max(libmMaxUlp, UlpError(op_t::Libm(x[i], y[i]), reference));
+
+			double const error = UlpError(first[i], reference);
+			if(not (error <= maxUlp))
+			{
+				maxUlp = error;
+				worstX = x[i];
+				worstY = y[i];
+			}
+		}
+
+		json.BeginRecord();
+		json.Field("name", op_t::Name());
+		json.Field("test", "accuracy");
+		json.Field("domain", dom.name);
+		json.Field("count", double(numArgs));
+		json.Field("max_ulp", maxUlp);
+		json.Field("worst_x", worstX);
+		json.Field("worst_y", worstY);
+		json.Field("libm_max_ulp", libmMaxUlp);
+		json.Field("tiers_identical", identical ? "true" : "false");
+		json.EndRecord();
+
+		std::fprintf(stderr, "%-6s %-22s max %.3f ulp (x = %.17g, y = %.17g), libm %.3f ulp, tiers identical: %s\n",
+			op_t::Name(), dom.name.c_str(), maxUlp, worstX, worstY, libmMaxUlp, identical ? "yes" : "NO");
+	}
+
+	// Special values must match libm exactly
+	{
+		std::vector<double> x, y;
+		for(double const a : specials)
+		{
+			for(double const b : specials)
+			{
+				x.push_back(a);
+				y.push_back(b);
+			}
+		}
+
+		std::vector<double> out(x.size());
+		size_t mismatches = 0;
+
+		for(isa const tier : tiers)
+		{
+			RunTier<op_t>(tier, x.data(), y.data(), out.data(), x.size());
+
+			for(size_t i = 0; i < x.size(); ++i)
+			{
+				double const libm = op_t::Libm(x[i], y[i]);
+				// Pow is only defined for x >= +0 (libm's pow of negative x, or -0, has other rules)
+				bool const skip = (std::string(op_t::Name()) == "pow") and std::signbit(x[i]);
+
+				if(not skip and not Identical(out[i], libm) and (UlpError(out[i], op_t::Reference(x[i], y[i])) > 1.))
+				{
+					if(mismatches++ < 8)
+						std::fprintf(stderr, "%-6s special mismatch (%s): f(%g, %g) = %.17g, libm %.17g\n",
+							op_t::Name(), ISA_Name(tier), x[i], y[i], out[i], libm);
+				}
+			}
+		}
+
+		json.BeginRecord();
+		json.Field("name", op_t::Name());
+		json.Field("test", "special_values");
+		json.Field("count", double(x.size() * tiers.size()));
+		json.Field("mismatches", double(mismatches));
+		json.EndRecord();
+
+		std::fprintf(stderr, "%-6s special values: %zu mismatches\n", op_t::Name(), mismatches);
+	}
+
+	// Speed (on the first domain's arguments)
+	{
+		size_t constexpr n = 4096;
+		std::mt19937_64 gen(54321);
+		std::vector<double> x(n), y(n), out(n);
+
+		for(size_t i = 0; i < n; ++i)
+		{
+			x[i] = domains.front().x(gen);
+			y[i] = domains.front().y(gen, x[i]);
+		}
+
+		double const libm_ns = bench::NanosecondsPerCall([&]()
+			{
+				for(size_t i = 0; i < n; ++i)
+					out[i] = op_t::Libm(x[i], y[i]);
+				bench::Escape(out.data());
+			}, opts) / double(n);
+
+		for(isa const tier : tiers)
+		{
+			double const ns = bench::NanosecondsPerCall([&]()
+				{
+					RunTier<op_t>(tier, x.data(), y.data(), out.data(), n);
+					bench::Escape(out.data());
+				}, opts) / double(n);
+
+			json.BeginRecord();
+			json.Field("name", op_t::Name());
+			json.Field("test", "speed");
+			json.Field("isa", ISA_Name(tier));
+			json.Field("ns_per_value", ns);
+			json.Field("libm_ns_per_value", libm_ns);
+			json.Field("speedup", libm_ns / ns);
+			json.EndRecord();
+
+			std::fprintf(stderr, "%-6s %-8s %6.2f ns/value (libm %6.2f ns/value)\n",
+				op_t::Name(), ISA_Name(tier), ns, libm_ns);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char const* const* argv)
+{
+	bench::options opts;
+
+	if(not opts.Parse(argc, argv))
+	{
+		std::fprintf(stderr, "usage: %s [--min-time <seconds>] [--reps <n>] [--out <file.json>]\n", argv[0]);
+		return 1;
+	}
+
+	bench::json_writer json(opts.outFile, "vector_math_bench");
+
+	double const inf = INFINITY;
+	std::vector<double> const specials = {0., -0., 1., -1., 2., 0.5, inf, -inf, NAN,
+		std::numeric_limits<double>::min(), std::numeric_limits<double>::denorm_min(),
+		std::numeric_limits<double>::max(), 709.782712893384, -745.1332191019412,
+		0.84375, -0.84375, 1.25, -1.25, 28., -28., 1e-300, -1e-300, 3.5, -40., 710.};
+
+	Accuracy<exp_op>(json, {
+		{"uniform[-745.1,709.8]", [](std::mt19937_64& g) {return Uniform(g, -745.1, 709.78);}, NoY},
+		{"+/-10^[-20,0]", [](std::mt19937_64& g) {return LogUniform(g, -20., 0., RandomSign(g));}, NoY},
+		{"subnormal results", [](std::mt19937_64& g) {return Uniform(g, -745.13, -708.4);}, NoY},
+		}, specials, opts);
+
+	Accuracy<expm1_op>(json, {
+		{"uniform[-2,2]", [](std::mt19937_64& g) {return Uniform(g, -2., 2.);}, NoY},
+		{"uniform[-40,709.7]", [](std::mt19937_64& g) {return Uniform(g, -40., 709.7);}, NoY},
+		{"+/-10^[-300,0]", [](std::mt19937_64& g) {return LogUniform(g, -300., 0., RandomSign(g));}, NoY},
+		}, specials, opts);
+
+	Accuracy<log_op>(json, {
+		{"10^[-320,308]", [](std::mt19937_64& g) {return LogUniform(g, -320., 308.);}, NoY},
+		{"1 +/- 10^[-16,-0.5]", [](std::mt19937_64& g) {return 1. + LogUniform(g, -16., -0.5, RandomSign(g));}, NoY},
+		{"uniform(0,4]", [](std::mt19937_64& g) {return Uniform(g, 1e-300, 4.);}, NoY},
+		}, specials, opts);
+
+	Accuracy<log1p_op>(json, {
+		{"uniform(-1,1)", [](std::mt19937_64& g) {return Uniform(g, -1. + 1e-16, 1.);}, NoY},
+		{"+/-10^[-300,0)", [](std::mt19937_64& g) {return LogUniform(g, -300., -1e-9, RandomSign(g));}, NoY},
+		{"-1 + 10^[-16,0)", [](std::mt19937_64& g) {return -1. + LogUniform(g, -16., -1e-9);}, NoY},
+		{"10^[0,308]", [](std::mt19937_64& g) {return LogUniform(g, 0., 308.);}, NoY},
+		}, specials, opts);
+
+	Accuracy<pow_op>(json, {
+		{"x=10^[-300,300], |xy|<745", [](std::mt19937_64& g) {return LogUniform(g, -300., 300.);},
+			[](std::mt19937_64& g, double const x) {return Uniform(g, -745., 709.) / std::log(x);}},
+		{"x=1+/-10^[-15,-1], y=+/-10^[0,15]", [](std::mt19937_64& g) {return 1. + LogUniform(g, -15., -1., RandomSign(g));},
+			[](std::mt19937_64& g, double) {return LogUniform(g, 0., 15., RandomSign(g));}},
+		{"x=U(0,10), y=U(-10,10)", [](std::mt19937_64& g) {return Uniform(g, 1e-300, 10.);},
+			[](std::mt19937_64& g, double) {return Uniform(g, -10., 10.);}},
+		}, specials, opts);
+
+	Accuracy<erfc_op>(json, {
+		{"uniform[-6,27.3]", [](std::mt19937_64& g) {return Uniform(g, -6., 27.3);}, NoY},
+		{"+/-10^[-20,0]", [](std::mt19937_64& g) {return LogUniform(g, -20., 0., RandomSign(g));}, NoY},
+		{"uniform[0.5,3]", [](std::mt19937_64& g) {return Uniform(g, 0.5, 3.);}, NoY},
+		}, specials, opts);
+
+	return 0;
+}
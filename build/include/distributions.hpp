@@ -0,0 +1,2223 @@
+/* pqRand: The precise quantile random package
+ * Copyright (C) 2017 Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ * 
+ * This package is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  
+ * See the COPYRIGHT_NOTICE for more details.
+ * 
+ * Under Section 7 of GPL version 3, you are granted additional
+ * permissions described in the GCC Runtime Library Exception, version
+ * 3.1, as published by the Free Software Foundation.
+ * 
+ * You should have received a copy of the GNU General Public License and
+ * a copy of the GCC Runtime Library Exception along with this package;
+ * see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+ * <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+*  @file distributions.hpp
+*  @brief Defines the sampling objects which draw from various distributions.
+* 
+*  The sampling objects use a polymorphic interface which
+*  adds functions as more analytic information is known about their distribution.
+*  Most distributions utilize a quantile flip-flop (pqRand::distributionQ2,
+*  as described in the \ref theory "research paper")
+*  but some do not need one (e.g. pqRand::pareto).
+*  Others use rejection sampling (e.g. pqRand::standard_normal, pqRand::gammaDist).
+* 
+*  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+*  @date 2017
+*/
+
+#ifndef DISTRIBUTIONS
+#define DISTRIBUTIONS
+
+#include "pqRand.hpp"
+#include "static_distributions.hpp" // two, and the static form of the closed-form distributions
+#include <cmath> // exp
+#include <assert.h>
+#include <string>
+#include <memory> // shared_ptr
+#include <type_traits> // is_base_of
+
+/*! @brief Count the proposals and acceptances of rejection samplers (see \ref pqRand::rejection_counter).
+ * 
+ *  The counters change the layout of the distributions, so this macro must have 
+ *  the same value when building libpqr and the programs which use it
+ *  (e.g. compile both with \c -DPQR_REJECTION_STATS=1).
+ *  When zero (the default), the counters do not exist, so they cost nothing.
+*/
+#ifndef PQR_REJECTION_STATS
+	#define PQR_REJECTION_STATS 0
+#endif
+
+#if PQR_REJECTION_STATS
+	#include <atomic>
+#endif
+
+namespace pqRand
+{
+	/*! @brief An abtract (pure virtual) class for sampling random variates.
+	 * 
+	 *  This class defines a standard interface: the operator() is used to sample one variate, 
+	 *  of which the min/max variate must be defined. 
+	 *  This permits a DRY (don't repeat yourself) Fill() and GetSample().
+	*/
+	template<typename T>
+	class distribution
+	{
+		public:
+			distribution() {}
+			virtual ~distribution() {}
+			
+			virtual T min() const = 0; //!< @brief The minimum variate sampled.
+			virtual T max() const = 0; //!< @brief The maximum variate sampled.
+			
+			/*! @brief Sample one variate.
+			 *  
+			 *  \param gen 	the PRNG engine
+			*/ 
+			virtual T operator()(engine& gen) const = 0;
+			
+			/*! @brief Sample a number of variates into an existing array (the batch path).
+			 *  
+			 *  This is the worker function called by GetSample(); 
+			 *  distributions which can sample more efficiently in bulk should redefine it.
+			 *  
+			 *  \param sample 	the array to fill (with room for at least \p sampleSize variates)
+			 *  \param sampleSize 	the sample size
+			 *  \param gen 	the PRNG engine
+			*/ 
+			virtual void Fill(T* const sample, size_t const sampleSize, engine& gen) const;
+			
+			/*! @brief Sample a number of variates and return them in a vector.
+			 *  
+			 *  \param sampleSize 	the sample size
+			 *  \param gen 	the PRNG engine
+			*/ 
+			virtual std::vector<T> GetSample(size_t const sampleSize, engine& gen) const;
+			
+			#if PRNG_CAN_JUMP
+			/*! @brief The number of variates in each block of Fill_Parallel().
+			 * 
+			 *  \warning This is part of the definition of the parallel sample; 
+			 *  changing it changes every parallel sample.
+			*/
+			size_t static constexpr parallelBlockSize = (size_t(1) << 16);
+			
+			/*! @brief Sample a number of variates into an existing array using several threads.
+			 *  
+			 *  The sample is divided into blocks of \ref parallelBlockSize variates.
+			 *  Block \em b is sampled by its own engine, whose state is 
+			 *  \p gen's original state Jump()-ed \em b times (with a discarded bit cache).
+			 *  Since blocks are independent of the thread that samples them, 
+			 *  the sample is identical for any \p numThreads.
+			 *  Afterwards, \p gen has been Jump()-ed once per block 
+			 *  (i.e. ceil(\p sampleSize / \ref parallelBlockSize) times).
+			 *  
+			 *  \note This is not the same sample as Fill(), which uses \p gen directly.
+			 *  
+			 *  \warning Fill() is called concurrently, so it must not alter the distribution.
+			 *  
+			 *  \param sample 	the array to fill (with room for at least \p sampleSize variates)
+			 *  \param sampleSize 	the sample size
+			 *  \param gen 	the PRNG engine
+			 *  \param numThreads 	the number of threads (zero uses every hardware thread)
+			*/ 
+			void Fill_Parallel(T* const sample, size_t const sampleSize, engine& gen, 
+				size_t const numThreads) const;
+				
+			/*! @brief Sample a number of variates using several threads and return them in a vector.
+			 *  
+			 *  See Fill_Parallel().
+			 *  
+			 *  \param sampleSize 	the sample size
+			 *  \param gen 	the PRNG engine
+			 *  \param numThreads 	the number of threads (zero uses every hardware thread)
+			*/ 
+			std::vector<T> GetSample_Parallel(size_t const sampleSize, engine& gen, 
+				size_t const numThreads) const;
+			#endif
+	};	
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief A snapshot of the statistics of a rejection sampler.
+	 * 
+	 *  Each accepted variate takes one or more proposals; 
+	 *  the proposals before the accepted one are its retries.
+	*/ 
+	struct rejection_stats
+	{
+		uint64_t proposals; //!< The number of proposals.
+		uint64_t acceptances; //!< The number of accepted proposals (i.e. variates returned).
+		uint64_t maxRetries; //!< The longest run of rejections before an acceptance.
+		
+		//! @brief The fraction of proposals accepted (NaN if there are none).
+		real_t AcceptanceRate() const {return real_t(acceptances) / real_t(proposals);}
+	};
+	
+	/*! @brief A one-line summary of \p stats, for logging/monitoring.
+	 * 
+	 *  The line is flagged with "WARNING" when the acceptance rate is below \p minAcceptance
+	 *  (or when a single variate needed more than \p maxRetries retries), which indicates
+	 *  a pathological parameter regime (e.g. a gammaDist with k just above 1).
+	 * 
+	 *  \param name 	identifies the distribution (e.g. its type and parameters)
+	 *  \param stats 	the statistics to report
+	*/ 
+	std::string RejectionReport(std::string const& name, rejection_stats const& stats, 
+		real_t const minAcceptance = real_t(0.5), uint64_t const maxRetries = 64);
+	
+	#if PQR_REJECTION_STATS
+	/*! @brief Thread-safe counters of a rejection sampler (see \ref PQR_REJECTION_STATS).
+	 * 
+	 *  Distributions are sampled through const functions (possibly from many threads),
+	 *  so the counters are mutable atomics, updated once per accepted variate.
+	 *  Copying a distribution copies its current counts.
+	*/
+	class rejection_counter
+	{
+		private:
+			mutable std::atomic<uint64_t> proposals;
+			mutable std::atomic<uint64_t> acceptances;
+			mutable std::atomic<uint64_t> maxRetries;
+			
+		public:
+			rejection_counter(): proposals(0), acceptances(0), maxRetries(0) {}
+			
+			rejection_counter(rejection_counter const& other):
+				proposals(other.proposals.load(std::memory_order_relaxed)), 
+				acceptances(other.acceptances.load(std::memory_order_relaxed)),
+				maxRetries(other.maxRetries.load(std::memory_order_relaxed)) {}
+				
+			rejection_counter& operator = (rejection_counter const& other)
+			{
+				proposals.store(other.proposals.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				acceptances.store(other.acceptances.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				maxRetries.store(other.maxRetries.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				return *this;
+			}
+			
+			//! @brief Record one accepted variate, which took \p numProposals proposals.
+			void Record(uint64_t const numProposals) const
+			{
+				proposals.fetch_add(numProposals, std::memory_order_relaxed);
+				acceptances.fetch_add(1, std::memory_order_relaxed);
+				
+				uint64_t const retries = numProposals - 1;
+				uint64_t longest = maxRetries.load(std::memory_order_relaxed);
+				
+				while((retries > longest) and 
+					not maxRetries.compare_exchange_weak(longest, retries, std::memory_order_relaxed));
+			}
+			
+			//! @brief A snapshot of the counters.
+			rejection_stats Snapshot() const
+			{
+				rejection_stats stats;
+				
+				stats.proposals = proposals.load(std::memory_order_relaxed);
+				stats.acceptances = acceptances.load(std::memory_order_relaxed);
+				stats.maxRetries = maxRetries.load(std::memory_order_relaxed);
+				
+				return stats;
+			}
+			
+			//! @brief Zero the counters.
+			void Reset() const
+			{
+				proposals.store(0, std::memory_order_relaxed);
+				acceptances.store(0, std::memory_order_relaxed);
+				maxRetries.store(0, std::memory_order_relaxed);
+			}
+	};
+	#endif
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief An abstract class which extends the \ref distribution interface for 
+	 *  those distributions with an analytic PDF.
+	 * 
+	 *  This allows access to the \ref PDF, the \ref Mean, and \ref Variance.
+	*/
+	class distributionPDF : public distribution<real_t>
+	{
+		protected:
+			//! @brief The PDF, where x is guaranteed to be supported by \ref PDF.
+			virtual real_t PDF_supported(real_t const x) const = 0;
+			
+			/*! @brief The PDF of an array, where x may be unsupported (the result is masked afterwards).
+			 * 
+			 *  The default calls the (checked) PDF() for each x, 
+			 *  so PDF_supported() still only sees supported x. 
+			 *  A class whose PDF_supported() is safe for any x should redefine this 
+			 *  with a non-virtual, branch-free loop over every x (which the compiler can inline and vectorize).
+			*/
+			virtual void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			
+			//! @brief The number of values processed at once by the array functions.
+			size_t static constexpr arrayChunk = 256;
+					
+		public:
+			distributionPDF() {}
+			virtual ~distributionPDF() {}
+			
+			//! @brief The probability distribution function (zero outside of [min, max]).
+			real_t PDF(real_t const x) const;
+			
+			/*! @brief The PDF of an array of \p n values.
+			 * 
+			 *  The kernel (PDF_array()) is applied to all values (one virtual call per chunk of values), 
+			 *  then values outside of [min, max] are masked to zero, 
+			 *  so there is no branch inside a redefined kernel's loop.
+			 *  The closed-form distributions' kernels use pqRand's vectorized math (not libm),
+			 *  so they may differ from the scalar function in the last few bits.
+			 *  \p pdf may alias \p x (to evaluate in place).
+			*/
+			void PDF(real_t const* const x, real_t* const pdf, size_t const n) const;
+			
+			//! @brief The distribution's mean, \f$ \langle x \rangle = \int \text{PDF}(x)\, x\, dx \f$.
+			virtual real_t Mean() const = 0; 
+			//! @brief The distribution's variance, \f$ \langle x^2 \rangle - \langle x \rangle^2 \f$.
+			virtual real_t Variance() const = 0;
+			
+			using distribution<real_t>::GetSample; // Declare "using" to force creation of binary code
+	};
+	
+	/*! @brief Sample many variates and calculate their mean and variance (for validation).
+	 * 
+	 * \param sampleSize 	the sample size
+	 * \param gen 		the PRNG engine
+	 *
+	 * \return the mean and variance in a \ref two (two.x = mean, two.y = variance).
+	*/			
+	two MeanAndVariance(distributionPDF const& dist, size_t const sampleSize, engine& gen);
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief An abstract class which extends the \ref distributionPDF interface 
+	 *  for those distributions with a calculable CDF.
+	*/ 
+	class distributionCDF : public distributionPDF
+	{
+		protected:
+			//! @brief The CDF, where x is guaranteed to be supported by \ref CDF.
+			virtual real_t CDF_small_supported(real_t const x) const = 0;
+			//! @brief The complementary CDF, where x is guaranteed to be supported by \ref CDF.
+			virtual real_t CDF_large_supported(real_t const x) const = 0;
+			
+			//! @brief The CDF of an array (see PDF_array(); the default calls the checked CDF()).
+			virtual void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			//! @brief The complementary CDF of an array (see PDF_array(); the default calls the checked CompCDF()).
+			virtual void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+		
+		public:
+			distributionCDF() {}		
+			virtual ~distributionCDF() {}
+			
+			//! @brief The cumulative distribution function; \f$ \text{CDF}(x) = \int_\text{min}^x \text{PDF}(x^\prime)\text{d}x^\prime \f$.
+			real_t CDF(real_t const x) const;
+			
+			//! @brief The accurate complementary CDF (i.e. 1 - CDF(x), without cancellation).
+			real_t CompCDF(real_t const x) const;
+			
+			//! @brief The CDF of an array of \p n values (see the array PDF()); \p cdf may alias \p x.
+			void CDF(real_t const* const x, real_t* const cdf, size_t const n) const;
+			
+			//! @brief The complementary CDF of an array of \p n values (see the array PDF()); \p ccdf may alias \p x.
+			void CompCDF(real_t const* const x, real_t* const ccdf, size_t const n) const;
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////	
+	
+	/*! @brief An abstract class which extends the \ref distributionCDF interface 
+	 *  for those distributions with an invertible CDF (i.e. quantile functions).
+	 * 
+	 *  This permits a generic operator() using a quantile flip-flop 
+	 *  (the precise inversion method, as discuseed in the \ref theory paper),
+	 *  which keeps the quantile function well-conditioned in both tails.
+	*/
+	class distributionQ2 : public distributionCDF
+	{
+		protected:
+			//! @brief Q_small() of an array (see PDF_array()).
+			virtual void Q_small_array(real_t const* const u, real_t* const x, size_t const n) const;
+			//! @brief Q_large() of an array (see PDF_array()).
+			virtual void Q_large_array(real_t const* const u, real_t* const x, size_t const n) const;
+			
+		public:
+			distributionQ2() {}		
+			virtual ~distributionQ2() {}
+			
+			/*! @brief The quantile function (the inverse of the CDF),
+			 *  which accurately samples the small-value tail (given \p u < 1/2).
+			 * 
+			 *  \param u 	a uniform variate from (0, 1)
+			*/ 
+			virtual real_t Q_small(real_t const u) const = 0;
+			
+			/*! @brief The complementary quantile function 
+			 *  (the inverse of the Complementary CDF, by taking u -> 1 - u in Q_small),
+			 *  which accurately samples the large-value tail (given \p u < 1/2).
+			 * 
+			 *  \param u 	a uniform variate from (0, 1)
+			*/
+			virtual real_t Q_large(real_t const u) const = 0;
+			
+			/*! @brief Q_small() of an array of \p n values; \p x may alias \p u.
+			 * 
+			 *  \note Derived classes must declare <tt> using distributionQ2::Q_small; </tt>,
+			 *  otherwise their own Q_small() hides this overload.
+			*/ 
+			void Q_small(real_t const* const u, real_t* const x, size_t const n) const {Q_small_array(u, x, n);}
+			
+			//! @brief Q_large() of an array of \p n values; \p x may alias \p u.
+			void Q_large(real_t const* const u, real_t* const x, size_t const n) const {Q_large_array(u, x, n);}
+			
+			/*! @brief Sample one variate using a quantile flip-flop.
+			 * 
+			 *  Randomly choose Q_small or Q_large, then feed it a variate from pqRand:engine::HalfU_uneven.
+			 * 
+			 * \param gen 		the PRNG engine
+			*/
+			real_t operator()(engine& gen) const;
+			
+			/*! @brief Sample antithetic variates (same u through both Q).
+			 * 
+			 * \param gen 		the PRNG engine
+			*/	
+			two GetTwo_antithetic(engine& gen) const;
+			
+			/*! @brief Sample the largest of \p n variates in O(1) (without sampling all n).
+			 * 
+			 *  The CDF of the maximum is \f$ \text{CDF}(x)^n \f$, so its CDF is \f$ e^{-E/n} \f$ 
+			 *  for a standard \ref exponential variate \f$ E \f$ (sampled by its own flip-flop, 
+			 *  so small E are precise). The complement \f$ -\text{expm1}(-E/n) \f$ is fed to Q_large 
+			 *  when it is below 1/2, so the far upper tail (where the maximum of a large n lies) 
+			 *  stays precise; otherwise \f$ e^{-E/n} \f$ is fed to Q_small.
+			 * 
+			 *  \param n 		the number of variates
+			 *  \param gen 		the PRNG engine
+			 *  
+			 *  \throws throws std::domain_error if \p n is zero.
+			*/
+			real_t SampleMax(uint64_t const n, engine& gen) const;
+			
+			//! @brief Sample the smallest of \p n variates in O(1) (the mirror image of SampleMax()).
+			real_t SampleMin(uint64_t const n, engine& gen) const;
+			
+			/*! @brief Sample the k-th smallest of \p n variates in O(1) (k = 1 is the minimum, k = n the maximum).
+			 * 
+			 *  The CDF of the k-th smallest variate is a Beta(k, n - k + 1) variate, 
+			 *  \f$ G_k / (G_k + G_{n-k+1}) \f$ for two unit-rate gamma variates 
+			 *  (from \ref gammaDist_MarsagliaTsang). Its complement \f$ G_{n-k+1} / (G_k + G_{n-k+1}) \f$ 
+			 *  is just as precise, so the smaller is fed to Q_small or Q_large (respectively).
+			 *  The extremes (k = 1 and k = n) use SampleMin() and SampleMax().
+			 * 
+			 *  \param k 		the rank (from the smallest)
+			 *  \param n 		the number of variates
+			 *  \param gen 		the PRNG engine
+			 *  
+			 *  \throws throws std::domain_error unless (1 <= \p k <= \p n).
+			*/
+			real_t SampleOrderStatistic(uint64_t const k, uint64_t const n, engine& gen) const;
+
+			/*! @brief The number of variates in each block of FillSorted().
+			 *
+			 *  \warning This is part of the definition of the sorted sample;
+			 *  changing it changes every sorted sample.
+			*/
+			size_t static constexpr sortedBlockSize = (size_t(1) << 16);
+
+			/*! @brief Sample a number of variates, in ascending order, into an existing array
+			 *  (in O(n), without sorting).
+			 *
+			 *  The CDFs of a sorted sample are the partial sums of n + 1 \ref exponential spacings
+			 *  (divided by their total). The sample is divided into blocks of \ref sortedBlockSize variates,
+			 *  and each block's total is drawn first (a gamma variate), so each block can then be
+			 *  sampled in one pass: it draws its own spacings and rescales them to its total.
+			 *  The lower half of the sample sums the spacings from the bottom and uses Q_small,
+			 *  the upper half sums them from the top and uses Q_large,
+			 *  so both tails keep the precision of operator().
+			 *
+			 *  \note Q is only monotonic to within its rounding, so a variate which rounds
+			 *  below its predecessor (i.e. a near-tie) is raised to equal it.
+			 *
+			 *  \param sample 	the array to fill (with room for at least \p sampleSize variates)
+			 *  \param sampleSize 	the sample size
+			 *  \param gen 	the PRNG engine
+			*/
+			void FillSorted(real_t* const sample, size_t const sampleSize, engine& gen) const;
+
+			/*! @brief Sample a number of variates, in ascending order, and return them in a vector.
+			 *
+			 *  See FillSorted().
+			 *
+			 *  \param sampleSize 	the sample size
+			 *  \param gen 	the PRNG engine
+			*/
+			std::vector<real_t> GetSortedSample(size_t const sampleSize, engine& gen) const;
+
+			#if PRNG_CAN_JUMP
+			/*! @brief FillSorted() using several threads.
+			 *
+			 *  The block totals are drawn from \p gen, then block \em b is sampled by its own engine,
+			 *  whose state is \p gen's state Jump()-ed \em b times (as in Fill_Parallel()),
+			 *  so the sample is identical for any \p numThreads (but not the same sample as FillSorted()).
+			 *
+			 *  \param sample 	the array to fill (with room for at least \p sampleSize variates)
+			 *  \param sampleSize 	the sample size
+			 *  \param gen 	the PRNG engine
+			 *  \param numThreads 	the number of threads (zero uses every hardware thread)
+			*/
+			void FillSorted_Parallel(real_t* const sample, size_t const sampleSize, engine& gen,
+				size_t const numThreads) const;
+
+			/*! @brief Sample a number of variates, in ascending order, using several threads
+			 *  and return them in a vector.
+			 *
+			 *  See FillSorted_Parallel().
+			*/
+			std::vector<real_t> GetSortedSample_Parallel(size_t const sampleSize, engine& gen,
+				size_t const numThreads) const;
+			#endif
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample integers uniformly from the half-open [min, max).
+	 * 
+	 *  \note max() is not actually returned; the largest sampled variate is (max - 1).
+	 *  This is a slight perversion of the \ref distribution interface, 
+	 *  but is most consistent with the standard definition of uniform integer sampling.
+	*/	
+	template<typename int_t>
+	class uniform_integer : public distribution<int_t>
+	{
+		private:
+			using rand_t = pqRand::engine::result_type;
+		
+			int_t const min_;
+			int_t const max_;
+			rand_t const spread;
+			rand_t const maxRand;
+			
+			#if PQR_REJECTION_STATS
+			rejection_counter rejections; // Proposals are PRNG words, rejected when they exceed maxRand
+			#endif
+			
+			rand_t static constexpr rightShift = pqRand::engine::badBits;
+			rand_t static constexpr biggestRand = (pqRand::engine::max() >> rightShift);
+			
+			// This class is simple, so it cannot create more entropy than the PRNG.
+			static_assert(std::numeric_limits<int_t>::digits <= std::numeric_limits<rand_t>::digits,
+				"pqRand::uniformInteger: integer type has too many digits");
+			static_assert(pqRand::engine::min() == 0, 
+				"pqRand::uniformInteger: PRNG must return 0.");
+					
+		public:
+			/*! @brief Define the half-open interval [min, max)
+			 *  
+			 *  \throws throws std::domain_error if (\p max <= \p min).
+			*/ 
+			explicit uniform_integer(int_t const min, int_t const max);
+			
+			int_t operator()(pqRand::engine& gen) const;
+			using distribution<int_t>::GetSample; // Declare "using" to force creation of binary code
+			
+			#if PQR_REJECTION_STATS
+			//! @brief The statistics of the PRNG words rejected by operator() (to avoid modulo bias) (see \ref PQR_REJECTION_STATS).
+			rejection_stats RejectionStats() const {return rejections.Snapshot();}
+			//! @brief Zero the statistics returned by RejectionStats().
+			void ResetRejectionStats() const {rejections.Reset();}
+			#endif
+			
+			inline int_t min() const {return min_;}
+			inline int_t max() const {return max_;} //!< One past the maximum variate sampled.
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the index of a category (0, 1, ..., n-1) 
+	 *  with a probability proportional to its weight.
+	 * 
+	 *  \f$ P(i) = w_i / \sum_j w_j \f$
+	 * 
+	 *  This class uses Vose's stable variant of Walker's alias method
+	 *  > Vose, M.D. "A linear algorithm for generating random numbers with a given distribution,"
+	 *  > IEEE Transactions on Software Engineering, Vol. 17 (1991)
+	 *  The table is built in O(n), and each variate is sampled in O(1) 
+	 *  (without a search over the CDF): a column is chosen by \ref uniform_integer,
+	 *  then a single \ref engine::U_even "U_even" chooses between the column's 
+	 *  own index and its alias. 
+	 *  
+	 *  The table is stored as a struct-of-arrays (thresholds and aliases), 
+	 *  so a table of n categories occupies n*(sizeof(real_t) + sizeof(index_t)) bytes 
+	 *  (the weights, which identify its table file, are not kept); 
+	 *  the default 32-bit \p index_t supports up to \f$ 2^{32} - 1 \f$ categories.
+	 *  
+	 *  \note Probabilities are only resolved to the precision of U_even (\f$ 2^{-53} \f$ per column), 
+	 *  so categories with \f$ P(i) \lesssim 2^{-53} / n \f$ may never be sampled.
+	 *  
+	 *  A large table can be written to a file once (see Write()), then memory-mapped read-only
+	 *  by every later job using the same weights (see \ref table_files), 
+	 *  so that it costs no construction time and its pages are shared between processes.
+	 *  Copies of a discrete share the same (immutable) table.
+	 *  
+	 *  \param index_t 	the unsigned integer type of the category index (uint32_t or uint64_t)
+	*/
+	template<typename index_t = uint32_t>
+	class discrete : public distribution<index_t>
+	{
+		private:
+			uniform_integer<index_t> const column; // Which column of the table
+			real_t const* threshold; // Keep the column's own index when U_even < threshold
+			index_t const* alias; // Otherwise, return its alias
+			std::shared_ptr<void const> storage; // Owns the table (built in memory, or a mapped file)
+			
+			static_assert(not std::numeric_limits<index_t>::is_signed, 
+				"pqRand::discrete: index_t must be unsigned");
+			
+			// The number of variates drawn per pass in Fill
+			size_t static constexpr fillChunk = 1024;
+			
+			void Build(std::vector<real_t> const& weights);
+			// True if the file holds the table of these weights (and it was mapped)
+			bool Map(std::vector<real_t> const& weights, std::string const& filePath);
+			// Write the table to a file, keyed by these weights (which must have built it)
+			void WriteFile(std::vector<real_t> const& weights, std::string const& filePath) const;
+			
+		public:
+			/*! @brief Build the alias table from the (un-normalized) weights of each category.
+			 *  
+			 *  \param weights 	the weight of each category (category i has weight \p weights[i])
+			 *  
+			 *  \throws throws std::domain_error if \p weights is empty, 
+			 *  has too many categories for \p index_t, has any negative or non-finite weight, 
+			 *  or sums to zero.
+			*/ 
+			explicit discrete(std::vector<real_t> const& weights);
+			
+			/*! @brief Map the alias table from a table file (see \ref table_files), 
+			 *  if the file holds the table of these \p weights; 
+			 *  otherwise build the table and write it to the file.
+			 *  
+			 *  \param weights 	the weight of each category (category i has weight \p weights[i])
+			 *  \param filePath 	the table file
+			 *  
+			 *  \throws throws std::domain_error (as the other constructor), 
+			 *  or std::ofstream::failure if the table must be built, but the file cannot be written.
+			*/ 
+			discrete(std::vector<real_t> const& weights, std::string const& filePath);
+			
+			/*! @brief Write the table to a file (see \ref table_files).
+			 *  
+			 *  The table does not keep its weights, so they must be supplied again (they key the file).
+			 *  They are checked by rebuilding the table from them (in O(n)).
+			 *  
+			 *  \param weights 	the weights this table was built from
+			 *  \param filePath 	the table file
+			 *  
+			 *  \warning Replaces the file without warning (but never leaves it partially written).
+			 *  
+			 *  \throws throws std::domain_error if \p weights do not build this table, 
+			 *  or std::ofstream::failure if the file cannot be written.
+			*/ 
+			void Write(std::vector<real_t> const& weights, std::string const& filePath) const;
+			
+			index_t operator()(pqRand::engine& gen) const;
+			
+			/*! @brief Redefine Fill to draw every column of a chunk, then resolve the chunk's aliases.
+			 *  
+			 *  The table lookups of a chunk are then independent of each other 
+			 *  (and of the PRNG), so large tables are read with much less latency.
+			 *  The random numbers are drawn in the same order as operator(), 
+			 *  so the sample is identical to repeated calls to operator().
+			*/ 
+			void Fill(index_t* const sample, size_t const sampleSize, pqRand::engine& gen) const;
+			using distribution<index_t>::GetSample; // Declare "using" to force creation of binary code
+			
+			inline index_t min() const {return 0;}
+			inline index_t max() const {return index_t(column.max() - 1);} //!< The last category.
+			
+			inline size_t Size() const {return size_t(column.max());} //!< The number of categories.
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the index of a category (0, 1, ..., n-1) 
+	 *  with a probability proportional to its weight, where the weights can change between draws.
+	 * 
+	 *  \f$ P(i) = w_i / \sum_j w_j \f$
+	 * 
+	 *  The weights are stored in a Fenwick tree (binary indexed tree) of partial sums
+	 *  > Fenwick, P.M. "A new data structure for cumulative frequency tables,"
+	 *  > Software: Practice and Experience, Vol. 24 (1994)
+	 *  so updating one weight and sampling a variate are both O(log n) 
+	 *  (whereas the alias table of \ref discrete must be rebuilt in O(n) for any change). 
+	 *  A variate is sampled by scaling one \ref engine::U_even "U_even" by the total weight, 
+	 *  then descending the tree to the category whose cumulative range contains it.
+	 *  
+	 *  Each update adds (new - old) to O(log n) partial sums, so rounding error accumulates. 
+	 *  The tree is therefore rebuilt from the exact weights (in O(n)) after n updates 
+	 *  (amortized O(1) per update), and whenever the total weight has fallen far 
+	 *  below its largest value since the last rebuild (when the partial sums could be dominated by rounding error).
+	 *  Categories of zero weight are never sampled.
+	 *  
+	 *  \param index_t 	the unsigned integer type of the category index (uint32_t or uint64_t)
+	*/
+	template<typename index_t = uint32_t>
+	class dynamic_discrete : public distribution<index_t>
+	{
+		private:
+			std::vector<real_t> weights; // The exact weight of each category
+			std::vector<real_t> tree; // The Fenwick tree (1-indexed; tree[0] is unused, tree[i > n] is the largest real_t)
+			size_t topStep; // The largest power of two <= n (the first step of the descent)
+			real_t total; // The sum of the weights
+			real_t peak; // The largest total since the last rebuild
+			size_t numPositive; // The number of non-zero weights (exact, unlike total)
+			size_t updates; // The number of updates since the last rebuild
+			
+			static_assert(not std::numeric_limits<index_t>::is_signed, 
+				"pqRand::dynamic_discrete: index_t must be unsigned");
+				
+			// Rebuild the tree when total < (peak * rebuildFraction)
+			static constexpr real_t rebuildFraction = real_t(1./(uint64_t(1) << 20));
+			
+			// Descend without branches when the tree has at most this many nodes (i.e. it fits in L2 cache)
+			static constexpr size_t branchFreeNodes = (size_t(1) << 15);
+			
+			// Check one weight (throw std::domain_error if it is negative or non-finite)
+			static void CheckWeight(real_t const weight);
+			
+			// Check one index (throw std::domain_error if it is out of bounds)
+			void CheckIndex(index_t const i) const;
+			
+			// Build the tree from weights (in O(n))
+			void Build();
+			
+			// Set one weight (without checking it)
+			void Set(index_t const i, real_t const weight);
+			
+			// Rebuild the tree if rounding error has potentially accumulated
+			void MaybeRebuild();
+			
+			// Descend the tree to the category containing u in [0, total); 
+			// returns n on failure (u >= the tree's total, due to rounding error)
+			size_t Descend(real_t u) const;
+			
+			// Sample one category (the total must be positive)
+			index_t Sample(pqRand::engine& gen) const;
+			
+			// The number of weights to update at once which warrants a rebuild
+			size_t BulkThreshold() const;
+			
+		public:
+			/*! @brief Build the tree from the (un-normalized) initial weight of each category.
+			 *  
+			 *  \param weights 	the weight of each category (category i has weight \p weights[i])
+			 *  
+			 *  \throws throws std::domain_error if \p weights is empty, 
+			 *  has too many categories for \p index_t, or has any negative or non-finite weight
+			 *  (the weights may all be zero, but then no variate can be sampled until one is updated).
+			*/ 
+			explicit dynamic_discrete(std::vector<real_t> const& weights);
+			
+			virtual ~dynamic_discrete(); // Out-of-line (it frees two vectors; inlining it only bloats the caller)
+			
+			/*! @brief Sample one category.
+			 *  
+			 *  \throws throws std::domain_error if every weight is zero.
+			*/ 
+			index_t operator()(pqRand::engine& gen) const;
+			
+			/*! @brief Redefine Fill to check the weights once (the sample is identical to repeated operator()).
+			 *  
+			 *  \throws throws std::domain_error if every weight is zero (and \p sampleSize > 0).
+			*/ 
+			void Fill(index_t* const sample, size_t const sampleSize, pqRand::engine& gen) const;
+			using distribution<index_t>::GetSample; // Declare "using" to force creation of binary code
+			
+			/*! @brief Change the weight of category \p i (in O(log n)).
+			 *  
+			 *  \throws throws std::domain_error if \p i is out of bounds, 
+			 *  or \p weight is negative or non-finite.
+			*/ 
+			void Update(index_t const i, real_t const weight);
+			
+			/*! @brief Change the weights of many categories at once.
+			 *  
+			 *  Category \p indices[j] gets weight \p newWeights[j]; when an index is repeated, the last weight wins. 
+			 *  When \p count is large enough (about n / log2(n)), it is faster to rebuild the tree (in O(n)) 
+			 *  than to update each weight (in O(log n)), so the tree is rebuilt instead.
+			 *  
+			 *  \param indices 	the categories to update
+			 *  \param newWeights 	the new weight of each category
+			 *  \param count 	the length of both arrays
+			 *  
+			 *  \throws throws std::domain_error if any index is out of bounds, 
+			 *  or any weight is negative or non-finite (in which case no weight is changed).
+			*/ 
+			void Update(index_t const* const indices, real_t const* const newWeights, size_t const count);
+			
+			/*! @brief Replace every weight (and rebuild the tree in O(n)).
+			 *  
+			 *  \throws throws std::domain_error if \p newWeights is the wrong size,
+			 *  or has any negative or non-finite weight (in which case no weight is changed).
+			*/ 
+			void Update(std::vector<real_t> const& newWeights);
+			
+			inline index_t min() const {return 0;}
+			inline index_t max() const {return index_t(weights.size() - 1);} //!< The last category.
+			
+			inline size_t Size() const {return weights.size();} //!< The number of categories.
+			inline real_t Weight(index_t const i) const {return weights.at(i);} //!< The weight of category \p i.
+			inline real_t Total() const {return total;} //!< The sum of the weights (to within rounding error).
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief A table of the CDF and the complementary CDF of a distribution over 
+	 *  the non-negative integers, sampled by inversion (the helper of \ref poisson and 
+	 *  \ref binomial when their mean is small).
+	 * 
+	 *  Inversion of \f$ u \f$ from \f$ U[0, 1) \f$ cannot sample any tail probability 
+	 *  below \f$ 2^{-53} \f$, because \f$ 1 - u \f$ is never that small.
+	 *  Instead, the table uses the quantile flip-flop (see \ref theory): 
+	 *  a random bit chooses between the lower and upper half of the distribution, 
+	 *  then an uneven \f$ u \f$ from \f$ U(0, 1/2] \f$ (engine::HalfU_uneven)
+	 *  is inverted through either the CDF (from the bottom) or the complementary CDF (from the top).
+	 *  Both are accumulated from the PMF in the direction of increasing probability, 
+	 *  so every tail probability is precise (relative to itself).
+	*/
+	class pmf_table
+	{
+		private:
+			std::vector<real_t> cdf; // P(X <= k)
+			std::vector<real_t> ccdf; // P(X > k)
+			uint64_t upperStart; // The smallest k with P(X > k) < 1/2 (where the upper search begins)
+			
+		public:
+			pmf_table(): upperStart(0) {}
+			
+			~pmf_table(); // Out-of-line (it frees two vectors; inlining it only bloats the caller)
+			
+			/*! @brief Build the table from the PMF over (0, 1, ..., pmf.size() - 1).
+			 *  
+			 *  The probability beyond the last entry must be negligible (e.g. it underflows).
+			*/
+			explicit pmf_table(std::vector<real_t> const& pmf);
+			
+			//! @brief Sample one variate.
+			uint64_t operator()(pqRand::engine& gen) const;
+			
+			inline bool empty() const {return cdf.empty();} //!< Is the table unbuilt?
+			inline size_t Size() const {return cdf.size();} //!< The number of entries.
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the Poisson distribution (with mean \f$ \mu > 0 \f$).
+	 * 
+	 *  \f$ P(k) = \frac{\mu^k}{k!}e^{-\mu} \f$
+	 * 
+	 *  For \f$ \mu < \f$ \ref tableMean, the variate is sampled by inversion 
+	 *  of a precomputed \ref pmf_table (the PMF is tabulated until it underflows).
+	 *  Otherwise, it uses the transformed rejection method of
+	 *  > Hörmann, W. "The transformed rejection method for generating Poisson random variables,"
+	 *  > Insurance: Mathematics and Economics, Vol. 12 (1993)
+	 *  (PTRS), which accepts ~90% of proposals (most of them without a \c log) 
+	 *  in constant time for any \f$ \mu \f$. 
+	 *  The proposal's distance from the tails is sampled by engine::HalfU_uneven
+	 *  (and its side by engine::RandBool), so the far tails are sampled precisely.
+	 *  The acceptance test uses a log-PMF which is free of cancellation 
+	 *  (Loader's saddle-point form), so it remains exact for very large \f$ \mu \f$.
+	 *  
+	 *  \note Proposals are computed as a real_t, so when \f$ \mu \gtrsim 2^{53} \f$
+	 *  the variates are only resolved to the precision of a real_t.
+	*/
+	class poisson : public distribution<uint64_t>
+	{
+		private:
+			real_t const mu_;
+			
+			// PTRS constants (unused when the table is used)
+			real_t const b;
+			real_t const a;
+			real_t const invAlpha;
+			real_t const vr;
+			real_t const logInvAlpha;
+			
+			pmf_table const table; // Only built when (mu < tableMean)
+			
+			#if PQR_REJECTION_STATS
+			rejection_counter rejections; // Proposals are PTRS pairs (u, v)
+			#endif
+			
+			// Make one PTRS proposal; if it is accepted, store it in variate.
+			bool Accept(pqRand::engine& gen, uint64_t& variate) const;
+			
+			// Sample one variate via PTRS
+			uint64_t Sample_PTRS(pqRand::engine& gen) const;
+			
+		public:
+			//! @brief Below this mean, variates are sampled by inversion (instead of PTRS).
+			static constexpr real_t tableMean = real_t(10);
+			
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param mu 	the mean
+			 *  
+			 *  \throws throws std::domain_error if \p mu is not positive and finite
+			*/ 
+			explicit poisson(real_t const mu);
+			
+			inline uint64_t min() const {return 0;}
+			inline uint64_t max() const {return std::numeric_limits<uint64_t>::max();}
+			
+			real_t Mean() const {return mu_;}
+			real_t Variance() const {return mu_;}
+			
+			uint64_t operator()(pqRand::engine& gen) const;
+			
+			// Redefine Fill to choose the method once.
+			void Fill(uint64_t* const sample, size_t const sampleSize, pqRand::engine& gen) const;
+			using distribution<uint64_t>::GetSample; // Declare "using" to force creation of binary code
+			
+			inline real_t Mu() const {return mu_;} //!< The mean
+			
+			#if PQR_REJECTION_STATS
+			//! @brief The statistics of the PTRS rejection sampler (see \ref PQR_REJECTION_STATS).
+			rejection_stats RejectionStats() const {return rejections.Snapshot();}
+			//! @brief Zero the statistics returned by RejectionStats().
+			void ResetRejectionStats() const {rejections.Reset();}
+			#endif
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the binomial distribution 
+	 *  (the number of successes in \f$ n \f$ trials, each with success probability \f$ p \f$).
+	 * 
+	 *  \f$ P(k) = \binom{n}{k}p^k(1-p)^{n-k} \f$
+	 * 
+	 *  When \f$ p > 1/2 \f$, the failures are sampled instead (with \f$ 1 - p \f$).
+	 *  Then, for \f$ n\,p < \f$ \ref tableMean, the variate is sampled by inversion 
+	 *  of a precomputed \ref pmf_table (the PMF is tabulated until it underflows).
+	 *  Otherwise, it uses the transformed rejection method of
+	 *  > Hörmann, W. "The generation of binomial random variates,"
+	 *  > Journal of Statistical Computation and Simulation, Vol. 46 (1993)
+	 *  (BTRS), which is PTRS adapted to the binomial; it is as fast as 
+	 *  the classic BTPE (Kachitvichyanukul and Schmeiser) but much simpler, 
+	 *  with a cheaper setup. As in \ref poisson, the far tails are sampled precisely
+	 *  (and when \f$ n \gtrsim 2^{53} \f$, the variates are only resolved to the precision of a real_t).
+	*/
+	class binomial : public distribution<uint64_t>
+	{
+		private:
+			uint64_t const n_;
+			real_t const p_;
+			real_t const pSmall; // min(p, 1 - p)
+			
+			// BTRS constants (unused when the table is used)
+			real_t const spq;
+			real_t const b;
+			real_t const a;
+			real_t const c;
+			real_t const vr;
+			real_t const alpha;
+			real_t const logPMF_mode; // The log of the PMF at the mode
+			
+			pmf_table const table; // Only built when (n p < tableMean)
+			bool const flip; // (p > 1/2), so sample the failures (with 1 - p)
+			char padding[sizeof(real_t) - sizeof(bool)]; // Explicit, so -Wpadded stays quiet
+			
+			#if PQR_REJECTION_STATS
+			rejection_counter rejections; // Proposals are BTRS pairs (u, v)
+			#endif
+			
+			// Make one BTRS proposal; if it is accepted, store it in variate.
+			bool Accept(pqRand::engine& gen, uint64_t& variate) const;
+			
+			// Sample the number of successes (with probability pSmall), via BTRS
+			uint64_t Sample_BTRS(pqRand::engine& gen) const;
+			
+			// Undo the flip
+			inline uint64_t Unflip(uint64_t const k) const {return flip ? (n_ - k) : k;}
+			
+		public:
+			//! @brief Below this mean (of the smaller of successes and failures), variates are sampled by inversion (instead of BTRS).
+			static constexpr real_t tableMean = real_t(10);
+			
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param n 	the number of trials
+			 *  \param p 	the probability of success
+			 *  
+			 *  \throws throws std::domain_error if \p p is not in [0, 1]
+			*/ 
+			binomial(uint64_t const n, real_t const p);
+			
+			inline uint64_t min() const {return 0;}
+			inline uint64_t max() const {return n_;}
+			
+			real_t Mean() const {return real_t(n_) * p_;}
+			real_t Variance() const {return real_t(n_) * p_ * (real_t(1) - p_);}
+			
+			uint64_t operator()(pqRand::engine& gen) const;
+			
+			// Redefine Fill to choose the method once.
+			void Fill(uint64_t* const sample, size_t const sampleSize, pqRand::engine& gen) const;
+			using distribution<uint64_t>::GetSample; // Declare "using" to force creation of binary code
+			
+			inline uint64_t n() const {return n_;} //!< The number of trials
+			inline real_t p() const {return p_;} //!< The probability of success
+			
+			#if PQR_REJECTION_STATS
+			//! @brief The statistics of the BTRS rejection sampler (see \ref PQR_REJECTION_STATS).
+			rejection_stats RejectionStats() const {return rejections.Snapshot();}
+			//! @brief Zero the statistics returned by RejectionStats().
+			void ResetRejectionStats() const {rejections.Reset();}
+			#endif
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample Bernoulli trials (\c true with probability \f$ p \f$), 
+	 *  using about 2 random bits per trial (about 2.7 in bulk).
+	 * 
+	 *  A trial is \c true when \f$ U < p \f$. Rather than drawing a 53-bit \f$ U \f$, 
+	 *  we compare the binary expansion of \f$ U \f$ (one random bit at a time, from engine::RandBool) 
+	 *  to the binary expansion of \f$ p \f$; the trial is decided by the first bit where they differ.
+	 *  Each bit differs with probability 1/2, so a trial uses 2 bits on average 
+	 *  (for \em any \f$ p \f$, and the comparison is exact, so \f$ p \f$ is never rounded).
+	 *  
+	 *  FillPacked() runs 64 trials at once, one per bit of a word: each word of random bits 
+	 *  is compared (bit-parallel) to the next bit of \f$ p \f$, until only a few trials remain undecided, 
+	 *  which are then finished one at a time (from a local stream of random bits, 
+	 *  whose unused bits carry over to the next word). The bit-parallel steps are much faster, 
+	 *  but also spend a whole word per step on trials already decided, so 64 trials consume 
+	 *  about 2.8 PRNG words, i.e. about 2.7 random bits per trial (versus 2 for operator(), 
+	 *  and 64 words for \f$ U \f$ drawn by engine::U_even). Finishing the trials one at a time sooner 
+	 *  saves bits but not time: stopping the bit-parallel steps at 32 undecided trials (instead of 16) 
+	 *  spends about 2.2 bits per trial, but halves the throughput.
+	 *  The bits left in the local stream at the end are discarded.
+	 *  
+	 *  \note This class does not derive from \ref distribution, because std::vector<bool> is packed 
+	 *  (so it cannot be filled via a pointer); use Fill() or FillPacked() instead of GetSample().
+	*/
+	class bernoulli
+	{
+		private:
+			real_t const p_;
+			uint64_t leadingZeros; // p < 2**-leadingZeros
+			uint64_t mantissa; // The significant bits of p, left-aligned
+			
+			// Continue the trials in FillPacked bit-parallel while more than this many are undecided
+			size_t static constexpr bitParallelThreshold = 16;
+			
+			// Random bits drawn from the engine (word by word) but consumed a few at a time
+			struct bit_stream
+			{
+				uint64_t bits; // Left-aligned (the next bit is the most significant)
+				uint64_t count; // The number of unused bits
+				
+				bit_stream(): bits(0), count(0) {}
+			};
+			
+			// Bit j of the binary expansion of p (j = 0 is the 1/2's place)
+			inline bool Bit(uint64_t const j) const
+			{
+				return (j >= leadingZeros) and ((j - leadingZeros) < 64) and 
+					bool((mantissa << (j - leadingZeros)) bitand (uint64_t(1) << 63));
+			}
+			
+			// Bits [j, j + 64) of the binary expansion of p (left-aligned)
+			uint64_t Window(uint64_t const j) const;
+			
+			// Decide a trial whose first j bits matched p's, one random bit at a time
+			bool Compare(pqRand::engine& gen, uint64_t j) const;
+			
+			// Decide a trial whose first j bits matched p's, using bits from the stream
+			bool Compare(bit_stream& stream, pqRand::engine& gen, uint64_t j) const;
+			
+			// Run 64 trials, one per bit of the returned word
+			uint64_t Packed64(bit_stream& stream, pqRand::engine& gen) const;
+			
+		public:
+			/*! @brief Define the probability of \c true.
+			 *  
+			 *  \throws throws std::domain_error if \p p is not in [0, 1]
+			*/
+			explicit bernoulli(real_t const p);
+			
+			/*! @brief Run one trial (no random bits are used when \p p is 0 or 1).
+			 *  
+			 *  \note The number of bits per trial is random, so each trial ends with a mispredicted branch; 
+			 *  for throughput, use Fill() or FillPacked().
+			*/
+			bool operator()(pqRand::engine& gen) const;
+			
+			/*! @brief Run a number of trials, storing each in a bool (via FillPacked).
+			 *  
+			 *  \param sample 	the array to fill (with room for at least \p sampleSize trials)
+			 *  \param sampleSize 	the number of trials
+			 *  \param gen 	the PRNG engine
+			*/ 
+			void Fill(bool* const sample, size_t const sampleSize, pqRand::engine& gen) const;
+			
+			/*! @brief Run a number of trials, storing them as a packed bitset.
+			 *  
+			 *  Trial \em i is bit (\em i % 64) of \p words[\em i / 64] (least significant bit first). 
+			 *  Unused bits of the last word are zero.
+			 *  
+			 *  \param words 	the array to fill (with room for at least ceil(\p numTrials / 64) words)
+			 *  \param numTrials 	the number of trials
+			 *  \param gen 	the PRNG engine
+			*/ 
+			void FillPacked(uint64_t* const words, size_t const numTrials, pqRand::engine& gen) const;
+			
+			/*! @brief Run a number of trials and return them as a packed bitset (see FillPacked()).
+			*/ 
+			std::vector<uint64_t> GetPacked(size_t const numTrials, pqRand::engine& gen) const;
+			
+			real_t Mean() const {return p_;}
+			real_t Variance() const {return p_ * (real_t(1) - p_);}
+			
+			inline real_t p() const {return p_;} //!< The probability of \c true
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+			
+	/*! @brief Sample the uniform distribution over the \em closed interval [min, max].
+	 * 
+	 * \f$ \text{PDF}(x) = \frac{1}{\text{max}-\text{min}} \f$
+	 * 
+	 * \warning \em Both endpoints are returned (unless \p a is zero, 
+	 * in which case <em> exactly zero </em> will probably not be returned).
+	*/
+	class uniform : public distributionCDF
+	{
+		private:
+			static_dist::uniform const kernel; // The sampler and the math (see static_dist::uniform)
+			
+		protected:
+			real_t PDF_supported(real_t const x) const;
+			real_t CDF_small_supported(real_t const x) const;
+			real_t CDF_large_supported(real_t const x) const;			
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+					
+		public:
+			/*! @brief Define the closed interval [min, max]
+			 *  
+			 *  \throws throws std::domain_error if (\p max <= \p min).
+			*/ 
+			uniform(real_t const min, real_t const max);
+			
+			real_t Mean() const {return kernel.Mean();}
+			real_t Variance() const {return kernel.Variance();}
+							
+			real_t operator()(pqRand::engine& gen) const final;
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const final;
+			
+			inline real_t min() const {return kernel.min();}
+			inline real_t max() const {return kernel.max();}
+			// Note: ((max - min) + min == max) with floats if max > min. This is important.
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the standard normal distribution (\f$ \mu =0 \f$, \f$\sigma=1\f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = \exp(-\frac{1}{2}x^2)/\sqrt{2\pi} \f$
+	 * 
+	 *  Samples are generated using the Marsaglia polar method, 
+	 *  modified to use a quantile flip-flop and uneven \f$ U(0,1) \f$.
+	 * 
+	 *  \note The Marsaglia polar method generates two numbers per call. 
+	 *  If only one number is requested, the second is cached for the next call.
+	*/ 
+	class standard_normal : public distributionCDF
+	{
+		private:
+			// Make these mutable because the object isn't really changing
+			mutable real_t cache; // Marsaglia polar samples two, cache one if we only request one
+			mutable bool valueCached; // if(valueCached == true), cache holds the next variate
+			char padding[sizeof(real_t) - sizeof(bool)]; // Explicit, so -Wpadded stays quiet
+			
+		protected:
+			virtual real_t PDF_supported(real_t const x) const;							
+			virtual real_t CDF_small_supported(real_t const x) const;
+			virtual real_t CDF_large_supported(real_t const x) const;
+			virtual void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			virtual void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			virtual void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+			
+			#if PQR_REJECTION_STATS
+			rejection_counter rejections; // Proposals are points in the square, rejected outside the circle (in GetTwo)
+			#endif
+			
+		public:
+			// The distribution is hard-coded; no arguments to supply.
+			standard_normal(): valueCached(false), padding() {}
+			virtual ~standard_normal() {}
+			
+			virtual inline real_t min() const {return -INFINITY;}
+			virtual inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const {return real_t(0);}
+			real_t Variance() const {return real_t(1);}
+			
+			real_t operator()(pqRand::engine& gen) const;
+			virtual two GetTwo(pqRand::engine& gen) const; //!< @brief Sample a pair of variates.
+			
+			#if PQR_REJECTION_STATS
+			//! @brief The statistics of the polar method in GetTwo() (one acceptance per pair) (see \ref PQR_REJECTION_STATS).
+			rejection_stats RejectionStats() const {return rejections.Snapshot();}
+			//! @brief Zero the statistics returned by RejectionStats().
+			void ResetRejectionStats() const {rejections.Reset();}
+			#endif
+			
+			// Redefine Fill to draw two variates at a time, skipping the caching mechanism.
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const;
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the normal distribution (mean \f$ \mu \f$ and 
+	 *  standard deviation \f$ \sigma > 0 \f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = \frac{1}{\sigma\sqrt{2\pi}}
+	 *  \exp\left(-\frac{1}{2\,\sigma^2}(x - \mu)^2\right) \f$
+	 * 
+	 *  \ref normal extends standard_normal by redefining GetTwo() to return 
+	 *  \f$ x = \mu + \sigma\, x_{\mathrm{standard}}^{}  \f$.
+	*/ 
+	class normal : public standard_normal
+	{
+		protected:
+			real_t const mu_;
+			real_t const sigma_;
+			
+			virtual real_t PDF_supported(real_t const x) const;
+			virtual real_t CDF_small_supported(real_t const x) const;
+			virtual real_t CDF_large_supported(real_t const x) const;
+			virtual void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			virtual void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			virtual void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+						
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 * \param mu 	the mean
+			 * \param sigma the standard deviation
+			 * 
+			 * \throws throws std::domain_error if (\p sigma <= 0).
+			*/ 
+			normal(real_t const mu, real_t const sigma);			
+			virtual ~normal() {}
+			
+			real_t Mean() const {return mu_;}
+			real_t Variance() const {return Squared(sigma_);}
+			
+			virtual two GetTwo(pqRand::engine& gen) const;
+			
+			virtual inline real_t Mu() const {return mu_;} //!< The mean
+			virtual inline real_t Sigma() const {return sigma_;} //!< The standard deviation
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the log-normal distribution (the \em log of the variates
+	 *  are normally distributed, with mean \f$ \mu \f$ and standard deviation \f$ \sigma > 0 \f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = \frac{1}{x\,\sigma\sqrt{2\pi}}
+	 *  \exp\left(-\frac{1}{2\,\sigma^2}(\log x - \mu)^2\right) \f$
+	 * 
+	 *  log_normal extends normal by redefining GetTwo() to return 
+	 *  \f$ x = \exp (x_{\mathrm{normal}}^{}) \f$.
+	*/ 
+	class log_normal : public normal
+	{
+		private:
+			real_t const muScale; // Exponentiate mu once, multiply times all returned values
+			// This is done to prevent assumed addition cancellation in 
+			// exp(mu + sigma * x), but is the cancellation actually avoided?
+			
+		protected:
+			real_t PDF_supported(real_t const x) const;
+			real_t CDF_small_supported(real_t const x) const;
+			real_t CDF_large_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 * \param mu 	the mean of the variates' log
+			 * \param sigma 	the standard deviation of the variates' log
+			 * 
+			 * \throws throws std::domain_error if (\p sigma <= 0).
+			*/ 
+			log_normal(real_t const mu, real_t const sigma);
+			
+			inline real_t min() const {return 0;}
+			
+			real_t Mean() const; 
+			real_t Variance() const;
+			
+			two GetTwo(pqRand::engine& gen) const;
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the Weibull distribution
+	 *  (with scale \f$ \lambda > 0 \f$ and shape \f$ k > 0 \f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = \frac{k}{\lambda} \left(\frac{x}{\lambda}\right)^{k-1}
+	 *  \exp\left(-(x/\lambda)^k\right)\f$
+	*/ 
+	class weibull : public distributionQ2
+	{
+		private:
+			static_dist::weibull const kernel; // The sampler and the math (see static_dist::weibull)
+		
+		protected:
+			// Checked PDF/CDF (16.12.2017 @ 11:39)
+			real_t PDF_supported(real_t const x) const;								
+			real_t CDF_small_supported(real_t const x) const;
+			real_t CDF_large_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+			void Q_small_array(real_t const* const u, real_t* const x, size_t const n) const;
+			void Q_large_array(real_t const* const u, real_t* const x, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param lambda 	the scale
+			 *  \param k 	the shape
+			 * 
+			 *  \throws throws std::domain_error if either parameter is non-positive.
+			*/ 
+			weibull(real_t const lambda, real_t const k);
+			
+			inline real_t min() const {return 0;}
+			inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const;
+			real_t Variance() const;
+			
+			inline real_t Lambda() const {return kernel.Lambda();} //!< The scale parameter.
+			inline real_t k() const {return kernel.k();} //!< The shape parameter.
+			
+			real_t Q_small(real_t const u) const final;
+			real_t Q_large(real_t const u) const final;
+			using distributionQ2::Q_small; // Expose the array overloads
+			using distributionQ2::Q_large;
+			
+			real_t operator()(pqRand::engine& gen) const final; // The flip-flop, without virtual calls
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const final;
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Sample the Pareto distribution (with minimum value 
+	 *  \f$ x_\text{min}^{} > 0 \f$ and index \f$ \alpha > 0 \f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = (\alpha\,x_\text{min}^\alpha)/(x^{\alpha  + 1}) \f$
+	 * 
+	 *  \note This distribution has an invertible CDF, but it only becomes ill-conditioned 
+	 *  in one tail \f$(u\to 0)\f$, so we don't need a quantile flip-flop.
+	 *  However, we still need to use uneven \f$ U(0, 1] \f$.
+	*/ 
+	class pareto : public distributionCDF
+	{
+		private:
+			static_dist::pareto const kernel; // The sampler and the math (see static_dist::pareto)
+						
+		protected:
+			real_t PDF_supported(real_t const x) const;
+			real_t CDF_small_supported(real_t const x) const;
+			real_t CDF_large_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param xMin 	the minimum value
+			 *  \param k 	the Pareto index
+			 * 
+			 *  \throws throws std::domain_error if either parameter is non-positive.
+			*/ 
+			pareto(real_t const xMin, real_t const alpha);
+			
+			inline real_t min() const {return kernel.min();}
+			inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const;
+			real_t Variance() const;
+			
+			real_t operator()(pqRand::engine& gen) const final;
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const final;
+			
+			inline real_t Alpha() const {return kernel.Alpha();} //!< The Pareto index
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief Sample the exponential distribution 
+	 *  (with rate parameter \f$ \lambda > 0 \f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = \lambda \exp(-\lambda\,x) \f$
+	*/
+	class exponential : public distributionQ2
+	{
+		private:
+			static_dist::exponential const kernel; // The sampler and the math (see static_dist::exponential)
+			
+		protected:
+			real_t PDF_supported(real_t const x) const;
+			real_t CDF_small_supported(real_t const x) const;
+			real_t CDF_large_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+			void Q_small_array(real_t const* const u, real_t* const x, size_t const n) const;
+			void Q_large_array(real_t const* const u, real_t* const x, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's rate parameter \p lambda.
+			 *  
+			 *  \throws throws std::domain_error if (\p lambda <= 0).
+			*/ 
+			exponential(real_t const lambda);
+			
+			inline real_t min() const {return 0;}
+			inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const {return kernel.Mean();}
+			real_t Variance() const {return kernel.Variance();}
+							
+			real_t Q_small(real_t const u) const final;
+			real_t Q_large(real_t const u) const final;
+			using distributionQ2::Q_small; // Expose the array overloads
+			using distributionQ2::Q_large;
+			
+			real_t operator()(pqRand::engine& gen) const final; // The flip-flop, without virtual calls
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const final;
+			
+			inline real_t Lambda() const {return kernel.Lambda();} //!< The rate parameter
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief Sample the logistic distribution 
+	 *  (with mean \f$ \mu \f$ and scale \f$ s > 0 \f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = \left(4s\,\cosh^2\left(\frac{x-\mu}{2s}\right)\right)^{-1} \f$
+	*/
+	class logistic : public distributionQ2
+	{
+		private:
+			static_dist::logistic const kernel; // The sampler and the math (see static_dist::logistic)
+			
+		protected:
+			// Checked PDF/CDF (16.12.2017 @ 11:44)
+			real_t PDF_supported(real_t const x) const;
+			real_t CDF_small_supported(real_t const x) const;
+			real_t CDF_large_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+			void Q_small_array(real_t const* const u, real_t* const x, size_t const n) const;
+			void Q_large_array(real_t const* const u, real_t* const x, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param mu 	the mean
+			 *  \param s 	the scale
+			 *  
+			 *  \throws throws std::domain_error if the (\p scale <= 0).
+			*/ 
+			logistic(real_t const mu, real_t const s);
+			
+			inline real_t min() const {return -INFINITY;}
+			inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const {return kernel.Mean();}
+			real_t Variance() const {return kernel.Variance();}
+							
+			real_t Q_small(real_t const u) const final;
+			real_t Q_large(real_t const u) const final;
+			using distributionQ2::Q_small; // Expose the array overloads
+			using distributionQ2::Q_large;
+			
+			real_t operator()(pqRand::engine& gen) const final; // The flip-flop, without virtual calls
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const final;
+			
+			inline real_t Mu() const {return kernel.Mu();} //!< The mean
+			inline real_t s() const {return kernel.s();} //!< The scale
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief Sample the log-logistic distribution 
+	 *  (with scale \f$ \alpha > 0 \f$ and shape \f$ \beta > 0\f$).
+	 * 
+	 *  \f$ \text{PDF}(x) = \frac{(\beta/\alpha)(x/\alpha)^{\beta-1}}{(1+(x/\alpha)^\beta)^2} \f$
+	*/
+	class log_logistic : public distributionQ2
+	{
+		private:
+			static_dist::log_logistic const kernel; // The sampler and the math (see static_dist::log_logistic)
+			
+		protected:
+			real_t PDF_supported(real_t const x) const;
+			real_t CDF_small_supported(real_t const x) const;				
+			real_t CDF_large_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const;
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const;
+			void Q_small_array(real_t const* const u, real_t* const x, size_t const n) const;
+			void Q_large_array(real_t const* const u, real_t* const x, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param alpha 	the scale
+			 *  \param beta 	the shape
+			 *  
+			 *  \throws throws std::domain_error if either parameter is non-positive.
+			*/ 
+			log_logistic(real_t const alpha, real_t const beta);
+			
+			inline real_t min() const {return 0;}
+			inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const;
+			real_t Variance() const;
+			
+			real_t Q_small(real_t const u) const final;
+			real_t Q_large(real_t const u) const final;
+			using distributionQ2::Q_small; // Expose the array overloads
+			using distributionQ2::Q_large;
+			
+			real_t operator()(pqRand::engine& gen) const final; // The flip-flop, without virtual calls
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const final;
+							
+			inline real_t Alpha() const {return kernel.Alpha();} //!< The scale
+			inline real_t Beta() const {return kernel.Beta();} //!< The shape
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief Tables of both quantile functions of a continuous distribution, 
+	 *  built by numerically inverting its CDF (the helper of \ref inverted_cdf).
+	 * 
+	 *  Q_small() is tabulated from the CDF and Q_large() from the complementary CDF,
+	 *  each over \f$ u \in [2^{-1022}, 1/2] \f$, so both tails are precise 
+	 *  (as in the flip-flop of \ref distributionQ2).
+	 *  Every binade of u, \f$ [2^e, 2^{e+1}) \f$, is split into \f$ 2^k \f$ equal pieces
+	 *  (with k chosen per binade), so a value's piece is read from its exponent and 
+	 *  its top k mantissa bits, without a search. Each piece is the polynomial of degree 
+	 *  (\ref order - 1) which interpolates x(u) at the piece's Chebyshev points, 
+	 *  whose quantiles are found exactly (by bisection of the CDF).
+	 *  This is the method of
+	 *  > Derflinger, G., Hörmann, W. and Leydold, J. "Random variate generation by numerical inversion 
+	 *  > when only the density is known," ACM Transactions on Modeling and Computer Simulation, Vol. 20 (2010)
+	 *  but with a relative u-resolution, which is the same in every binade.
+	 *  
+	 *  A binade is split until the u-error between the Chebyshev points of each piece, 
+	 *  \f$ |\text{CDF}(\hat{Q}(u)) - u| \f$, is at most \p uResolution \f$ \times\, u \f$
+	 *  (beyond the u-error of moving x by 2 ulp, which dominates deep in a tail or near a finite bound;
+	 *  between the test points, the polynomial's rounding can miss the exact quantile by a few ulp).
+	 *  The split stops early where halving the pieces does not halve the error 
+	 *  (because of the CDF's own rounding error, or where the quantile function is not smooth, 
+	 *  e.g. the PDF is discontinuous), or at \f$ 2^{\text{maxLog2Pieces}} \f$ pieces,
+	 *  and MaxError() reports the u-error reached.
+	 *  
+	 *  \note Building the tables takes ~1000 CDF evaluations per piece
+	 *  (a smooth distribution needs \f$ 10^4 \f$ pieces at a resolution of \f$ 10^{-12} \f$, 
+	 *  so construction takes about a second and the tables about 1 MB).
+	 *  
+	 *  \anchor table_files
+	 *  The tables (and those of \ref discrete) can be written to a versioned binary file by Write(),
+	 *  then memory-mapped read-only by the constructor which takes a file path, 
+	 *  so a job restarted with the same distribution pays no construction time, 
+	 *  and every process on a node shares the same pages. A file records its table's key 
+	 *  (the material the table was built from, not a hash of it): the distribution's type (its \c typeid), 
+	 *  \p uResolution, the exact quantiles at \f$ u = 2^{-1}, 2^{-8}, 2^{-64}, 2^{-512} \f$ in each tail 
+	 *  (which depend on every parameter), and the caller's \p parameters 
+	 *  (for \ref discrete, the weights). A file which is missing, of an older version, 
+	 *  written by a machine of different byte order or word size, or whose key differs in any byte 
+	 *  is not used; the table is built instead (and written over the file).
+	 *  \p parameters is required, because two distributions of the same type whose quantiles agree 
+	 *  at those eight points would otherwise share a file (and the table cannot ask the distribution). 
+	 *  An empty string is an explicit claim that every parameter visibly moves those quantiles.
+	 *  Files are replaced by renaming a complete temporary file, 
+	 *  so jobs reading them at the same time never see a partial table.
+	 *  Copies of a table share the same (immutable) storage.
+	*/
+	class quantile_table
+	{
+		public:
+			//! @brief The number of coefficients of each piece (one 64-byte cache line).
+			static constexpr size_t order = 8;
+			
+		private:
+			// The pieces of one binade
+			struct binade
+			{
+				uint32_t first; // The index of the binade's first piece
+				uint32_t shift; // The mantissa bits below the piece index (52 - k)
+				real_t sScale; // 2**(1 - shift), to map those bits to 2 t in [0, 2)
+			};
+			
+			// The table of one quantile function (in storage)
+			struct tail
+			{
+				binade const* binades; // numBinades, from [1/4, 1/2) downwards
+				real_t const* coefficients; // Each piece's x(s) = c0 + s*(c1 + ...), with s = 2t - 1 in [-1, 1)
+				size_t numPieces;
+				real_t xHalf; // x(1/2)
+				real_t xMinU; // x(minU)
+			};
+			
+			tail smallTail; // Q_small, from the CDF
+			tail largeTail; // Q_large, from the complementary CDF
+			real_t maxError; // The largest relative u-error at the tested points
+			std::string key; // Identifies the distribution and uResolution in a table file (see Key())
+			std::shared_ptr<void const> storage; // Owns the tables (built in memory, or a mapped file)
+			
+			static void Build(std::vector<binade>& binades, std::vector<real_t>& coefficients, tail& table, 
+				distributionCDF const& dist, bool const large, real_t const uResolution, real_t& maxError);
+			void BuildTables(distributionCDF const& dist, real_t const uResolution);
+			bool Map(std::string const& filePath); // True if the file holds this table (and it was mapped)
+			static std::string Key(distributionCDF const& dist, real_t const uResolution, std::string const& parameters);
+			static real_t Evaluate(tail const& table, real_t const u);
+			
+		public:
+			//! @brief The smallest u in either table (a smaller u is clamped to it).
+			static constexpr real_t minU = std::numeric_limits<real_t>::min();
+			
+			//! @brief The number of binades of u in either table (\f$ [2^{-1022}, 1/2] \f$).
+			static constexpr size_t numBinades = 1021;
+			
+			//! @brief The most pieces in one binade (as a power of 2).
+			static constexpr size_t maxLog2Pieces = 16;
+			
+			quantile_table(): smallTail(), largeTail(), maxError(0), key() {}
+			~quantile_table(); // Out-of-line (it frees the key and storage; inlining it only bloats the caller)
+			
+			/*! @brief Tabulate both quantile functions of \p dist.
+			 * 
+			 *  \param dist 	a continuous distribution (only used during construction)
+			 *  \param uResolution 	the relative u-error allowed in each tail
+			 * 
+			 *  \throws throws std::domain_error unless (0 < \p uResolution < 1).
+			*/ 
+			quantile_table(distributionCDF const& dist, real_t const uResolution);
+			
+			/*! @brief Map the tables from a table file (see \ref table_files), 
+			 *  if the file holds the tables of \p dist at \p uResolution; 
+			 *  otherwise build the tables and write them to the file.
+			 * 
+			 *  \param dist 	a continuous distribution (only used during construction)
+			 *  \param uResolution 	the relative u-error allowed in each tail
+			 *  \param filePath 	the table file
+			 *  \param parameters 	\p dist's parameters, in any exact form 
+			 *  (e.g. their bytes, or printed to 17 digits), added to the file's key (see \ref table_files)
+			 * 
+			 *  \throws throws std::domain_error unless (0 < \p uResolution < 1), 
+			 *  or std::ofstream::failure if the tables must be built, but the file cannot be written.
+			*/ 
+			quantile_table(distributionCDF const& dist, real_t const uResolution, std::string const& filePath, 
+				std::string const& parameters);
+			
+			/*! @brief Write the tables to a file (see \ref table_files).
+			 *  
+			 *  \warning Replaces the file without warning (but never leaves it partially written).
+			 *  
+			 *  \throws throws std::ofstream::failure if the file cannot be written.
+			*/ 
+			void Write(std::string const& filePath) const;
+			
+			//! @brief The tabulated Q_small (\p u in (0, 1); for u > 1/2, Q_large(1 - u)).
+			real_t Q_small(real_t const u) const;
+			//! @brief The tabulated Q_large (\p u in (0, 1); for u > 1/2, Q_small(1 - u)).
+			real_t Q_large(real_t const u) const;
+			
+			/*! @brief The exact quantile of \p u in the small-value tail (the smallest x with CDF(x) >= u),
+			 *  found by bisection over every real_t in [min, max] (at most 64 CDF evaluations).
+			*/ 
+			static real_t Invert_small(distributionCDF const& dist, real_t const u);
+			//! @brief The exact quantile of \p u in the large-value tail (the smallest x with CompCDF(x) <= u).
+			static real_t Invert_large(distributionCDF const& dist, real_t const u);
+			
+			//! @brief The total number of pieces (each occupies \ref order real_t).
+			size_t Size() const {return smallTail.numPieces + largeTail.numPieces;}
+			//! @brief The largest relative u-error measured while building the tables (beyond rounding x).
+			real_t MaxError() const {return maxError;}
+	};
+	
+	/*! @brief Sample any continuous distribution with a CDF by numerical inversion,
+	 *  using a \ref quantile_table for Q_small() and Q_large().
+	 * 
+	 *  This turns a \ref distributionCDF which lacks analytic quantile functions 
+	 *  into a \ref distributionQ2, whose variates cost a table lookup and a polynomial of degree 7 
+	 *  (instead of e.g. a rejection loop). The PDF, CDF, mean and variance are the original distribution's.
+	 *  The tables cover \f$ u \ge 2^{-1022} \f$; smaller u (of probability below \f$ 2^{-1022} \f$) 
+	 *  are inverted exactly (by quantile_table::Invert_small/Invert_large).
+	 *  
+	 *  \param dist_t 	the distribution (derived from \ref distributionCDF), of which this holds a copy
+	*/
+	template<class dist_t>
+	class inverted_cdf : public distributionQ2
+	{
+		private:
+			dist_t const dist;
+			quantile_table const table;
+			
+			static_assert(std::is_base_of<distributionCDF, dist_t>::value, 
+				"pqRand::inverted_cdf: dist_t must derive from pqRand::distributionCDF");
+		
+		protected:
+			real_t PDF_supported(real_t const x) const {return dist.PDF(x);}
+			real_t CDF_small_supported(real_t const x) const {return dist.CDF(x);}
+			real_t CDF_large_supported(real_t const x) const {return dist.CompCDF(x);}
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const {dist.PDF(x, pdf, n);}
+			void CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const {dist.CDF(x, cdf, n);}
+			void CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const {dist.CompCDF(x, ccdf, n);}
+			
+			void Q_small_array(real_t const* const u, real_t* const x, size_t const n) const
+			{
+				for(size_t i = 0; i < n; ++i)
+					x[i] = inverted_cdf::Q_small(u[i]);
+			}
+			
+			void Q_large_array(real_t const* const u, real_t* const x, size_t const n) const
+			{
+				for(size_t i = 0; i < n; ++i)
+					x[i] = inverted_cdf::Q_large(u[i]);
+			}
+			
+		public:
+			/*! @brief Tabulate the quantile functions of \p dist_in (see \ref quantile_table).
+			 * 
+			 *  \param dist_in 	the distribution to sample
+			 *  \param uResolution 	the relative u-error allowed in each tail
+			 * 
+			 *  \throws throws std::domain_error unless (0 < \p uResolution < 1).
+			*/ 
+			explicit inverted_cdf(dist_t const& dist_in, real_t const uResolution = real_t(1e-12)):
+				dist(dist_in), table(dist, uResolution) {}
+			
+			/*! @brief Map the tables of \p dist_in from a table file, or build them and write the file
+			 *  (see \ref table_files).
+			 * 
+			 *  \param dist_in 	the distribution to sample
+			 *  \param filePath 	the table file
+			 *  \param parameters 	the parameters of \p dist_in, added to the file's key 
+			 *  (see quantile_table's constructor)
+			 *  \param uResolution 	the relative u-error allowed in each tail
+			 * 
+			 *  \throws throws std::domain_error unless (0 < \p uResolution < 1), 
+			 *  or std::ofstream::failure if the tables must be built, but the file cannot be written.
+			*/ 
+			inverted_cdf(dist_t const& dist_in, std::string const& filePath, std::string const& parameters, 
+				real_t const uResolution = real_t(1e-12)):
+				dist(dist_in), table(dist, uResolution, filePath, parameters) {}
+			
+			inline real_t min() const {return dist.min();}
+			inline real_t max() const {return dist.max();}
+			
+			real_t Mean() const {return dist.Mean();}
+			real_t Variance() const {return dist.Variance();}
+			
+			real_t Q_small(real_t const u) const
+			{
+				return (u >= quantile_table::minU) ? table.Q_small(u) : quantile_table::Invert_small(dist, u);
+			}
+			
+			real_t Q_large(real_t const u) const
+			{
+				return (u >= quantile_table::minU) ? table.Q_large(u) : quantile_table::Invert_large(dist, u);
+			}
+			
+			using distributionQ2::Q_small; // Expose the array overloads
+			using distributionQ2::Q_large;
+			
+			// The flip-flop, without virtual calls (the same draws as distributionQ2::operator())
+			real_t operator()(pqRand::engine& gen) const
+			{
+				if(gen.RandBool())
+					return inverted_cdf::Q_small(gen.HalfU_uneven());
+				else
+					return inverted_cdf::Q_large(gen.HalfU_uneven());
+			}
+			
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
+			{
+				for(size_t i = 0; i < sampleSize; ++i)
+					sample[i] = inverted_cdf::operator()(gen);
+			}
+			
+			inline dist_t const& Distribution() const {return dist;} //!< The original distribution.
+			inline quantile_table const& Table() const {return table;} //!< The quantile tables.
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief A \ref distributionCDF truncated to the window [lo, hi], sampled by inversion (not rejection).
+	 * 
+	 *  The flip-flop's \ref engine::HalfU_uneven "HalfU_uneven" is mapped into the window's 
+	 *  probability, measured from the window's edge in the chosen tail, then fed to the parent's 
+	 *  Q_small or Q_large, whichever keeps the precise tail (the parent's probability 
+	 *  at the edge nearest to x plus a fraction of the window's probability). 
+	 *  So a variate costs O(1) however deep in a tail the window is 
+	 *  (where rejection would waste almost every draw), and an untruncated 
+	 *  window samples exactly the parent's variates. 
+	 *  Fill() maps a chunk of draws at once, then calls the parent's array quantile functions.
+	 *  
+	 *  A parent without quantile functions (a \ref distributionCDF which is not a \ref distributionQ2, 
+	 *  e.g. \ref normal) is inverted exactly by quantile_table::Invert_small and Invert_large 
+	 *  (a bisection of its CDF, ~64 evaluations per variate). Where that is too slow, 
+	 *  truncate its \ref inverted_cdf instead (e.g. <tt> truncated<inverted_cdf<normal>> </tt>), 
+	 *  whose tables invert the CDF to a u-resolution of 1e-12.
+	 *  
+	 *  The window's probability is found without cancellation (using CompCDF above the median),
+	 *  but a window narrower than the rounding of the parent's CDF at its edges 
+	 *  (e.g. a few ulp of x) cannot be resolved.
+	 *  The mean and variance are those of the parent if the window covers its support, 
+	 *  otherwise they are integrated numerically (tanh-sinh quadrature of the quantile function) 
+	 *  during construction.
+	 *  
+	 *  \param dist_t 	the parent distribution (derived from \ref distributionCDF), of which this holds a copy
+	*/
+	template<class dist_t>
+	class truncated : public distributionQ2
+	{
+		private:
+			dist_t const dist;
+			real_t const xMin; // The window, within the parent's support
+			real_t const xMax;
+			real_t const cdfMin; // The parent's CDF(xMin)
+			real_t const ccdfMax; // The parent's CompCDF(xMax)
+			real_t const mass; // The parent's probability in the window
+			real_t mean;
+			real_t variance;
+			
+			static_assert(std::is_base_of<distributionCDF, dist_t>::value, 
+				"pqRand::truncated: dist_t must derive from pqRand::distributionCDF");
+			
+			// Whether the parent has quantile functions (std::true_type) or is inverted by bisection
+			typedef std::is_base_of<distributionQ2, dist_t> parentQ2;
+			
+			real_t ParentQuantile(bool const large, real_t const u, std::true_type) const
+			{
+				return large ? dist.Q_large(u) : dist.Q_small(u);
+			}
+			
+			real_t ParentQuantile(bool const large, real_t const u, std::false_type) const
+			{
+				return large ? quantile_table::Invert_large(dist, u) : quantile_table::Invert_small(dist, u);
+			}
+			
+			// The parent's quantiles of an array (in place)
+			void ParentQuantiles(bool const large, real_t* const u, size_t const n, std::true_type) const
+			{
+				if(large)
+					dist.Q_large(u, u, n);
+				else
+					dist.Q_small(u, u, n);
+			}
+			
+			void ParentQuantiles(bool const large, real_t* const u, size_t const n, std::false_type) const
+			{
+				for(size_t i = 0; i < n; ++i)
+					u[i] = ParentQuantile(large, u[i], std::false_type());
+			}
+			
+			// The parent's probability in [a, b], without cancellation
+			static real_t ParentProbability(dist_t const& parent, real_t const a, real_t const b)
+			{
+				real_t const ccdf_a = parent.CompCDF(a);
+				if(ccdf_a <= real_t(0.5)) return ccdf_a - parent.CompCDF(b);
+				
+				real_t const cdf_b = parent.CDF(b);
+				if(cdf_b <= real_t(0.5)) return cdf_b - parent.CDF(a);
+				
+				return (real_t(0.5) - parent.CDF(a)) + (real_t(0.5) - parent.CompCDF(b));
+			}
+			
+			static real_t CheckMass(real_t const windowMass)
+			{
+				if(not (windowMass > real_t(0)))
+					throw std::domain_error("pqRand::truncated: the window must have a non-zero probability");
+				return windowMass;
+			}
+			
+			/* Map this distribution's Q_small(u) (fromLarge = false) or Q_large(u) to the parent's quantile,
+			 * returning the u to feed to the parent's Q_large (large = true) or Q_small.
+			 * The parent's probability from the window's edge in that tail is (edge + u * mass), 
+			 * unless it exceeds 1/2, in which case the other tail is measured from the other edge.
+			*/
+			real_t ParentU(bool const fromLarge, real_t const u, bool& large) const
+			{
+				real_t const near = (fromLarge ? ccdfMax : cdfMin) + u * mass;
+				large = fromLarge;
+				
+				if(near <= real_t(0.5)) return near;
+				
+				large = not fromLarge;
+				return (fromLarge ? cdfMin : ccdfMax) + (real_t(1) - u) * mass;
+			}
+			
+			real_t ParentQ(bool const fromLarge, real_t const u) const
+			{
+				bool large;
+				real_t const parentU = ParentU(fromLarge, u, large);
+				
+				// Rounding can step just outside the window
+				return std::min(std::max(ParentQuantile(large, parentU, parentQ2()), xMin), xMax);
+			}
+			
+			/* The integral of f(Q_small(u)) + f(Q_large(u)) over u in (0, 1/2), i.e. of f(Q(u)) over (0, 1),
+			 * by the tanh-sinh rule (u = w/2 with w = 1/(1 + exp(-pi sinh(t))), whose nodes reach u ~ 1e-300, 
+			 * so an unbounded quantile's singularity at u = 0 is integrated accurately)
+			*/
+			template<class integrand_t>
+			real_t Integrate(integrand_t const& f) const
+			{
+				real_t constexpr step = real_t(1)/real_t(32);
+				real_t constexpr tMax = real_t(6.5);
+				real_t sum = real_t(0);
+				
+				for(real_t t = -tMax; t <= tMax; t += step)
+				{
+					real_t const piSinh = real_t(M_PI) * std::sinh(t);
+					real_t const w = real_t(1) / (real_t(1) + std::exp(-piSinh));
+					real_t const wComp = real_t(1) / (real_t(1) + std::exp(piSinh)); // 1 - w, without cancellation
+					real_t const weight = real_t(M_PI) * std::cosh(t) * w * wComp;
+					
+					if(w > real_t(0))
+						sum += weight * (f(ParentQ(false, real_t(0.5) * w)) + f(ParentQ(true, real_t(0.5) * w)));
+				}
+				
+				return real_t(0.5) * step * sum;
+			}
+			
+		protected:
+			real_t PDF_supported(real_t const x) const {return dist.PDF(x) / mass;}
+			real_t CDF_small_supported(real_t const x) const {return ParentProbability(dist, xMin, x) / mass;}
+			real_t CDF_large_supported(real_t const x) const {return ParentProbability(dist, x, xMax) / mass;}
+			
+			void Q_small_array(real_t const* const u, real_t* const x, size_t const n) const
+			{
+				for(size_t i = 0; i < n; ++i)
+					x[i] = ParentQ(false, u[i]);
+			}
+			
+			void Q_large_array(real_t const* const u, real_t* const x, size_t const n) const
+			{
+				for(size_t i = 0; i < n; ++i)
+					x[i] = ParentQ(true, u[i]);
+			}
+			
+		public:
+			/*! @brief Truncate \p dist_in to [\p lo, \p hi] (intersected with its support).
+			 * 
+			 *  \param dist_in 	the parent distribution
+			 *  \param lo 	the lower edge of the window (e.g. -INFINITY)
+			 *  \param hi 	the upper edge of the window (e.g. INFINITY)
+			 * 
+			 *  \throws throws std::domain_error unless the window has a non-zero probability 
+			 *  (e.g. if \p lo >= \p hi).
+			*/ 
+			truncated(dist_t const& dist_in, real_t const lo, real_t const hi):
+				dist(dist_in), 
+				xMin(std::max(lo, dist.min())), xMax(std::min(hi, dist.max())),
+				cdfMin(dist.CDF(xMin)), ccdfMax(dist.CompCDF(xMax)),
+				mass(CheckMass((xMin < xMax) ? ParentProbability(dist, xMin, xMax) : real_t(0)))
+			{
+				if((xMin <= dist.min()) and (xMax >= dist.max()))
+				{
+					mean = dist.Mean();
+					variance = dist.Variance();
+				}
+				else
+				{
+					mean = Integrate([](real_t const x) {return x;});
+					
+					real_t const center = mean;
+					variance = Integrate([center](real_t const x) {return Squared(x - center);});
+				}
+			}
+			
+			inline real_t min() const {return xMin;}
+			inline real_t max() const {return xMax;}
+			
+			real_t Mean() const {return mean;}
+			real_t Variance() const {return variance;}
+			
+			real_t Q_small(real_t const u) const {return ParentQ(false, u);}
+			real_t Q_large(real_t const u) const {return ParentQ(true, u);}
+			using distributionQ2::Q_small; // Expose the array overloads
+			using distributionQ2::Q_large;
+			
+			// The flip-flop, without virtual calls (the same draws as distributionQ2::operator())
+			real_t operator()(pqRand::engine& gen) const
+			{
+				bool const fromLarge = not gen.RandBool();
+				return ParentQ(fromLarge, gen.HalfU_uneven());
+			}
+			
+			/*! @brief Redefine Fill to map a chunk of draws into the window, 
+			 *  then evaluate the parent's quantiles an array at a time (see distributionQ2::Q_small).
+			 *  
+			 *  The random numbers are drawn in the same order as operator(), 
+			 *  so the sample is that of repeated calls to operator(), 
+			 *  to within the difference between the parent's array and scalar quantiles (a few ulp).
+			*/ 
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
+			{
+				real_t parentU[2][arrayChunk]; // The u fed to the parent's Q_small [0] and Q_large [1]
+				bool large[arrayChunk];
+				
+				for(size_t begin = 0; begin < sampleSize; begin += arrayChunk)
+				{
+					size_t const n = std::min(arrayChunk, sampleSize - begin);
+					size_t count[2] = {0, 0};
+					
+					for(size_t i = 0; i < n; ++i)
+					{
+						bool const fromLarge = not gen.RandBool();
+						real_t const u = ParentU(fromLarge, gen.HalfU_uneven(), large[i]);
+						parentU[large[i]][count[large[i]]++] = u;
+					}
+					
+					ParentQuantiles(false, parentU[0], count[0], parentQ2());
+					ParentQuantiles(true, parentU[1], count[1], parentQ2());
+					
+					// Put each variate back in the order it was drawn
+					count[0] = count[1] = 0;
+					for(size_t i = 0; i < n; ++i)
+						sample[begin + i] = std::min(std::max(parentU[large[i]][count[large[i]]++], xMin), xMax);
+				}
+			}
+			
+			inline dist_t const& Distribution() const {return dist;} //!< The parent distribution.
+			inline real_t Probability() const {return mass;} //!< The parent's probability in the window.
+	};
+	
+	/*! @brief Sample the gamma distribution 
+	 *  (with rate \f$ \lambda > 0 \f$ and shape \f$ k > 1 \f$), 
+	 *  the sum of \f$ k \f$ \ref exponential distributions with rate \f$ \lambda \f$.
+	 * 
+	 *  \f$ \text{PDF}(x) = \frac{\lambda^k}{\Gamma(k)}x^{k-1}\exp(-\lambda\,x) \f$
+	 * 
+	 *  This class uses the rejection sampling scheme proposed in
+	 *  > Cheng, R.C.H. "The generation of gamma variables with non-integral shape parameter,"
+	 *  > Journal of the Royal Statistical Socieity C, Vol. 26 (1977)
+	 *  which samples a \f$ \lambda = 1 \f$ gamma distribution
+	 *  using a special log_logistic as a proposal distribution.
+	 *  The \f$ \lambda = 1 \f$ variates are internally scaled to 
+	 *  any \f$ \lambda \f$ by redefining the timescale (if \f$ \lambda = 10 \f$, 
+	 *  the \f$ \lambda = 1 \f$ variates are downscaled by 10).
+	 * 
+	 *  \note This class is named gammaDist (instead of simply \p gamma)
+	 *  to prevent confusion with the gamma function.
+	*/
+	class gammaDist : public distributionPDF
+	{
+		private:
+			real_t const lambda_;
+			real_t const k_;
+			log_logistic const proposal;
+			real_t const lambda2k;
+			real_t const logGamma_k;
+			
+			#if PQR_REJECTION_STATS
+			rejection_counter rejections; // Proposals come from the log_logistic proposal distribution
+			#endif
+			
+			// Should the x from the proposal distribution be rejected?
+			bool Reject(real_t const x, pqRand::engine& gen) const;
+			
+		protected:
+			real_t PDF_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param lambda 	the rate
+			 *  \param k 	the shape
+			 *  
+			 *  \throws throws std::domain_error if (\p lambda <= 0) or (\p k <= 1)
+			*/ 
+			gammaDist(real_t const lambda, real_t const k);
+			
+			inline real_t min() const {return 0;}
+			inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const {return k_ / lambda_;}
+			real_t Variance() const {return k_ / Squared(lambda_);}
+			
+			real_t operator()(pqRand::engine& gen) const;
+			
+			inline real_t Lambda() const {return lambda_;} //!< The rate
+			inline real_t k() const {return k_;} //!< The shape
+			
+			#if PQR_REJECTION_STATS
+			//! @brief The statistics of Cheng's rejection sampler (see \ref PQR_REJECTION_STATS).
+			rejection_stats RejectionStats() const {return rejections.Snapshot();}
+			//! @brief Zero the statistics returned by RejectionStats().
+			void ResetRejectionStats() const {rejections.Reset();}
+			#endif
+	};	
+	
+	/*! @brief Sample the gamma distribution 
+	 *  (with rate \f$ \lambda > 0 \f$ and \em any shape \f$ k > 0 \f$), 
+	 *  using the rejection method of Marsaglia and Tsang.
+	 * 
+	 *  \f$ \text{PDF}(x) = \frac{\lambda^k}{\Gamma(k)}x^{k-1}\exp(-\lambda\,x) \f$
+	 * 
+	 *  This class uses the rejection sampling scheme proposed in
+	 *  > Marsaglia, G. and Tsang, W.W. "A simple method for generating gamma variables,"
+	 *  > ACM Transactions on Mathematical Software, Vol. 26 (2000)
+	 *  which transforms a \ref standard_normal variate \f$ x \f$ into 
+	 *  \f$ d\,v = d\,(1 + c\,x)^3 \f$ (with \f$ d = k - 1/3 \f$ and \f$ c = 1/\sqrt{9d} \f$), 
+	 *  which is accepted with very high probability (> 95% for all \f$ k \geq 1 \f$).
+	 *  A cheap squeeze test accepts most proposals without evaluating a \c log.
+	 *  The uniform variate of the acceptance test is uneven (engine::U_uneven).
+	 * 
+	 *  When \f$ k < 1 \f$, we sample shape \f$ k + 1 \f$, then "boost" the variate
+	 *  by \f$ U^{1/k} \f$. Using an uneven \f$ U \f$ keeps the small-value tail precise
+	 *  (which is where the variates concentrate when \f$ k < 1 \f$).
+	 *  
+	 *  Compared to \ref gammaDist (Cheng's method), there are fewer rejections,
+	 *  and each proposal is cheaper (no \c pow in the proposal or the acceptance test).
+	 *  
+	 *  \note Like standard_normal, operator() caches the second normal of each pair 
+	 *  (in a mutable member), so use a separate object per thread. 
+	 *  Fill() draws exactly the variates of repeated calls to operator().
+	*/
+	class gammaDist_MarsagliaTsang : public distributionPDF
+	{
+		private:
+			real_t const lambda_;
+			real_t const k_;
+			real_t const d; // (k - 1/3), for the shape actually sampled
+			real_t const c; // 1/sqrt(9 d)
+			real_t const kRecip;
+			real_t const lambda2k;
+			real_t const logGamma_k;
+			standard_normal const normal_;
+			bool const boost; // k < 1, so sample k + 1 and boost by U**(1/k)
+			char padding[sizeof(real_t) - sizeof(bool)]; // Explicit, so -Wpadded stays quiet
+			
+			#if PQR_REJECTION_STATS
+			rejection_counter rejections; // Proposals are normal variates
+			#endif
+			
+			// Test the proposal x (a standard normal variate); if it is accepted, 
+			// store the (unit-rate, un-boosted) gamma variate in variate.
+			bool Accept(real_t const x, pqRand::engine& gen, real_t& variate) const;
+			
+			// Boost (if k < 1) and scale the accepted variate
+			real_t Finalize(real_t const variate, pqRand::engine& gen) const;
+			
+		protected:
+			real_t PDF_supported(real_t const x) const;
+			void PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const;
+			
+		public:
+			/*! @brief Define the distribution's parameters.
+			 * 
+			 *  \param lambda 	the rate
+			 *  \param k 	the shape
+			 *  
+			 *  \throws throws std::domain_error if (\p lambda <= 0) or (\p k <= 0)
+			*/ 
+			gammaDist_MarsagliaTsang(real_t const lambda, real_t const k);
+			
+			inline real_t min() const {return 0;}
+			inline real_t max() const {return INFINITY;}
+			
+			real_t Mean() const {return k_ / lambda_;}
+			real_t Variance() const {return k_ / Squared(lambda_);}
+			
+			real_t operator()(pqRand::engine& gen) const;
+			
+			// Redefine Fill to sample without a virtual call per variate (the same variates as operator()).
+			void Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const;
+			
+			inline real_t Lambda() const {return lambda_;} //!< The rate
+			inline real_t k() const {return k_;} //!< The shape
+			
+			#if PQR_REJECTION_STATS
+			//! @brief The statistics of the rejection sampler (see \ref PQR_REJECTION_STATS).
+			rejection_stats RejectionStats() const {return rejections.Snapshot();}
+			//! @brief Zero the statistics returned by RejectionStats().
+			void ResetRejectionStats() const {rejections.Reset();}
+			#endif
+	};
+	
+	/*! @brief Sample from the normal distribution using the canonical polar method 
+	 *  (lower precision standard_normal).
+	 * 
+	 *  This implementation of Marsaglia polar method is used by 
+	 *  GNU and Numpy, and is included for testing purposes.
+	*/
+	class standard_normal_lowPrecision : public standard_normal
+	{
+		public:
+			standard_normal_lowPrecision():
+				standard_normal() {}
+				
+			virtual ~standard_normal_lowPrecision() {}
+			
+			virtual two GetTwo(pqRand::engine& gen) const;
+	};
+}
+
+#endif
@@ -0,0 +1,1174 @@
+/* pqRand: The precise quantile random package
+ * Copyright (C) 2017 Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ * 
+ * This package is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  
+ * See the COPYRIGHT_NOTICE for more details.
+ * 
+ * Under Section 7 of GPL version 3, you are granted additional
+ * permissions described in the GCC Runtime Library Exception, version
+ * 3.1, as published by the Free Software Foundation.
+ * 
+ * You should have received a copy of the GNU General Public License and
+ * a copy of the GCC Runtime Library Exception along with this package;
+ * see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+ * <http://www.gnu.org/licenses/>.
+*/
+
+/*! @file pqRand.hpp
+ *  @brief Establishes pqRand and defines the PRNG engine needed by distributions
+ * 
+ *  The important methods implemented here are the PRNG seeding class (pqRand::seeded_uPRNG),
+ *  the underlying PRNG (pqRand::xorshift1024_star) its the pqRand::engine which wraps them together.
+ * 
+ *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ *  @date 2017
+*/
+
+#ifndef PQ_RAND
+#define PQ_RAND
+
+#include <limits> // numeric_limits
+#include <array>
+#include <vector>
+#include <random> // mt19937
+#include <stdexcept> // runtime_error
+
+namespace pqRand //! @brief The namespace of the pqRand package
+{	
+	// Declare the @mainpage inside the namespace, so we can use unqualified names
+	// (e.g. xorshift1024_star instead of pqRand::xorshift1024_star)
+	
+	/*! @mainpage 
+	 * 
+	 *  @brief pqRand
+	 *  ==================================================================== 
+	 *  The precise quantile random package \n
+	 *  	https://github.com/keith-pedersen/pqRand \n
+	 *  
+	 *  \verbatim
+							 ____                        _
+		 .o88o. .o88o. |  _ \    __ _   _ __     __| |
+		 8    8 8    8 | |_) |  / _` | | '_ \   / _` |
+		 8    8 8    8 |  _ <  | (_| | | | | | | (_| |
+		 88oo8' `8oo88 |_| \_\  \__,_| |_| |_|  \__,_|
+		 8           8
+		 8           8
+
+		 \endverbatim
+	 * 
+	 *  @version 0.5.0 (beta); Dec 2017
+	 *  @author  Keith Pedersen (Keith.David.Pedersen@gmail.com) \n
+	 *  
+	 *  @copyright 2017 (see COPYRIGHT_NOTICE)
+	 * 
+	 *  Special thanks to Zack Sullivan, Andrew Webster and Sebastiano Vigna.
+	 * 
+	 * 
+	 *  Description
+	 *  --------------------------------------------------------------------
+	 *  
+	 *  This package is designed to provide high-precision samples from the following distributions:
+	 *  	+ \ref uniform
+	 *  	+ \ref normal
+	 *  	+ \ref log_normal "log-normal"
+	 *  	+ \ref exponential
+	 *  	+ \ref weibull
+	 *  	+ \ref pareto
+	 *  	+ \ref logistic
+	 *  	+ \ref log_logistic "log-logistic"
+	 *  	+ \ref gammaDist "gamma" (also \ref gammaDist_MarsagliaTsang "for any shape")
+	 *  	+ \ref discrete "discrete" (categorical, via an alias table; 
+	 *  	also \ref dynamic_discrete "with weights that change between draws")
+	 *  	+ \ref poisson
+	 *  	+ \ref binomial
+	 *  	+ \ref bernoulli (using ~2 random bits per trial)
+	 *    
+	 *  Theory @anchor theory
+	 *  -------
+	 *  In contrast to many existing implementations of random sampling
+	 *  (e.g. C++11's <\b random> suite and \b numpy.random), pqRand can deliver
+	 *  the <i> most precise </i> sample possible with floating point arithmetic.
+	 *  This is done via the improved inversion method described in
+	 *  "Reconditioning your quantile function," https://arxiv.org/abs/1704.07949 (also distributed in doc/).
+	 *  This improved method pairs an uneven uniform variate with the "quantile flip-flop".
+	 *  With parallelization in mind, pqRand's default choice of
+	 *  pseudo-random number generator (PRNG) is \ref xorshift1024_star,
+	 *  which balances a long period with a compact state (so that each thread can have its own PRNG).
+	 *  Nonetheless, the PRNG can be rather easily changed by redefining \ref pqRand::PRNG_t.
+	 * 
+	 *  Many of the distributions distributed with pqRand use the improved inversion method 
+	 *  (i.e. they have an analytic quantile function). 
+	 *  Others, like \ref normal and \ref gammaDist, use rejection sampling
+	 *  The latter demonstrates that pqRand can generate a 
+	 *  maximally precise sample of \em any distribution
+	 *  (given a sufficiently efficient rejection algorithm).
+	 * 
+	 *  Usage
+	 *  --------------------------------------------------------------------
+	 *  1. Create one \ref engine (per thread) to draw random numbers.
+	 *     - "Auto-seed" is highly recommended (see engine::Seed).
+	 *     - The seed can be saved via engine::WriteState be for future audits.
+	 *  2. Create as many distributions as you want.
+	 *  3. Call the distributions like functions, passing the engine as the argument
+	 * 	 (this mimics the API of the C++11 <\b random> suite).
+	 * 
+		\code
+			pqRand::engine gen;  //........................... Create the random engine with auto-seed (default constructor)
+			gen.WriteState("./mySeed.dat");  //............... Save the seed for future auditing
+			pqRand::exponential expo(2);  //.................. Instantiate the distribution
+			
+			auto const one = expo(gen);  //................... Sample one variate 
+			auto const many = expo.GetSample(1e6, gen);  //... Sample many variates
+			
+		\endcode
+	 *  For more examples, see "examples/".
+	 * 
+	 * 
+	 *  Python (pYqRand) @anchor pYqRand
+	 *  -------------------------------------------------------------------
+	 *  \ref pYqRand is the Python version of pqRand. The API is 99% identical to C++, 
+	 *  but is independently documented via docstrings (e.g. Python "help")
+	 *  \code
+			>>> import pYqRand as pqr
+			>>> help(pqr)
+			>>> help(pqr.engine.GetState)
+			>>>
+			>>> #//........................................... Replicate the sample produced by the Usage snippet
+			>>> gen = pqr.engine()
+			>>> gen.Seed_FromFile("./mySeed.dat")  #//........ Re-seed from the stored state
+			>>> expo = pqr.exponential(2.)
+			>>> 
+			>>> one = expo(gen)
+			>>> many = expo.GetSample(1e6, gen)
+		 \endcode
+	 *  The minor differences (due to limitations of the Python language) 
+	 *  are enumerated at the top of \ref pYqRand's docstring.	 * 
+	 * 
+	 *  Features to consider in future versions
+	 *  --------------------------------------------------------------------
+	 *  - If a regular sample of \f$ U \f$ produces numbers with \f$ weight = 1 \f$, 
+	 *    supply a sample of \f$ U \f$ from the tail \f$(u \to 0)\f$,
+	 *    given a supplied \f$ weight \ll 1 \f$.
+	*/
+	 
+	class xorshift1024_star; // Forward declare this generator for the typedef below
+
+	/*! @brief \ref PRNG_t is the PRNG used by \ref engine
+	 * 
+	 *  The existential purpose of the pqRand package requires
+	 *  denying the user the freedom to chose the PRNG at runtime, 
+	 *  since a high-precision sample from a crappy PRNG is not possible.
+	 *  Nonetheless, one can change the hardcoded PRNG by 
+	 *  redefining \ref PRNG_t and rebuilding; provided the replacement satisfies the 
+	 *  \ref prng_requirements "\c prng_t requirements" of seeded_uPRNG.
+	 *  One such candidate is \c std::mt19937_64, which was used as 
+	 *  the model for the seeded_uPRNG API.
+	 * 
+	 *  \warning If PRNG_t is redefined, one may have to change \ref PRNG_CAN_JUMP and \ref PRNG_CAN_FILL
+	 * 
+	 *  The authors of pqRand have carefully chosen xorshift1024_star as the default PRNG,
+	 *  since it has a "large but not too large" period (\f$ 2^{1024} \f$), 
+	 *  excellent uniformity properties, has been rigorously tested by others and 
+	 *  vetted by the authors using the dieharder battery of tests.
+	 *  While \c std::mt19937_64 has equivalent statistics, 
+	 *  its state is too large for massive multi-parallelism.
+	*/
+	
+	/////////////////////////////////////////////////////////////////////
+		
+	typedef xorshift1024_star PRNG_t;
+	#define PRNG_CAN_JUMP 1 //!< Does the PRNG have a Jump() function? See \ref jumping_PRNG
+	#define PRNG_CAN_FILL 1 //!< Does the PRNG have a bulk Fill() function? See \ref buffered_engine
+	
+	/////////////////////////////////////////////////////////////////////
+	
+	//~ typedef std::mt19937_64 PRNG_t;
+	//~ #define PRNG_CAN_JUMP 0 //!< Does the PRNG have a Jump() function? See \ref jumping_PRNG
+	//~ #define PRNG_CAN_FILL 0 //!< Does the PRNG have a bulk Fill() function? See \ref buffered_engine
+	
+	/////////////////////////////////////////////////////////////////////
+	
+	//~ typedef std::mt19937 PRNG_t;
+	//~ #define PRNG_CAN_JUMP 0 //!< Does the PRNG have a Jump() function? See \ref jumping_PRNG
+	//~ #define PRNG_CAN_FILL 0 //!< Does the PRNG have a bulk Fill() function? See \ref buffered_engine
+	
+	/////////////////////////////////////////////////////////////////////
+			
+	//! @brief Typedef the real type to allow experimentation with float/binary32.
+	//~ typedef float real_t;
+	typedef double real_t;
+	
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief Count how the engine spends its entropy (see engine::Stats()).
+	 * 
+	 *  The counters change the layout of \ref engine, so this macro must have 
+	 *  the same value when building libpqr and the programs which use it
+	 *  (e.g. compile both with \c -DPQR_ENGINE_STATS=1).
+	 *  When zero (the default), the counters do not exist, so they cost nothing.
+	*/
+	#ifndef PQR_ENGINE_STATS
+		#define PQR_ENGINE_STATS 0
+	#endif
+	
+	#if PQR_ENGINE_STATS
+	//! @brief A snapshot of an engine's statistics (see \ref PQR_ENGINE_STATS).
+	struct engine_stats
+	{
+		uint64_t words; //!< The number of PRNG words drawn by the engine (for any purpose).
+		uint64_t topUps; //!< The number of uneven variates which needed more entropy (a second word).
+		uint64_t zeroWords; //!< The number of words which were exactly zero during a top-up.
+		uint64_t bitCacheRefills; //!< The number of words drawn to refill the bit cache of RandBool().
+		uint64_t bitsUsed; //!< The number of bits used by RandBool().
+		uint64_t bitsRecycled; //!< The number of bits put in the bit cache by entropy recycling (see engine::RecycleEntropy).
+		
+		engine_stats(): words(0), topUps(0), zeroWords(0), bitCacheRefills(0), bitsUsed(0), bitsRecycled(0) {}
+	};
+	#endif
+
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief The instruction-set tiers of pqRand's runtime-dispatched kernels.
+	 *
+	 *  The array kernels (e.g. engine::ApplyRandomSigns, engine::Fill_U_even,
+	 *  and the array versions of distribution::PDF/CDF/Q) are compiled once per tier,
+	 *  and the best tier the CPU supports is selected once, the first time one is called
+	 *  (see ActiveISA()). Hence, libpqr can be built for a baseline CPU
+	 *  (e.g. <tt> make MARCH=x86-64 </tt>) and still use AVX2/AVX-512 where available.
+	 *
+	 *  Every tier produces bit-identical output: the kernels use only correctly-rounded
+	 *  operations and the same libm calls, and floating-point contraction
+	 *  (fused multiply-add) is disabled when building libpqr.
+	*/
+	enum class isa {baseline, avx2, avx512};
+
+	/*! @brief The tier of the runtime-dispatched kernels (selected once per process).
+	 *
+	 *  The best tier supported by the CPU, unless the environment variable
+	 *  \c PQR_ISA is set to "baseline", "avx2" or "avx512" (for testing),
+	 *  in which case that tier is used if the CPU supports it
+	 *  (otherwise the best supported tier below it).
+	*/
+	isa ActiveISA();
+
+	//! @brief The name of the tier (as used by \c PQR_ISA).
+	char const* ISA_Name(isa const tier);
+
+	/////////////////////////////////////////////////////////////////////
+	
+	//! @brief An exception thrown when parsing state-strings fails
+	class seed_error : public std::runtime_error
+	{
+		public:
+			seed_error(std::string const& what_in):runtime_error(what_in) {}
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	inline real_t Squared(real_t const x) {return x*x;}
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+		
+	/*! @brief A wrapper for a PRNG (32 or 64 bit), providing a seeding interface.
+	 * 
+	 *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+	 * 
+	 *  This class is designed to simplify seeding for \ref xorshift1024_star.
+	 * 
+	 *  Seeding fills the \em entire state of the PRNG
+	 *  (because you can't properly seed a PRNG with 128 bytes of state using a 4-byte int).
+	 *  The recommended method is Seed(), which "auto-seeds" the PRNG.
+	 *  This auto-seed can then be stored for later re-seeding.
+	 * 
+	 *  The state of the PRNG is converted to an ASCII "state-string" by GetState(), 
+	 *  or it can be written directly to a file by WriteState(). 
+	 *  This permits re-seeding by Seed_FromString() or Seed_FromFile() (respectively). 
+	 *  The PRNG can also be seeded from a user-generated state-string, 
+	 *  provided that it is in the correct format (see Seed()).
+	 *  
+	 *  \anchor jumping_PRNG
+	 *  \note The pre-processor macro \ref PRNG_CAN_JUMP should indicate
+	 *  if PRNG_t::Jump() exists; a function which jumps the PRNG forward by a 
+	 *  sufficiently huge number of calls (e.g. \f$ O(\sqrt{\text{PRNG period}}) \f$).
+	 *  A Jump() function is useful for repeatably launching parallel threads, 
+	 *  each with their own PRNG, but where the PRNGs sequences are 
+	 *  guaranteed to be non-overlapping (and therefore not correlated). 
+	 *  The two alternatives don't work:
+	 *  - Feeding each thread its own random seed might might 
+	 *  accidentally cause sequence collisions between a pair of threads. 
+	 *   Combinatorically, this is too probable and too calamitous to ignore.
+	 *  - Parallel threads can't use the same generator because 
+	 *  thread scheduling is non-deterministic (and thus not repeatable).
+	 * 
+	 *  \warning Seed_FromFile() and Seed_FromString() do not check the format of
+	 *  state-strings before forwarding them to the PRNG. If they are malformed, 
+	 *  an exception may be thrown by the <c> friend operator>>(std::istream&, PRNG_t&)</c>.
+	 *  
+	 *  \anchor SeedWrite_Virtual
+	 *  Seed_FromStream() and WriteState_ToStream() are
+	 *  simple wrappers to \c prng_t 's \c operator<< and \c operator>>.
+	 *  These are the actual worker functions called by the public Seed/State functions, 
+	 *  and are \b virtual so that a derived PRNG class may add 
+	 *  \em more information to its internal state (beyond the state of the underlying PRNG)
+	 *  without redefining the Seed/State functions.
+	 * 
+	 *  \internal There are some extra tabs in the prng_requirement to get the formatting right in Doxygen. 
+	 *            They seem to be needed for the bullets that contain the code examples. \endinternal
+	 *  \anchor prng_requirements
+	 * 
+	 *  \param prng_t    
+	 *  A PRNG class supplying \c result_type. It must:
+	 *  	- have a nullary constructor 
+	 *    	- possess the following static fields and functions
+	 * 	\code
+			 typedef result_type; // The unsigned integer type returned by the generator
+			 static const word_size; // Number of bits per word (a single variate, stored in result_type)
+			 static const state_size; // Number of words in the PRNG state (rounded up)	       
+			 static constexpr result_type min(); // The minimum word returned by the PRNG
+			 static constexpr result_type max(); // The maximum word returned by the PRNG
+			\endcode
+	 *    	- implement the following functions to 
+	 *      input/output the state of the generator in human-readable, ASCII format
+	 *  \code
+			 friend operator>>(std::istream&, prng_t&); // Read the stream into the PRNG's state
+			 friend operator<<(std::ostream&, prng_t&); // Write the PRNG's state into the stream
+		 \endcode
+	 *		- The PRNG \em must be able to repeatably configure itself from 
+	 *      the "minimal" state-string described by Seed().
+	*/
+	template<class prng_t>
+	class seeded_uPRNG : public prng_t
+	{
+		public: 
+			// We can not document a "using" name and expect Doxygen to pick it up
+			using prng_t::word_size; // Number of bits per PRNG word
+			using prng_t::state_size; // Number of words in the PRNG state (rounded up).
+			//using typename prng_t::result_type; // The unsigned integer type returned by the generator
+						
+			// Define these using lower-case syntax for comparability with std::generate_canonical
+			using prng_t::min; // The smallest value this PRNG can return
+			using prng_t::max; // The largest value this PRNG can return
+			
+			static_assert(((word_size == 32) or (word_size == 64)), 
+				"pqRand::seeded_uPRNG requires either a 32-bit or 64-bit prng_t");
+			
+		protected:
+			/*! @brief Set the state of the PRNG from a state-string stored in a stream, 
+			 *  using \c prng_t's <c> friend operator>> </c>.
+			 * 
+			 *  See \ref SeedWrite_Virtual "the detailed class description".
+			 * 
+			 *  @param stream 
+			 *  The state input.
+			*/
+			virtual void Seed_FromStream(std::istream& stream);
+			
+			/*! @brief Write the state-string of the PRNG to \a stream, using \c prng_t's <c> friend operator<< </c>.
+			 * 
+			 *  See \ref SeedWrite_Virtual "the detailed class description".
+			 * 
+			 *  @param stream 
+			 *  The state output.
+			*/
+			virtual void WriteState_ToStream(std::ostream& stream);
+								
+		public:
+			/*! @brief Construct the PRNG using its default constructor. Auto-seed if requested.
+			 * 
+			 *  Note that the default constructor auto-seeds. 
+			 *  This scheme allows the best of both worlds:
+			 *  	- Automatically use high-quality seed in most cases (lest you forget).
+			 *  	- Allow seeding from stored states when explicitly requested 
+			 * 		by passing false (see engine::engine for an example).
+			 * 
+			 *  \param autoSeed 
+			 *  Perform an autoSeed (\c true) by calling Seed()
+			 *  or defer seeding till later (\c false).
+			 * 
+			 *  \warning If seeding is deferred, the state is not initialized. Be careful.
+			*/
+			explicit seeded_uPRNG(bool const autoSeed = true):
+				prng_t()
+			{
+				if(autoSeed) Seed(); // else defer seed to user
+			}
+			// NOTE: Access to non-auto Seed from inside the ctor is difficult.
+			// states and files are both passed as strings, so which do you want?
+			// Plus, Python can't overload functions, so we need a uniform ctor.
+			
+			virtual ~seeded_uPRNG() {}
+			
+			/*! @brief Auto-seed the generator using \c std::random_device.
+			 * 
+			 *  <a href="http://en.cppreference.com/w/cpp/numeric/random/random_device">
+			 *  \c std::random_device </a> 
+			 *  is a random number generator that should produce non-deterministic random numbers.
+			 *  On many GNU + Linux systems, \c std::random_device uses \c /dev/urandom,
+			 *  which itself uses environmental noise to seed a cryptographic PRNG. 
+			 *  Seed() calls \c std::random_device until the generator's state is filled.
+			 *  
+			 *  <b>Minimal state-string</b>
+			 * 
+			 *  Seed() constructs a state-string using the "minimal" state-string format.
+			 *  A state-string is a human-readable, ASCII representation of the 
+			 *  PRNG's internal state. The \em minimal state-string mimics 
+			 *  GNU's implementation of std::mt19937;
+			 *  a single line containing space-separated words of state (unsigned integers),
+			 *  with the number of words equalling \ref state_size,
+			 *  and terminating with the \ref state_size itself (as a sanity check).
+			 *  \code
+					s_0  s_1  s_2 ... s_(state_size - 1) state_size  // Generic minimal state-string
+				 \endcode
+			 *  An example PRNG, using \c word_size = 64 and \c state_size = 3,
+			 *  could use the following minimal state-string:
+			 *  \code  
+				 8602057372317241997 13337802638347508439 10520579822156476364 3
+				 \endcode
+			 * 	 
+			 *  If the PRNG's state has more information, it's \c friend \c operator>> 
+			 *  will have have to choose repeatable default behavior.
+			 *  For example, Seed() does not supply xorshift1024_star its
+			 *  state variable \a p, which activates the default 
+			 *  \a p=0 choice of xorshift1024_star::operator>>.
+			*/
+			void Seed();
+
+			/*! @brief Seed the PRNG from a state-string stored as the first line of an
+			 *  ASCII or UTF-8 file (e.g. from WriteState()).
+			 * 
+			 *  \note A user-created, manual seed should mimic the minimal state-string format of Seed().
+			 * 
+			 *  \warning If prng_t has an full state-string which is longer than the minimal format (e.g. xorshift2014_star)
+			 *  a user-created, manual seed \em should \em not try to supply this extra information.
+			 *  The user should only supply the minimal state-string. 
+			 *  It is the responsibility of the PRNG to repeatably configure itself 
+			 *  given only the minimal state-string.
+			 * 
+			 *  @param filePath 
+			 *  The full path to the ASCII file containing the state-string (on the first line).
+			*/
+			void Seed_FromFile(std::string const& filePath);
+			
+			/*! @brief \em Always reuse the state-string stored as the first line of an 
+			 *  ASCII or UTF-8 file (e.g. from WriteState()). 
+			 * 
+			 *  If the file cannot be opened, do default Seed(), then try to 
+			 *  WriteState() to the file. This is useful for simulations where
+			 *  a new seed is generated the first time the program is run, 
+			 *  while all subsequent runs reuse the original seed.
+			 *  
+			 *  @param filePath 
+			 *  The full path to the ASCII file containing the state-string (on the first line).
+			*/
+			void Seed_Reuse(std::string const& filePath);
+			
+			/*! @brief Seed the PRNG from a state-string 
+			 *  (e.g. from GetState()).
+			 * 
+			 *  \note A user-created, manual seed should mimic the minimal state-string format of Seed().
+			 * 
+			 *  \warning If prng_t has an full state-string which is longer than the minimal format (e.g. xorshift2014_star)
+			 *  a user-created, manual seed \em should \em not try to supply this extra information.
+			 *  The user should only supply the minimal state-string. 
+			 *  It is the responsibility of the PRNG to repeatably configure itself 
+			 *  given only the minimal state-string.
+			 * 
+			 *  @param stateString
+			 *  The state-string.
+			*/
+			void Seed_FromString(std::string const& stateString);
+						
+			/*! @brief Write the state-string of the PRNG to the first line of an ASCII file
+			 *  (e.g. for future reseeding by Seed_FromFile()).
+			 * 
+			 *  \warning Overwrites the file without warning. 
+			 *  Will not attempt to create missing directories.
+			 * 
+			 *  \throws Throws std::ifstream::failure if the file cannot be opened
+			 * 
+			 *  @param filePath 
+			 *  The full path to the file.
+			*/
+			void WriteState(std::string const& filePath);
+			
+			/*! @brief Return the full ASCII state-string of the PRNG
+			 *  (e.g. for future reseeding by Seed_FromString()).
+			*/
+			std::string GetState();
+			
+			#if PRNG_CAN_JUMP
+			/*! @brief Return a vector of PRNG state-strings (see GetState()) 
+			 *  for use by a cadre of threads running independent generators.
+			 *  
+			 *  To give each thread its own unique generator, 
+			 *  we can repeatedly Jump() a seeded generator, then record its state.
+			 *  This is a repeatable way to obtain a vector of orthogonal PRNG states. 
+			 *  The states are returned as state-strings because this is
+			 *  the easiest way to portably communicate the PRNG state to each thread
+			 *  ( e.g. if it is launched on the cloud).
+			 *  The first state-string in the vector is the original state of the PRNG,
+			 *  and each additional state-string is Jump()-ed one additional time. 
+			 *  The PRNG ends in a state not represented in the vector, 
+			 *  so it can continue to be used without risk of future collision.
+			 *  
+			 *  Storing the original state of the generator allows the 
+			 *  same vector of state-strings to be regenerated in the future
+			 *  (because Jump() is repeatable). Simple re-seed from the 
+			 *  original state, then call this functions again.
+			 *  
+			 *  \param numThreads
+			 *  The number of Jump()-ed state-strings to return.
+			 * 
+			 *  \return A vector of state-strings separated by one call to Jump().
+			 *  The first state-string is the original state of the PRNG.
+			*/
+			std::vector<std::string> GetState_JumpVec(size_t const numThreads)
+			{
+				std::vector<std::string> stateVec;
+				
+				for(size_t i = 0; i < numThreads; ++i)
+				{
+					stateVec.push_back(GetState());
+					this->Jump();
+				}
+				
+				return stateVec;	
+			}
+			#endif
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief An implementation of the xorshift1024* 
+	 *  64-bit pseudo-random number generator (PRNG).
+	 * 
+	 *  @author Sebastiano Vigna (vigna@acm.org)
+	 *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+	 *
+	 *  KP's implementation of SV's 2017 edit of 
+	 *  <a href="http://xoroshiro.di.unimi.it/xorshift1024star.c">
+	 *  xorshift1024* </a> (period \f$ p = 2^{1024} - 1\f$),
+	 *  with small changes to the code syntax and an API that mimics std::mt19937.
+	 * 
+	 *  \attention Per SV:
+	 *  "... the two lowest bits of this generator are LFSRs of degree
+	 *  1024, and thus will fail binary rank tests. The other bits needs a much
+	 *  higher degree to be represented as LFSRs. We suggest to use a 
+	 *  sign test to extract a random Boolean value, and
+	 *  right shifts to extract subsets of bits..".
+	 *  Hence, KP conservatively chooses not use the last 2 bits inside pqRand::engine.
+	 * 
+	 *  \attention The state must be seeded so that it is not everywhere zero, 
+	 *  otherwise it will always return 0 (a property it shares with \c std::mt19937).
+	 *  
+	 *  SV claims that the generator has good quality and speed,
+	 *  passing TestU01 with <a href="http://xoroshiro.di.unimi.it/#quality">
+	 *  less errors than MT19937</a>.
+	 *  KP independently tested this implementation using dieharder 3.31.1
+	 *  \code
+			 ./xorshift1024star_tester.x | dieharder -g 200 -a -k 2
+		 \endcode
+	 *  and it passed with flying colors (no failures).
+	 *  D. Lemire reports 
+	 *  <a href="https://lemire.me/blog/2017/09/15/the-xorshift1024-random-number-generator-fails-bigcrush/">
+	 *  on his blog </a> that xorshift1024star fails Big Crush. 
+	 *  SV implies <a href="http://xoroshiro.di.unimi.it/#FUD"> on his webpage </a> that 
+	 *  this is the same issue he reported with the last two bits.
+	 *  This potential failure is definitely something to watch.
+	*/	 
+	class xorshift1024_star
+	{
+		/* No doubt an SIMD version of this generator would be faster for massively parallel sampling.
+		 * This would produce 16 new random words in one large batch, bu would require doubling the state
+		 * 	s0 = current state
+		 * 	s1 = last state
+		 * We seed the generator as normal
+		 * 	s0 = seed
+		 * 	s1 = s0 (rotated left one index) ... for later use
+		 * To warm up, we run the generator 16 times (using state = s0 and the original algorithm).
+		 * This makes sure s0 has incremented in every index. Now every time we run the generator,
+		 * we replace s0 -> s0[i] and s1 -> s1[i], then loop i = [0,16), which should be auto-vectorized.
+		 * Afterwards, s0 is unchanged, s1 stores the new state, which we copy to s2 for return.
+		 * Now s1 = s0 (rotated left one index) and s0 = s2 (less copying by swapping pointers, but maybe not faster).
+		 * I'm pretty sure this is what Lemire did in (https://github.com/lemire/SIMDxorshift),
+		 * and he reported a doubling of the sampling speed. I would expect more than doubling, 
+		 * given the 4 times larger state and increased vectorized advantage.
+		 * However, speeding up the PRNG will just further highlight that
+		 * the real bottleneck is transforming the uniform integers into useful numbers,
+		 * because it takes a lot of cycles and generally involves
+		 * branching logic in the various math functions (i.e. I'm not aware of
+		 * good, universal SIMD exp, log, pow with 1 ULP or error).
+		*/ 		
+		public:
+			typedef uint64_t result_type; //!< @brief The unsigned integer type returned by the generator
+			size_t static constexpr word_size = 64; //!< @brief Number of \em bits per PRNG \em word (i.e. result_type)
+			size_t static constexpr state_size = 16; //!< @brief Number of \em words in the PRNG state (rounded up).
+			
+		 private:
+			// Lots of deep magic in this class, not much to comment for SV's code			
+			
+			// Use std::array (versus C array) to give xorshift1024_star
+			// an implicitly defined assignment (operator =),
+			// while remaining compatible with C-style array syntax in SV's code
+			std::array<uint64_t, state_size> state;
+			uint64_t p;
+			
+		public:
+			/*! @brief Power up the generator, but leave the state un-initialized.
+			 *  
+			 *  This usually places the generator in valid, but undefined, state.
+			 *  The user \em must subsequently seed the generator using operator>>().
+			 *  
+			 *  \warning Don't forget to seed the generator.
+			*/
+			xorshift1024_star():p(0) {}
+			// We must have p < state_size, so make sure to initialize it.
+			// That way, an unintentional call to an un-seeded generator won't cause a seg fault.
+			
+			virtual ~xorshift1024_star() {}			
+			
+			//! @brief The smallest value this PRNG can return
+			static constexpr size_t min() {return std::numeric_limits<result_type>::min();}			
+			//! @brief The largest value this PRNG can return		
+			static constexpr size_t max() {return std::numeric_limits<result_type>::max();}
+			
+			uint64_t operator()(); //!< @brief Return the next 64-bit, unsigned integer
+			
+			/*! @brief Fill an array with the next \p numWords 64-bit, unsigned integers
+			 *  (exactly the words returned by \p numWords calls to operator()).
+			 * 
+			 *  The bulk loop is faster than repeated calls, because it keeps the 
+			 *  active word in a register (instead of re-reading it from the state every call).
+			*/
+			void Fill(uint64_t* const words, size_t const numWords);
+			
+			/*! @brief Quickly jump the state of the generator forward by \f$ 2^{512} \f$ calls.
+			 * 
+			 *  This allows one to generate \f$ 2^{512} \f$ parallel instances of the generator
+			 *  with sequences that won't collide until they are called \f$ 2^{512} \f$ times.
+			 *  This is useful when many instances of xorshift1024_star are running in 
+			 *  parallel threads (see \ref jumping_PRNG).
+			 *   
+			 *  \note Obviously, the state of the generator is jumped 
+			 *  without actually calling it \f$ 2^{512} \f$ times 
+			 *  (since, at a billion calls per second, that would take
+			 *  \f$ 4\times10^{137} \f$ years ... a bit too long).
+			 * 
+			 *  \attention This method seems like much deeper magic than the generator itself,
+			 *  so KP cannot guarantee that it actually works as advertised by SV.
+			 *  However, after the <a href="http://stackoverflow.com/questions/34574701/xorshift1024-jump-not-commutative">
+			 *  Jan 2016 patch </a>,
+			 *  it is definitely commutative 
+			 *  [(call, Jump, call) == (Jump, call, call)],
+			 *  which certainly implies that it works.
+			*/ 
+			void Jump();
+			
+			// Declare stream operators as friends, so they can access 
+			// the private members. This only declares that they are friends, 
+			// but does not actually declare the functions themselves.		
+			friend std::ostream& operator << (std::ostream& stream, xorshift1024_star const& gen);
+			friend std::istream& operator >> (std::istream& stream, xorshift1024_star& gen);	
+	};
+		
+	// Actually declare the friend functions for xorshift1024_star
+	// (previously declared as friends, but not as actual functions).
+	
+	/*! @brief Output the complete human-readable state-string of the generator to a stream.
+	 * 
+	 *  The full state of xorshift1024_star adds the index iterator \a p
+	 *  to the the minimal state-string (as described in seeded_uPRNG::Seed):
+	 *  \code
+			s_0  s_1  s_2 ... s_15  16  p                     // Complete state-string for xorshift1024*
+		 \endcode
+	 *  \a p is determined from the number of times the generator has been called (modulo 16),
+	 *  not from a random source of entropy, which is why it doesn't count towards \ref state_size.
+	 * 
+	 *  @param stream 
+	 *  The stream to which the state-string is written.
+	 *  
+	 *  @param gen
+	 *  The generator whose state is written.
+	*/
+	std::ostream& operator << (std::ostream& stream, xorshift1024_star const& gen);
+	
+	/*! @brief Seed the state of the generator from a stream, 
+	 *  assuming the state-string format of operator<<().
+	 *  
+	 *  If \a p is missing from the state-string (e.g. if it is the minimal state-string),
+	 *  a default value of \a p = 0 is used.
+	 *  
+	 *  \throws Throws seed_error if the stream runs out before the state is full,
+	 *  or if the state-string is otherwise malformed.
+	 * 
+	 *  \warning Even though the state should have high entropy, 
+	 *  and should definitely not be all zeroes (or all ones),
+	 *  this function \em only verifies that a supplied state-string 
+	 *  can be parsed, and never that it is good or even valid.
+	 *  So don't supply a bad seed.
+	 * 
+	 *  @param stream 
+	 *  The stream from which the state-string is read.
+	 *  
+	 *  @param gen
+	 *  The generator whose state is seeded.
+	*/
+	std::istream& operator >> (std::istream& stream, xorshift1024_star& gen);	
+		
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+			
+	/*! @brief The random number engine used by all distributions in pqRand
+	 *  (see \ref engine), templated on the source of its words.
+	 * 
+	 *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+	 * 
+	 *  \ref engine wraps the seeded_uPRNG in an API designed for the 
+	 *  improved inversion method. This provides access to both 
+	 *  uneven and even samples from \f$ U(0,1) \f$, 
+	 *  a random bool that doesn't waste bits, and a simple way to apply a random sign.
+	 *  For the most part, these tools are used internally by pqRand's distributions, 
+	 *  but can also be used to construct custom sampling objects.
+	 * 
+	 *  Arbitrary states of pqRand_engine can be stored using WriteState() 
+	 *  and re-seeded using Seed_FromFile(). See seeded_uPRNG for more details.
+	 * 
+	 *  The source of words is the template parameter, so it costs nothing per word:
+	 *  \ref engine draws straight from \ref PRNG_t, while \ref buffered_engine
+	 *  draws from a buffered_prng. Both are instantiated in the library.
+	 * 
+	 *  \warning Future changes to the API are not anticipated, but may still be possible
+	 * 
+	 *  \param prng_t 
+	 *  The source of words, which must satisfy the \ref prng_requirements "\c prng_t requirements" of seeded_uPRNG.
+	*/ 
+	template<class prng_t>
+	class basic_engine : public seeded_uPRNG<prng_t>
+	{
+		public:
+			typedef typename prng_t::result_type result_type; //!< @brief The unsigned integer type of a PRNG word
+			
+			//! @brief The lowest few bits may have linear dependencies.
+			result_type static constexpr badBits = 2;
+		
+		private:
+			result_type static constexpr numBitsPRNG = prng_t::word_size;
+			result_type static constexpr numBitsMantissa = std::numeric_limits<real_t>::digits;
+			
+			static_assert((numBitsPRNG >= numBitsMantissa), 
+				"pqRand::PRNG_t must supply as many bits as the mantissa of pqRand::rand_t can hold.");
+				
+			static_assert(((prng_t::min() == std::numeric_limits<result_type>::min())
+				and ((prng_t::max() == std::numeric_limits<result_type>::max())
+					or ((std::numeric_limits<result_type>::digits > prng_t::word_size)
+					and (prng_t::max() == (result_type(1) << prng_t::word_size) - 1)))),
+				"pqRand::PRNG_t must fill all of its digits.");
+			
+			result_type static constexpr bitShiftRight_even = 
+				numBitsPRNG - numBitsMantissa;
+					
+			// For the next 2, must convert to signed int to make negative,
+			// because -uint => huge uint
+			real_t static constexpr scaleToU_even = 
+				real_t(std::exp2(-int(numBitsMantissa))); 
+												
+			real_t static constexpr scaleToU_uneven = 
+				real_t(std::exp2(-int(numBitsPRNG)));
+				
+			result_type static constexpr replenishBitCache = (result_type(1) << (badBits - 1));
+			// NOTE: if badBits == 0, replenishBitCache == 0 (a shift left of -1).
+			// This may output a warning, but should still be valid.
+						
+			// We need to fill the mantissa, with 2 bits for rounding:
+			// a buffer bit and a sticky bit. The buffer bit must use 
+			// a good bit of entropy, but the sticky bit is always set to 1, 
+			// so we can use the last bad bit as the sticky bit
+			result_type static constexpr numBitsOfEntropyRequired = 
+				numBitsMantissa + 1 + ((badBits > 0) ? (badBits - 1): 1);
+			// When the random number is less than minEntropy, we need more entropy.
+			result_type static constexpr minEntropy = 
+				(result_type(1) << (numBitsOfEntropyRequired - 1));
+						
+			result_type bitCache; //! A cache of random bits for RandBool
+			result_type cacheMask; // Selects one bit from bitCache, for RandBool
+			bool recycleEntropy; // Reload an empty bitCache with the unused bits of uniform variates
+			char padding[sizeof(result_type) - sizeof(bool)]; // Explicit, so -Wpadded stays quiet
+		
+			// The most significant bit of a uniform variate's word which cannot affect the variate
+			// (the bit below the rounding bit of an uneven variate, or the highest bit discarded by U_even).
+			result_type static constexpr topUnusedBit_even = bitShiftRight_even - 1;
+			
+			static result_type TopUnusedBit_uneven(result_type const randUint)
+			{
+				// randUint >= minEntropy, so its leading one is at or above (numBitsMantissa + 1)
+				return result_type(numBitsPRNG - 1 - result_type(__builtin_clzll(randUint))) - numBitsMantissa - 1;
+			}
+			
+			// When recycling, reload an empty bitCache with randUint's bits [badBits, topUnused]
+			void RecycleBits(result_type const randUint, result_type const topUnused)
+			{
+				if((cacheMask == replenishBitCache) and (topUnused >= badBits))
+				{
+					bitCache = randUint;
+					cacheMask = (result_type(1) << topUnused);
+					
+					#if PQR_ENGINE_STATS
+					stats.bitsRecycled += topUnused + 1 - badBits;
+					#endif
+				}
+			}
+		
+			// Top up the entropy when randUint does not have enough for an uneven variate
+			real_t U_uneven_TopUpEntropy(result_type randUint);
+			
+			// We must always default-initialize the bitCache in the same way
+			void DefaultInitializeBitCache();
+			
+			#if PQR_ENGINE_STATS
+			engine_stats stats;
+			#endif
+			
+		protected:
+			// Redefine the base class virtuals, because we need to 
+			// store/refresh the state of the bitCache when we write/seed
+			virtual void Seed_FromStream(std::istream& stream);
+			virtual void WriteState_ToStream(std::ostream& stream);
+			
+		public:
+			/*! @brief Construct the engine; auto-seed if requested.
+			 * 
+			 *  To auto-seed \ref engine, construct like:
+			 *  \code
+					pqRand::engine gen1();
+					pqRand::engine gen2(true);
+				 \endcode
+				 To supply a seed, construct like:
+			 *  \code
+					pqRand::engine gen3(false); // Don't auto-seed (leaving gen3 is an undefined state).
+					gen3.Seed_FromFile("./archive/Jan2017/run123.seed"); // Seed from a file (gen3 is no longer undefined).
+				 \endcode
+			 * 
+			 *  \note If one intends to supply a user-generated seed
+			 *  (as opposed to storing/reusing an auto-seed),
+			 *  they should use the \em minimal state-string format
+			 *  (which is described in Seed()).
+			 *  
+			 *  @warning \ref engine contains more state information than the 
+			 *  minimal state-string. This extra information should only 
+			 *  be output by WriteState(), and never generated by the user.
+			 * 
+			 *  @param autoSeed 
+			 *  Perform an autoSeed (\c true) by calling Seed()
+			 *  or defer seeding till later (\c false).
+			*/
+			basic_engine(bool const autoSeed = true):
+				seeded_uPRNG<prng_t>(autoSeed),
+				// Let the base class do the autoSeed, because although
+				// engine redefines Seed_FromStream, which the base class ctor cannot access,
+				// Seed is only passing the minimal state-string, 
+				recycleEntropy(false), padding()
+			{
+				// We must handle everything not seeded by the super-class,
+				// which seeded the PRNG from the minimal state-string
+				DefaultInitializeBitCache();				
+			}
+			
+			virtual ~basic_engine() {}
+			
+			/*! @brief Return the next word from the PRNG.
+			 * 
+			 *  Every random number drawn by the engine (and its distributions) comes through here.
+			*/
+			result_type operator()()
+			{
+				#if PQR_ENGINE_STATS
+				++stats.words;
+				#endif
+				
+				return prng_t::operator()();
+			}
+			
+			/*! @brief Discard the cached random bits used by RandBool().
+			 * 
+			 *  A copy of an engine shares its cached bits, even after it is Jump()-ed.
+			 *  Discarding them gives the copy independent coin flips.
+			*/
+			void DiscardBitCache() {DefaultInitializeBitCache();}
+			
+			/*! @brief Turn entropy recycling on or off (it is off by default).
+			 * 
+			 *  An uneven uniform variate only depends on the bits of its PRNG word
+			 *  down to the rounding bit (a sticky bit is always set), 
+			 *  and U_even() discards the lowest bits of its word. 
+			 *  When recycling, every U_uneven(), HalfU_uneven() and U_even() which finds 
+			 *  the bit cache \em empty reloads it with the good bits of its word below those bits
+			 *  (about 7 bits for an uneven variate, between 0 and 8 depending on its binade; 
+			 *  9 bits for an even variate; none when an uneven variate needs a top-up).
+			 *  RandBool() (and RandBits(), FillBools(), ApplyRandomSign()) then reads them 
+			 *  exactly like a refilled cache, from the most significant down to the 
+			 *  least significant bit above badBits, 
+			 *  drawing a new word only when they run out. The recycled bits are independent of the variate, 
+			 *  so e.g. the quantile flip-flop of distributionQ2 rarely needs a word of its own.
+			 * 
+			 *  \warning Recycling changes the stream (the bools come from different bits, 
+			 *  and fewer words are drawn), so the default stream is only reproduced with recycling off.
+			 *  The mode is a property of the engine object (it is copied, but not stored in state-strings); 
+			 *  to reproduce a stream, restore the state-string \em and the mode.
+			*/
+			void RecycleEntropy(bool const recycle) {recycleEntropy = recycle;}
+			
+			//! @brief Is entropy recycling on (see RecycleEntropy())?
+			bool RecyclingEntropy() const {return recycleEntropy;}
+			
+			#if PQR_ENGINE_STATS
+			/*! @brief A snapshot of the engine's statistics, 
+			 *  accumulated since construction or the last ResetStats().
+			 * 
+			 *  Only available when \ref PQR_ENGINE_STATS is non-zero. 
+			 *  Copying an engine copies its statistics; seeding does not reset them.
+			*/
+			engine_stats Stats() const {return stats;}
+			
+			//! @brief Zero the engine's statistics.
+			void ResetStats() {stats = engine_stats();}
+			#endif
+			
+			/*! @brief Return the result of an ideal coin flip
+			 * 
+			 *  This uses the PRNG efficiently, using 1 bit of randomness per \c bool.
+			*/
+			bool RandBool(); 
+			
+			/*! @brief Assign the victim a random sign (+/-) (by \em reference) using RandBool().
+			 * 
+			 * \param victim 
+			 * The floating-point number which is assigned a random sign (+/-).
+			 * 
+			 * \return the altered victim
+			*/ 			
+			real_t ApplyRandomSign(real_t& victim)
+			{
+				if(RandBool()) victim = -victim;
+				return victim;
+			}
+			
+			/*! @brief Assign the victim a random sign (+/-) using RandBool().
+			 * 
+			 * \param victim 
+			 * The floating-point number which is assigned a random sign (+/-).
+			 * 
+			 * \return the altered victim
+			*/ 
+			real_t ApplyRandomSign(real_t&& victim)
+			{
+				ApplyRandomSign(victim);
+				return victim;
+			}
+
+			//! @brief The most bits RandBits() can draw at once (the good bits of one PRNG word).
+			size_t static constexpr maxRandBits = size_t(numBitsPRNG - badBits);
+
+			/*! @brief Draw \p numBits random bits at once.
+			 *
+			 *  The bits are the ones that the next \p numBits calls to RandBool()
+			 *  would have returned (the first is the most significant bit of the result),
+			 *  and the engine is left in the same state, so RandBits() and RandBool()
+			 *  can be mixed without altering the stream of bits.
+			 *
+			 *  \throws throws std::domain_error if \p numBits > \ref maxRandBits.
+			*/
+			result_type RandBits(size_t const numBits);
+
+			/*! @brief Draw \p numBools random bools, packed 64 per word.
+			 *
+			 *  Bool \c i is bit <tt> (i % 64) </tt> of <tt> words[i / 64] </tt>
+			 *  (the unused high bits of the last word are cleared),
+			 *  and it is the bool that the i-th call to RandBool() would have returned.
+			 *
+			 *  \param words 	must have room for <tt> ceil(numBools / 64) </tt> words
+			*/
+			void FillBools(uint64_t* const words, size_t const numBools);
+
+			/*! @brief Give each of \p numVictims variates a random sign (+/-).
+			 *
+			 *  The result is identical to calling ApplyRandomSign() on each in turn,
+			 *  but the signs are XOR-ed straight into the sign bits,
+			 *  one RandBits() call per \ref maxRandBits variates, and one runtime-dispatched kernel 
+			 *  (a loop the compiler can vectorize) per chunk of about a thousand variates.
+			*/
+			void ApplyRandomSigns(real_t* const victims, size_t const numVictims);
+
+			/*! @brief Fill \p sample with \p sampleSize even uniform variates.
+			 *
+			 *  The result (and the engine's state afterwards) is identical to
+			 *  calling U_even() \p sampleSize times, but the words are drawn in blocks
+			 *  and converted to real_t by a runtime-dispatched kernel (see \ref isa).
+			*/
+			void Fill_U_even(real_t* const sample, size_t const sampleSize);
+
+			// The uniform variate functions are MUCH faster if they are defined in the header, 
+			// because the compiler can do more optimization depending on their use.
+			// The TopUpEntropy function is rare, so leave it to the library to reduce inline-ing
+							
+			/*! @brief Draw an uneven uniform variate from \f$ U(0, 1] \f$.
+			 * 
+			 *  Draw a random \em real number from \f$ U(0, 1] \f$, 
+			 *  then round to the nearest floating point.
+			 *  
+			 *  \note 1 is half as probable as its next-door neighbor
+			*/
+			real_t U_uneven() 
+			{
+				result_type const randUint = (*this)();
+
+				if(randUint < minEntropy) // If randUint lacks enough entropy, top it up
+					return U_uneven_TopUpEntropy(randUint);
+				else 
+				{
+					if(recycleEntropy) RecycleBits(randUint, TopUnusedBit_uneven(randUint));
+					return scaleToU_uneven * real_t(randUint bitor result_type(1));
+				}
+			}
+			
+			/*! @brief Draw an uneven uniform variate from \f$ U(0, 0.5] \f$.
+			 * 
+			 *  Draw a random \em real number from \f$ U(0, 0.5] \f$, 
+			 *  then round to the nearest floating point.
+			 *  
+			 *  \note 0.5 is half as probable as its next-door neighbor
+			*/
+			real_t HalfU_uneven() 
+			{
+				result_type const randUint = (*this)();
+
+				if(randUint < minEntropy) // If randUint lacks enough entropy, top it up
+					return real_t(0.5) * U_uneven_TopUpEntropy(randUint);
+				else 
+				{
+					if(recycleEntropy) RecycleBits(randUint, TopUnusedBit_uneven(randUint));
+					return real_t(0.5) * scaleToU_uneven * real_t(randUint bitor result_type(1));
+				}
+			}
+			
+			/*! @brief Draw an even uniform variate from \f$ U[0, 1)\f$
+			 * 
+			 *  Partition \f$ U[0, 1) \f$ in increments of machine \f$ \epsilon \f$
+			 *  and draw uniformly from this sample-space.
+			*/
+			real_t U_even()
+			{
+				result_type const randUint = (*this)();
+				
+				if(recycleEntropy) RecycleBits(randUint, topUnusedBit_even);
+				return scaleToU_even * real_t(randUint >> bitShiftRight_even);
+			}
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief The random number engine used by all distributions in pqRand
+	 *  (a basic_engine which draws straight from \ref PRNG_t).
+	*/
+	typedef basic_engine<PRNG_t> engine;
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief A PRNG which generates the words of \c prng_t in bulk, 
+	 *  then serves them one at a time from an internal buffer.
+	 * 
+	 *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+	 * 
+	 *  Generating a whole block of words in one tight loop amortizes the 
+	 *  overhead of calling the PRNG. The words are \em identical to the words of 
+	 *  \c prng_t with the same state.
+	 * 
+	 *  The state-string written by <c> operator<< </c> (and the state used by Jump())
+	 *  is the state of the PRNG \em as \em if it were not buffered;
+	 *  the buffer position is folded into the state-string by rewinding the PRNG 
+	 *  to the start of the buffer and replaying the words already used.
+	 *  Hence, state-strings are interchangeable between a buffered and a plain PRNG.
+	 *  A copy continues from the same buffer position.
+	 * 
+	 *  \param prng_t 
+	 *  A PRNG satisfying the \ref prng_requirements "\c prng_t requirements" of seeded_uPRNG
+	 *  (it should have a bulk Fill(), see \ref PRNG_CAN_FILL).
+	*/
+	template<class prng_t>
+	class buffered_prng : public prng_t
+	{
+		public:
+			typedef typename prng_t::result_type result_type; //!< @brief The unsigned integer type of a PRNG word
+			
+			size_t static constexpr bufferSize = 256; //!< @brief The number of words generated at once
+		
+		private:
+			prng_t origin; // The state of the PRNG before the last refill
+			std::array<result_type, bufferSize> buffer;
+			size_t index; // The next word served from the buffer (bufferSize when it is empty)
+			
+			// Refill the buffer and return its first word (rare, so leave it to the library)
+			result_type Refill();
+			
+			// The state the PRNG would have without the buffer
+			prng_t Unbuffered() const;
+			
+		public:
+			//! @brief Power up the PRNG (see prng_t's constructor), with an empty buffer.
+			buffered_prng():
+				prng_t(), origin(), buffer(), index(bufferSize) {}
+			
+			virtual ~buffered_prng() {}
+			
+			//! @brief Return the next word (from the buffer, refilling it when it is empty).
+			result_type operator()()
+			{
+				return (index < bufferSize) ? buffer[index++] : Refill();
+			}
+			
+			/*! @brief Fill an array with the next \p numWords words 
+			 *  (what remains in the buffer, then straight from the PRNG).
+			*/
+			void Fill(result_type* const words, size_t const numWords);
+			
+			#if PRNG_CAN_JUMP
+			//! @brief Discard the buffer, then jump the PRNG forward (see \ref jumping_PRNG).
+			void Jump();
+			#endif
+			
+			//! @brief Write the state-string of the unbuffered PRNG to the stream.
+			friend std::ostream& operator << (std::ostream& stream, buffered_prng const& gen)
+			{
+				return stream << gen.Unbuffered();
+			}
+			
+			//! @brief Seed the PRNG from the stream, discarding the buffer.
+			friend std::istream& operator >> (std::istream& stream, buffered_prng& gen)
+			{
+				gen.index = bufferSize;
+				return stream >> static_cast<prng_t&>(gen);
+			}
+	};
+	
+	/*! @brief An engine which generates PRNG words in bulk (a basic_engine drawing from a buffered_prng).
+	 * 
+	 *  Its stream, GetState() and WriteState() are identical to those of an \ref engine with the same state.
+	 *  The buffer lives in the PRNG, so \ref engine's draws stay a bare PRNG call; 
+	 *  the price is that the distributions (which take an \ref engine) cannot use a buffered_engine. 
+	 *  It serves words, bools and uniform variates (e.g. for custom sampling objects).
+	*/
+	typedef basic_engine<buffered_prng<PRNG_t>> buffered_engine;
+};
+
+#endif
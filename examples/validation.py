@@ -41,7 +41,11 @@ def TestDistribution(dist, sampleSize, binSize):
 	gen = pqr.engine()
 	indexer = pqr.uniform_integer(0, sampleSize)
 		
-	sample = dist.GetSample(sampleSize, gen)
+	# Quantile flip-flops can sample in ascending order directly (without sorting)
+	if isinstance(dist, pqr._distributionQ2):
+		sample = dist.GetSortedSample(sampleSize, gen)
+	else:
+		sample = numpy.sort(dist.GetSample(sampleSize, gen))
 	
 	assert(len(sample) == int(sampleSize))
 	mean = BinaryAccumulate(sample) / sampleSize
@@ -50,7 +54,6 @@ def TestDistribution(dist, sampleSize, binSize):
 	variance = BinaryAccumulate_Destructive(squareDeviations) / (sampleSize - 1.)
 	
 	#~ sample = numpy.insert(sample, 0, [dist.min(), dist.max()])
-	sample = numpy.sort(sample)
 	
 	testIndices = indexer.GetSample(binSize, gen)
 	testIndices = numpy.insert(testIndices, 0, [0, indexer.max() - 1])
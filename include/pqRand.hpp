@@ -38,6 +38,7 @@
 #include <array>
 #include <vector>
 #include <random> // mt19937
+#include <stdexcept> // runtime_error
 
 namespace pqRand //! @brief The namespace of the pqRand package
 {	
@@ -82,7 +83,12 @@ namespace pqRand //! @brief The namespace of the pqRand package
 	 *  	+ \ref pareto
 	 *  	+ \ref logistic
 	 *  	+ \ref log_logistic "log-logistic"
-	 *  	+ \ref gammaDist "gamma"
+	 *  	+ \ref gammaDist "gamma" (also \ref gammaDist_MarsagliaTsang "for any shape")
+	 *  	+ \ref discrete "discrete" (categorical, via an alias table; 
+	 *  	also \ref dynamic_discrete "with weights that change between draws")
+	 *  	+ \ref poisson
+	 *  	+ \ref binomial
+	 *  	+ \ref bernoulli (using ~2 random bits per trial)
 	 *    
 	 *  Theory @anchor theory
 	 *  -------
@@ -165,7 +171,7 @@ namespace pqRand //! @brief The namespace of the pqRand package
 	 *  One such candidate is \c std::mt19937_64, which was used as 
 	 *  the model for the seeded_uPRNG API.
 	 * 
-	 *  \warning If PRNG_t is redefined, one may have to change \ref PRNG_CAN_JUMP
+	 *  \warning If PRNG_t is redefined, one may have to change \ref PRNG_CAN_JUMP and \ref PRNG_CAN_FILL
 	 * 
 	 *  The authors of pqRand have carefully chosen xorshift1024_star as the default PRNG,
 	 *  since it has a "large but not too large" period (\f$ 2^{1024} \f$), 
@@ -179,16 +185,19 @@ namespace pqRand //! @brief The namespace of the pqRand package
 		
 	typedef xorshift1024_star PRNG_t;
 	#define PRNG_CAN_JUMP 1 //!< Does the PRNG have a Jump() function? See \ref jumping_PRNG
+	#define PRNG_CAN_FILL 1 //!< Does the PRNG have a bulk Fill() function? See \ref buffered_engine
 	
 	/////////////////////////////////////////////////////////////////////
 	
 	//~ typedef std::mt19937_64 PRNG_t;
 	//~ #define PRNG_CAN_JUMP 0 //!< Does the PRNG have a Jump() function? See \ref jumping_PRNG
+	//~ #define PRNG_CAN_FILL 0 //!< Does the PRNG have a bulk Fill() function? See \ref buffered_engine
 	
 	/////////////////////////////////////////////////////////////////////
 	
 	//~ typedef std::mt19937 PRNG_t;
 	//~ #define PRNG_CAN_JUMP 0 //!< Does the PRNG have a Jump() function? See \ref jumping_PRNG
+	//~ #define PRNG_CAN_FILL 0 //!< Does the PRNG have a bulk Fill() function? See \ref buffered_engine
 	
 	/////////////////////////////////////////////////////////////////////
 			
@@ -198,6 +207,62 @@ namespace pqRand //! @brief The namespace of the pqRand package
 	
 	/////////////////////////////////////////////////////////////////////
 
+	/*! @brief Count how the engine spends its entropy (see engine::Stats()).
+	 * 
+	 *  The counters change the layout of \ref engine, so this macro must have 
+	 *  the same value when building libpqr and the programs which use it
+	 *  (e.g. compile both with \c -DPQR_ENGINE_STATS=1).
+	 *  When zero (the default), the counters do not exist, so they cost nothing.
+	*/
+	#ifndef PQR_ENGINE_STATS
+		#define PQR_ENGINE_STATS 0
+	#endif
+	
+	#if PQR_ENGINE_STATS
+	//! @brief A snapshot of an engine's statistics (see \ref PQR_ENGINE_STATS).
+	struct engine_stats
+	{
+		uint64_t words; //!< The number of PRNG words drawn by the engine (for any purpose).
+		uint64_t topUps; //!< The number of uneven variates which needed more entropy (a second word).
+		uint64_t zeroWords; //!< The number of words which were exactly zero during a top-up.
+		uint64_t bitCacheRefills; //!< The number of words drawn to refill the bit cache of RandBool().
+		uint64_t bitsUsed; //!< The number of bits used by RandBool().
+		uint64_t bitsRecycled; //!< The number of bits put in the bit cache by entropy recycling (see engine::RecycleEntropy).
+		
+		engine_stats(): words(0), topUps(0), zeroWords(0), bitCacheRefills(0), bitsUsed(0), bitsRecycled(0) {}
+	};
+	#endif
+
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief The instruction-set tiers of pqRand's runtime-dispatched kernels.
+	 *
+	 *  The array kernels (e.g. engine::ApplyRandomSigns, engine::Fill_U_even,
+	 *  and the array versions of distribution::PDF/CDF/Q) are compiled once per tier,
+	 *  and the best tier the CPU supports is selected once, the first time one is called
+	 *  (see ActiveISA()). Hence, libpqr can be built for a baseline CPU
+	 *  (e.g. <tt> make MARCH=x86-64 </tt>) and still use AVX2/AVX-512 where available.
+	 *
+	 *  Every tier produces bit-identical output: the kernels use only correctly-rounded
+	 *  operations and the same libm calls, and floating-point contraction
+	 *  (fused multiply-add) is disabled when building libpqr.
+	*/
+	enum class isa {baseline, avx2, avx512};
+
+	/*! @brief The tier of the runtime-dispatched kernels (selected once per process).
+	 *
+	 *  The best tier supported by the CPU, unless the environment variable
+	 *  \c PQR_ISA is set to "baseline", "avx2" or "avx512" (for testing),
+	 *  in which case that tier is used if the CPU supports it
+	 *  (otherwise the best supported tier below it).
+	*/
+	isa ActiveISA();
+
+	//! @brief The name of the tier (as used by \c PQR_ISA).
+	char const* ISA_Name(isa const tier);
+
+	/////////////////////////////////////////////////////////////////////
+	
 	//! @brief An exception thrown when parsing state-strings fails
 	class seed_error : public std::runtime_error
 	{
@@ -579,6 +644,14 @@ namespace pqRand //! @brief The namespace of the pqRand package
 			
 			uint64_t operator()(); //!< @brief Return the next 64-bit, unsigned integer
 			
+			/*! @brief Fill an array with the next \p numWords 64-bit, unsigned integers
+			 *  (exactly the words returned by \p numWords calls to operator()).
+			 * 
+			 *  The bulk loop is faster than repeated calls, because it keeps the 
+			 *  active word in a register (instead of re-reading it from the state every call).
+			*/
+			void Fill(uint64_t* const words, size_t const numWords);
+			
 			/*! @brief Quickly jump the state of the generator forward by \f$ 2^{512} \f$ calls.
 			 * 
 			 *  This allows one to generate \f$ 2^{512} \f$ parallel instances of the generator
@@ -655,7 +728,8 @@ namespace pqRand //! @brief The namespace of the pqRand package
 	/////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////
 			
-	/*! @brief The random number engine used by all distributions in pqRand.
+	/*! @brief The random number engine used by all distributions in pqRand
+	 *  (see \ref engine), templated on the source of its words.
 	 * 
 	 *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
 	 * 
@@ -669,25 +743,35 @@ namespace pqRand //! @brief The namespace of the pqRand package
 	 *  Arbitrary states of pqRand_engine can be stored using WriteState() 
 	 *  and re-seeded using Seed_FromFile(). See seeded_uPRNG for more details.
 	 * 
+	 *  The source of words is the template parameter, so it costs nothing per word:
+	 *  \ref engine draws straight from \ref PRNG_t, while \ref buffered_engine
+	 *  draws from a buffered_prng. Both are instantiated in the library.
+	 * 
 	 *  \warning Future changes to the API are not anticipated, but may still be possible
+	 * 
+	 *  \param prng_t 
+	 *  The source of words, which must satisfy the \ref prng_requirements "\c prng_t requirements" of seeded_uPRNG.
 	*/ 
-	class engine : public seeded_uPRNG<PRNG_t>
+	template<class prng_t>
+	class basic_engine : public seeded_uPRNG<prng_t>
 	{
 		public:
+			typedef typename prng_t::result_type result_type; //!< @brief The unsigned integer type of a PRNG word
+			
 			//! @brief The lowest few bits may have linear dependencies.
 			result_type static constexpr badBits = 2;
 		
 		private:
-			result_type static constexpr numBitsPRNG = word_size;
+			result_type static constexpr numBitsPRNG = prng_t::word_size;
 			result_type static constexpr numBitsMantissa = std::numeric_limits<real_t>::digits;
 			
 			static_assert((numBitsPRNG >= numBitsMantissa), 
 				"pqRand::PRNG_t must supply as many bits as the mantissa of pqRand::rand_t can hold.");
 				
-			static_assert(((PRNG_t::min() == std::numeric_limits<result_type>::min())
-				and ((PRNG_t::max() == std::numeric_limits<result_type>::max())
-					or ((std::numeric_limits<result_type>::digits > PRNG_t::word_size)
-					and (PRNG_t::max() == (result_type(1) << PRNG_t::word_size) - 1)))),
+			static_assert(((prng_t::min() == std::numeric_limits<result_type>::min())
+				and ((prng_t::max() == std::numeric_limits<result_type>::max())
+					or ((std::numeric_limits<result_type>::digits > prng_t::word_size)
+					and (prng_t::max() == (result_type(1) << prng_t::word_size) - 1)))),
 				"pqRand::PRNG_t must fill all of its digits.");
 			
 			result_type static constexpr bitShiftRight_even = 
@@ -717,18 +801,49 @@ namespace pqRand //! @brief The namespace of the pqRand package
 						
 			result_type bitCache; //! A cache of random bits for RandBool
 			result_type cacheMask; // Selects one bit from bitCache, for RandBool
+			bool recycleEntropy; // Reload an empty bitCache with the unused bits of uniform variates
+			char padding[sizeof(result_type) - sizeof(bool)]; // Explicit, so -Wpadded stays quiet
+		
+			// The most significant bit of a uniform variate's word which cannot affect the variate
+			// (the bit below the rounding bit of an uneven variate, or the highest bit discarded by U_even).
+			result_type static constexpr topUnusedBit_even = bitShiftRight_even - 1;
+			
+			static result_type TopUnusedBit_uneven(result_type const randUint)
+			{
+				// randUint >= minEntropy, so its leading one is at or above (numBitsMantissa + 1)
+				return result_type(numBitsPRNG - 1 - result_type(__builtin_clzll(randUint))) - numBitsMantissa - 1;
+			}
+			
+			// When recycling, reload an empty bitCache with randUint's bits [badBits, topUnused]
+			void RecycleBits(result_type const randUint, result_type const topUnused)
+			{
+				if((cacheMask == replenishBitCache) and (topUnused >= badBits))
+				{
+					bitCache = randUint;
+					cacheMask = (result_type(1) << topUnused);
+					
+					#if PQR_ENGINE_STATS
+					stats.bitsRecycled += topUnused + 1 - badBits;
+					#endif
+				}
+			}
 		
 			// Top up the entropy when randUint does not have enough for an uneven variate
 			real_t U_uneven_TopUpEntropy(result_type randUint);
 			
+			// We must always default-initialize the bitCache in the same way
+			void DefaultInitializeBitCache();
+			
+			#if PQR_ENGINE_STATS
+			engine_stats stats;
+			#endif
+			
+		protected:
 			// Redefine the base class virtuals, because we need to 
 			// store/refresh the state of the bitCache when we write/seed
 			virtual void Seed_FromStream(std::istream& stream);
 			virtual void WriteState_ToStream(std::ostream& stream);
 			
-			// We must always default-initialize the bitCache in the same way
-			void DefaultInitializeBitCache();
-			
 		public:
 			/*! @brief Construct the engine; auto-seed if requested.
 			 * 
@@ -756,18 +871,77 @@ namespace pqRand //! @brief The namespace of the pqRand package
 			 *  Perform an autoSeed (\c true) by calling Seed()
 			 *  or defer seeding till later (\c false).
 			*/
-			engine(bool const autoSeed = true):
-				seeded_uPRNG(autoSeed)
+			basic_engine(bool const autoSeed = true):
+				seeded_uPRNG<prng_t>(autoSeed),
 				// Let the base class do the autoSeed, because although
 				// engine redefines Seed_FromStream, which the base class ctor cannot access,
 				// Seed is only passing the minimal state-string, 
+				recycleEntropy(false), padding()
 			{
 				// We must handle everything not seeded by the super-class,
 				// which seeded the PRNG from the minimal state-string
 				DefaultInitializeBitCache();				
 			}
 			
-			virtual ~engine() {}
+			virtual ~basic_engine() {}
+			
+			/*! @brief Return the next word from the PRNG.
+			 * 
+			 *  Every random number drawn by the engine (and its distributions) comes through here.
+			*/
+			result_type operator()()
+			{
+				#if PQR_ENGINE_STATS
+				++stats.words;
+				#endif
+				
+				return prng_t::operator()();
+			}
+			
+			/*! @brief Discard the cached random bits used by RandBool().
+			 * 
+			 *  A copy of an engine shares its cached bits, even after it is Jump()-ed.
+			 *  Discarding them gives the copy independent coin flips.
+			*/
+			void DiscardBitCache() {DefaultInitializeBitCache();}
+			
+			/*! @brief Turn entropy recycling on or off (it is off by default).
+			 * 
+			 *  An uneven uniform variate only depends on the bits of its PRNG word
+			 *  down to the rounding bit (a sticky bit is always set), 
+			 *  and U_even() discards the lowest bits of its word. 
+			 *  When recycling, every U_uneven(), HalfU_uneven() and U_even() which finds 
+			 *  the bit cache \em empty reloads it with the good bits of its word below those bits
+			 *  (about 7 bits for an uneven variate, between 0 and 8 depending on its binade; 
+			 *  9 bits for an even variate; none when an uneven variate needs a top-up).
+			 *  RandBool() (and RandBits(), FillBools(), ApplyRandomSign()) then reads them 
+			 *  exactly like a refilled cache, from the most significant down to the 
+			 *  least significant bit above badBits, 
+			 *  drawing a new word only when they run out. The recycled bits are independent of the variate, 
+			 *  so e.g. the quantile flip-flop of distributionQ2 rarely needs a word of its own.
+			 * 
+			 *  \warning Recycling changes the stream (the bools come from different bits, 
+			 *  and fewer words are drawn), so the default stream is only reproduced with recycling off.
+			 *  The mode is a property of the engine object (it is copied, but not stored in state-strings); 
+			 *  to reproduce a stream, restore the state-string \em and the mode.
+			*/
+			void RecycleEntropy(bool const recycle) {recycleEntropy = recycle;}
+			
+			//! @brief Is entropy recycling on (see RecycleEntropy())?
+			bool RecyclingEntropy() const {return recycleEntropy;}
+			
+			#if PQR_ENGINE_STATS
+			/*! @brief A snapshot of the engine's statistics, 
+			 *  accumulated since construction or the last ResetStats().
+			 * 
+			 *  Only available when \ref PQR_ENGINE_STATS is non-zero. 
+			 *  Copying an engine copies its statistics; seeding does not reset them.
+			*/
+			engine_stats Stats() const {return stats;}
+			
+			//! @brief Zero the engine's statistics.
+			void ResetStats() {stats = engine_stats();}
+			#endif
 			
 			/*! @brief Return the result of an ideal coin flip
 			 * 
@@ -800,7 +974,48 @@ namespace pqRand //! @brief The namespace of the pqRand package
 				ApplyRandomSign(victim);
 				return victim;
 			}
-			
+
+			//! @brief The most bits RandBits() can draw at once (the good bits of one PRNG word).
+			size_t static constexpr maxRandBits = size_t(numBitsPRNG - badBits);
+
+			/*! @brief Draw \p numBits random bits at once.
+			 *
+			 *  The bits are the ones that the next \p numBits calls to RandBool()
+			 *  would have returned (the first is the most significant bit of the result),
+			 *  and the engine is left in the same state, so RandBits() and RandBool()
+			 *  can be mixed without altering the stream of bits.
+			 *
+			 *  \throws throws std::domain_error if \p numBits > \ref maxRandBits.
+			*/
+			result_type RandBits(size_t const numBits);
+
+			/*! @brief Draw \p numBools random bools, packed 64 per word.
+			 *
+			 *  Bool \c i is bit <tt> (i % 64) </tt> of <tt> words[i / 64] </tt>
+			 *  (the unused high bits of the last word are cleared),
+			 *  and it is the bool that the i-th call to RandBool() would have returned.
+			 *
+			 *  \param words 	must have room for <tt> ceil(numBools / 64) </tt> words
+			*/
+			void FillBools(uint64_t* const words, size_t const numBools);
+
+			/*! @brief Give each of \p numVictims variates a random sign (+/-).
+			 *
+			 *  The result is identical to calling ApplyRandomSign() on each in turn,
+			 *  but the signs are XOR-ed straight into the sign bits,
+			 *  one RandBits() call per \ref maxRandBits variates, and one runtime-dispatched kernel 
+			 *  (a loop the compiler can vectorize) per chunk of about a thousand variates.
+			*/
+			void ApplyRandomSigns(real_t* const victims, size_t const numVictims);
+
+			/*! @brief Fill \p sample with \p sampleSize even uniform variates.
+			 *
+			 *  The result (and the engine's state afterwards) is identical to
+			 *  calling U_even() \p sampleSize times, but the words are drawn in blocks
+			 *  and converted to real_t by a runtime-dispatched kernel (see \ref isa).
+			*/
+			void Fill_U_even(real_t* const sample, size_t const sampleSize);
+
 			// The uniform variate functions are MUCH faster if they are defined in the header, 
 			// because the compiler can do more optimization depending on their use.
 			// The TopUpEntropy function is rare, so leave it to the library to reduce inline-ing
@@ -819,7 +1034,10 @@ namespace pqRand //! @brief The namespace of the pqRand package
 				if(randUint < minEntropy) // If randUint lacks enough entropy, top it up
 					return U_uneven_TopUpEntropy(randUint);
 				else 
+				{
+					if(recycleEntropy) RecycleBits(randUint, TopUnusedBit_uneven(randUint));
 					return scaleToU_uneven * real_t(randUint bitor result_type(1));
+				}
 			}
 			
 			/*! @brief Draw an uneven uniform variate from \f$ U(0, 0.5] \f$.
@@ -836,7 +1054,10 @@ namespace pqRand //! @brief The namespace of the pqRand package
 				if(randUint < minEntropy) // If randUint lacks enough entropy, top it up
 					return real_t(0.5) * U_uneven_TopUpEntropy(randUint);
 				else 
+				{
+					if(recycleEntropy) RecycleBits(randUint, TopUnusedBit_uneven(randUint));
 					return real_t(0.5) * scaleToU_uneven * real_t(randUint bitor result_type(1));
+				}
 			}
 			
 			/*! @brief Draw an even uniform variate from \f$ U[0, 1)\f$
@@ -846,9 +1067,108 @@ namespace pqRand //! @brief The namespace of the pqRand package
 			*/
 			real_t U_even()
 			{
-				return scaleToU_even * real_t((*this)() >> bitShiftRight_even);
+				result_type const randUint = (*this)();
+				
+				if(recycleEntropy) RecycleBits(randUint, topUnusedBit_even);
+				return scaleToU_even * real_t(randUint >> bitShiftRight_even);
 			}
-	};	
+	};
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief The random number engine used by all distributions in pqRand
+	 *  (a basic_engine which draws straight from \ref PRNG_t).
+	*/
+	typedef basic_engine<PRNG_t> engine;
+	
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+	
+	/*! @brief A PRNG which generates the words of \c prng_t in bulk, 
+	 *  then serves them one at a time from an internal buffer.
+	 * 
+	 *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+	 * 
+	 *  Generating a whole block of words in one tight loop amortizes the 
+	 *  overhead of calling the PRNG. The words are \em identical to the words of 
+	 *  \c prng_t with the same state.
+	 * 
+	 *  The state-string written by <c> operator<< </c> (and the state used by Jump())
+	 *  is the state of the PRNG \em as \em if it were not buffered;
+	 *  the buffer position is folded into the state-string by rewinding the PRNG 
+	 *  to the start of the buffer and replaying the words already used.
+	 *  Hence, state-strings are interchangeable between a buffered and a plain PRNG.
+	 *  A copy continues from the same buffer position.
+	 * 
+	 *  \param prng_t 
+	 *  A PRNG satisfying the \ref prng_requirements "\c prng_t requirements" of seeded_uPRNG
+	 *  (it should have a bulk Fill(), see \ref PRNG_CAN_FILL).
+	*/
+	template<class prng_t>
+	class buffered_prng : public prng_t
+	{
+		public:
+			typedef typename prng_t::result_type result_type; //!< @brief The unsigned integer type of a PRNG word
+			
+			size_t static constexpr bufferSize = 256; //!< @brief The number of words generated at once
+		
+		private:
+			prng_t origin; // The state of the PRNG before the last refill
+			std::array<result_type, bufferSize> buffer;
+			size_t index; // The next word served from the buffer (bufferSize when it is empty)
+			
+			// Refill the buffer and return its first word (rare, so leave it to the library)
+			result_type Refill();
+			
+			// The state the PRNG would have without the buffer
+			prng_t Unbuffered() const;
+			
+		public:
+			//! @brief Power up the PRNG (see prng_t's constructor), with an empty buffer.
+			buffered_prng():
+				prng_t(), origin(), buffer(), index(bufferSize) {}
+			
+			virtual ~buffered_prng() {}
+			
+			//! @brief Return the next word (from the buffer, refilling it when it is empty).
+			result_type operator()()
+			{
+				return (index < bufferSize) ? buffer[index++] : Refill();
+			}
+			
+			/*! @brief Fill an array with the next \p numWords words 
+			 *  (what remains in the buffer, then straight from the PRNG).
+			*/
+			void Fill(result_type* const words, size_t const numWords);
+			
+			#if PRNG_CAN_JUMP
+			//! @brief Discard the buffer, then jump the PRNG forward (see \ref jumping_PRNG).
+			void Jump();
+			#endif
+			
+			//! @brief Write the state-string of the unbuffered PRNG to the stream.
+			friend std::ostream& operator << (std::ostream& stream, buffered_prng const& gen)
+			{
+				return stream << gen.Unbuffered();
+			}
+			
+			//! @brief Seed the PRNG from the stream, discarding the buffer.
+			friend std::istream& operator >> (std::istream& stream, buffered_prng& gen)
+			{
+				gen.index = bufferSize;
+				return stream >> static_cast<prng_t&>(gen);
+			}
+	};
+	
+	/*! @brief An engine which generates PRNG words in bulk (a basic_engine drawing from a buffered_prng).
+	 * 
+	 *  Its stream, GetState() and WriteState() are identical to those of an \ref engine with the same state.
+	 *  The buffer lives in the PRNG, so \ref engine's draws stay a bare PRNG call; 
+	 *  the price is that the distributions (which take an \ref engine) cannot use a buffered_engine. 
+	 *  It serves words, bools and uniform variates (e.g. for custom sampling objects).
+	*/
+	typedef basic_engine<buffered_prng<PRNG_t>> buffered_engine;
 };
 
 #endif
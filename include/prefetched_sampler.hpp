@@ -0,0 +1,267 @@
+/* pqRand: The precise quantile random package
+ * Copyright (C) 2017 Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ *
+ * This package is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the COPYRIGHT_NOTICE for more details.
+ *
+ * Under Section 7 of GPL version 3, you are granted additional
+ * permissions described in the GCC Runtime Library Exception, version
+ * 3.1, as published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License and
+ * a copy of the GCC Runtime Library Exception along with this package;
+ * see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+ * <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+*  @file prefetched_sampler.hpp
+*  @brief Defines pqRand::prefetched_sampler, which samples a distribution
+*  in a background thread so that the calling thread only has to read the variates.
+*
+*  This header is not included by pqRand.hpp or distributions.hpp,
+*  because it requires threading support (e.g. compile and link with \c -pthread).
+*
+*  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+*  @date 2017
+*/
+
+#ifndef PREFETCHED_SAMPLER
+#define PREFETCHED_SAMPLER
+
+#include "distributions.hpp"
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <utility> // declval
+
+namespace pqRand
+{
+	/*! @brief What the producer thread of a \ref prefetched_sampler does
+	 *  while the ring is full (i.e. while waiting for the consumer to catch up).
+	*/
+	enum class backpressure
+	{
+		spin, //!< Busy-wait (lowest latency to resume, but burns a core).
+		yield, //!< Busy-wait, but yield the core to the scheduler every iteration.
+		sleep //!< Sleep in short intervals (cheapest, but slowest to resume).
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief A snapshot of the statistics of a \ref prefetched_sampler.
+	*/
+	struct prefetch_stats
+	{
+		uint64_t draws; //!< The number of variates read by the consumer.
+		uint64_t underruns; //!< The number of times the consumer found the ring empty (and had to wait).
+		uint64_t blocks; //!< The number of blocks sampled by the producer.
+		uint64_t stalls; //!< The number of times the producer found the ring full (and had to wait).
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief Sample a distribution in a dedicated producer thread,
+	 *  buffering the variates in a lock-free, single-producer/single-consumer ring.
+	 *
+	 *  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+	 *
+	 *  Some distributions have rare but expensive paths
+	 *  (e.g. engine::U_uneven when it has to top up its entropy,
+	 *  or the rejection loop of gammaDist), which create a long tail in
+	 *  the time needed to draw a single variate.
+	 *  prefetched_sampler moves all sampling to a background thread,
+	 *  which fills the ring one block at a time (using the batch path, distribution::Fill).
+	 *  When the ring is not empty, operator() is a single read from the ring.
+	 *
+	 *  The sampler owns a copy of the distribution and a copy of the engine.
+	 *  The consumer sees \em exactly the sequence that \c dist.Fill() would
+	 *  produce from the supplied state of the engine, so prefetching is repeatable.
+	 *  To use the supplied engine elsewhere (e.g. in another sampler),
+	 *  first give it an orthogonal sequence via Jump().
+	 *
+	 *  \warning operator() and Stats() may only be called from one thread (the consumer).
+	 *
+	 *  \param dist_t
+	 *  A distribution supplying <tt> Fill(T*, size_t, engine&) const </tt>
+	 *  (e.g. any class derived from pqRand::distribution).
+	*/
+	template<class dist_t>
+	class prefetched_sampler
+	{
+		public:
+			//! @brief The type of variate sampled by \p dist_t.
+			typedef decltype(std::declval<dist_t const&>()(std::declval<engine&>())) result_type;
+
+		private:
+			// The cache line size, to keep the producer and consumer from sharing their data
+			size_t static constexpr lineSize = 64;
+
+			dist_t const dist;
+			engine gen;
+			std::vector<result_type> ring;
+			size_t const mask; // ring.size() - 1, for a fast modulo of the ring position
+			size_t const blockSize;
+			backpressure const policy;
+
+			std::atomic<bool> running;
+
+			// Every position is a running count (never wrapped), so (tail - head) is the fill level
+			char pad0[lineSize];
+			std::atomic<size_t> head; // Written by the consumer; the position of the next unread variate
+			char pad1[lineSize - sizeof(std::atomic<size_t>)];
+			std::atomic<size_t> tail; // Written by the producer; one past the last finished variate
+			std::atomic<uint64_t> blocks;
+			std::atomic<uint64_t> stalls;
+			char pad2[lineSize - sizeof(std::atomic<size_t>) - 2*sizeof(std::atomic<uint64_t>)];
+
+			// Consumer-only state (never touched by the producer)
+			size_t next; // The next variate to read
+			size_t available; // The consumer's last view of tail
+			uint64_t underruns;
+
+			std::thread producer;
+
+			// The producer's loop: fill the ring one block at a time until the dtor stops it
+			void Produce()
+			{
+				size_t position = tail.load(std::memory_order_relaxed);
+
+				while(running.load(std::memory_order_relaxed))
+				{
+					// Wait until an entire block is free (the consumer has read it)
+					if((position + blockSize - head.load(std::memory_order_acquire)) > ring.size())
+					{
+						stalls.fetch_add(1, std::memory_order_relaxed);
+
+						while(running.load(std::memory_order_relaxed) and
+							((position + blockSize - head.load(std::memory_order_acquire)) > ring.size()))
+						{
+							switch(policy)
+							{
+								case backpressure::spin:
+								break;
+
+								case backpressure::yield:
+									std::this_thread::yield();
+								break;
+
+								case backpressure::sleep:
+									std::this_thread::sleep_for(std::chrono::microseconds(50));
+								break;
+							}
+						}
+						continue; // re-check running
+					}
+
+					// blockSize divides ring.size(), so a block never wraps around the ring
+					dist.Fill(ring.data() + (position bitand mask), blockSize, gen);
+					position += blockSize;
+
+					tail.store(position, std::memory_order_release);
+					blocks.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+
+			// The slow path of operator(), called once per block:
+			// release the block just read, then wait for the next block.
+			void Replenish()
+			{
+				head.store(next, std::memory_order_release);
+
+				if(tail.load(std::memory_order_acquire) == next)
+				{
+					++underruns;
+
+					while(tail.load(std::memory_order_acquire) == next)
+						std::this_thread::yield();
+				}
+
+				// The producer finishes whole blocks, so the next block is now ready.
+				// Only read one block at a time, so that each block is released promptly.
+				available = next + blockSize;
+			}
+
+			// Is x a non-zero power of two?
+			static bool IsPowerOf2(size_t const x) {return (x not_eq 0) and ((x bitand (x - 1)) == 0);}
+
+		public:
+			/*! @brief Copy the distribution and the engine, then launch the producer thread.
+			 *
+			 *  \param dist_in 	the distribution to sample
+			 *  \param gen_in 	the engine whose current state is used by the producer
+			 *  \param ringSize 	the number of variates the ring can hold
+			 *  \param blockSize_in 	the number of variates the producer samples at once
+			 *  \param policy_in 	what the producer does while the ring is full
+			 *
+			 *  \throws throws std::domain_error if \p ringSize or \p blockSize are not
+			 *  powers of two, or if (\p ringSize < 2 * \p blockSize).
+			*/
+			prefetched_sampler(dist_t const& dist_in, engine const& gen_in,
+				size_t const ringSize = (size_t(1) << 14), size_t const blockSize_in = 256,
+				backpressure const policy_in = backpressure::yield):
+				dist(dist_in), gen(gen_in), ring(ringSize),
+				mask(ringSize - 1), blockSize(blockSize_in), policy(policy_in),
+				running(true), head(0), tail(0), blocks(0), stalls(0),
+				next(0), available(0), underruns(0)
+			{
+				if(not (IsPowerOf2(ringSize) and IsPowerOf2(blockSize)))
+					throw std::domain_error("pqRand::prefetched_sampler: ringSize and blockSize must be powers of two!");
+				if(ringSize < 2 * blockSize)
+					throw std::domain_error("pqRand::prefetched_sampler: ringSize must be at least twice blockSize!");
+
+				// Launch the producer last, once everything it uses is initialized
+				producer = std::thread(&prefetched_sampler::Produce, this);
+			}
+
+			// The producer points to this object, so it cannot be copied or moved
+			prefetched_sampler(prefetched_sampler const&) = delete;
+			prefetched_sampler& operator = (prefetched_sampler const&) = delete;
+
+			//! @brief Stop and join the producer thread.
+			~prefetched_sampler()
+			{
+				running.store(false, std::memory_order_relaxed);
+				producer.join();
+			}
+
+			/*! @brief Read the next variate from the ring.
+			 *
+			 *  If the ring is empty, count an underrun and wait for the producer.
+			*/
+			result_type operator()()
+			{
+				if(next == available)
+					Replenish();
+
+				return ring[(next++) bitand mask];
+			}
+
+			//! @brief A snapshot of the sampler's statistics (call from the consumer thread).
+			prefetch_stats Stats() const
+			{
+				prefetch_stats stats;
+
+				stats.draws = next;
+				stats.underruns = underruns;
+				stats.blocks = blocks.load(std::memory_order_relaxed);
+				stats.stalls = stalls.load(std::memory_order_relaxed);
+
+				return stats;
+			}
+
+			inline size_t RingSize() const {return ring.size();} //!< The number of variates the ring holds.
+			inline size_t BlockSize() const {return blockSize;} //!< The number of variates sampled at once.
+	};
+}
+
+#endif
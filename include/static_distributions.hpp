@@ -0,0 +1,515 @@
+/* pqRand: The precise quantile random package
+ * Copyright (C) 2017 Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ *
+ * This package is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the COPYRIGHT_NOTICE for more details.
+ *
+ * Under Section 7 of GPL version 3, you are granted additional
+ * permissions described in the GCC Runtime Library Exception, version
+ * 3.1, as published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License and
+ * a copy of the GCC Runtime Library Exception along with this package;
+ * see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+ * <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+*  @file static_distributions.hpp
+*  @brief Defines pqRand::static_dist, the compile-time (non-virtual) form
+*  of the distributions with a closed-form sampler.
+*
+*  The polymorphic distributions in distributions.hpp make a virtual call
+*  for every variate (e.g. distributionQ2::operator() calls the virtual Q_small/Q_large).
+*  The classes in pqRand::static_dist mirror the polymorphic interface
+*  (distribution -> distributionPDF -> distributionCDF -> distributionQ2),
+*  but use the curiously recurring template pattern (CRTP) instead of virtual functions,
+*  so code which knows the distribution's type (e.g. a templated simulation kernel)
+*  can have an entire draw inlined into its loop.
+*
+*  The polymorphic classes (e.g. pqRand::exponential) are thin adapters
+*  around their static counterpart (e.g. pqRand::static_dist::exponential),
+*  so both produce the same variates from the same engine.
+*  This header is included by distributions.hpp.
+*
+*  @author Keith Pedersen (Keith.David.Pedersen@gmail.com)
+*  @date 2017
+*/
+
+#ifndef STATIC_DISTRIBUTIONS
+#define STATIC_DISTRIBUTIONS
+
+#include "pqRand.hpp"
+#include <cmath> // exp, log, log1p, pow
+#include <vector>
+
+namespace pqRand
+{
+	/*! @brief A simple struct to store a pair of real_t.
+	 *
+	 *  Used by std_normal and its children, since the
+	 *  Marsaglia polar generates two numbers per call.
+	 *
+	 *  \warning The default constructor does not initialize its members.
+	*/
+	struct two
+	{
+		real_t x;
+		real_t y;
+
+		//! @brief Initialized construction
+		two(real_t const x_in, real_t const y_in):
+			x(x_in), y(y_in) {}
+
+		two() {} //!< @brief \b Uninitialized construction
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////
+
+	/*! @brief The compile-time (CRTP) form of pqRand's closed-form distributions.
+	 *
+	 *  Each base class takes the derived class as its first template argument,
+	 *  and calls the derived class's functions without virtual dispatch:
+	 *  \code
+			template<class dist_t>
+			double Kernel(pqRand::static_dist::distribution<dist_t, pqRand::real_t> const& dist, pqRand::engine& gen);
+
+			pqRand::static_dist::exponential const expo(2.);
+			Kernel(expo, gen); // expo's operator() (and its Q_small/Q_large) are inlined into Kernel
+		\endcode
+	 *
+	 *  The rejection samplers (standard_normal and its children, gammaDist, ...)
+	 *  have no static form; they make at most one virtual call per proposal,
+	 *  which is negligible next to the proposal's transcendental functions.
+	*/
+	namespace static_dist
+	{
+		/*! @brief The math functions of the static distributions' formulas (libm).
+		 *
+		 *  Each formula (PDF_supported(), CDF_small_supported(), Q_small(), ...) takes its math functions 
+		 *  as a template parameter, which defaults to libm. The array functions of the polymorphic 
+		 *  distributions substitute pqRand's vectorized math, so each formula is only written once.
+		*/
+		struct libm
+		{
+			static real_t Exp(real_t const x) {return std::exp(x);}
+			static real_t Expm1(real_t const x) {return std::expm1(x);}
+			static real_t Log(real_t const x) {return std::log(x);}
+			static real_t Log1p(real_t const x) {return std::log1p(x);}
+			static real_t Pow(real_t const x, real_t const y) {return std::pow(x, y);}
+			static real_t Erfc(real_t const x) {return std::erfc(x);}
+		};
+		
+		// The formulas are forced inline, so an array function's loop can be vectorized around them
+		#if defined(__GNUC__)
+			#define PQR_FORMULA inline __attribute__((always_inline))
+		#else
+			#define PQR_FORMULA inline
+		#endif
+
+		/*! @brief The base of every static distribution (see pqRand::distribution).
+		 *
+		 *  \param derived_t 	the derived class, which must define min(), max() and
+		 *  <tt> T operator()(engine&) const </tt>
+		 *  \param T 	the type of variate
+		*/
+		template<class derived_t, typename T>
+		class distribution
+		{
+			protected:
+				derived_t const& Derived() const {return static_cast<derived_t const&>(*this);}
+
+			public:
+				//! @brief Sample a number of variates into an existing array (the inlined draw, in a loop).
+				void Fill(T* const sample, size_t const sampleSize, engine& gen) const
+				{
+					for(size_t i = 0; i < sampleSize; ++i)
+						sample[i] = Derived()(gen);
+				}
+
+				//! @brief Sample a number of variates and return them in a vector.
+				std::vector<T> GetSample(size_t const sampleSize, engine& gen) const
+				{
+					std::vector<T> sample(sampleSize);
+					Fill(sample.data(), sampleSize, gen);
+					return sample;
+				}
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*! @brief A static distribution with an analytic PDF (see pqRand::distributionPDF).
+		 *
+		 *  \param derived_t 	must also define <tt> PDF_supported(x) </tt>, Mean() and Variance().
+		*/
+		template<class derived_t>
+		class distributionPDF : public distribution<derived_t, real_t>
+		{
+			public:
+				//! @brief The probability distribution function (zero outside of [min, max]).
+				real_t PDF(real_t const x) const
+				{
+					derived_t const& dist = this->Derived();
+					return ((x >= dist.min()) and (x <= dist.max())) ? dist.PDF_supported(x) : real_t(0);
+				}
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*! @brief A static distribution with a calculable CDF (see pqRand::distributionCDF).
+		 *
+		 *  \param derived_t 	must also define <tt> CDF_small_supported(x) </tt>
+		 *  and <tt> CDF_large_supported(x) </tt>.
+		*/
+		template<class derived_t>
+		class distributionCDF : public distributionPDF<derived_t>
+		{
+			public:
+				//! @brief The cumulative distribution function.
+				real_t CDF(real_t const x) const
+				{
+					derived_t const& dist = this->Derived();
+
+					if(x <= dist.min()) return real_t(0);
+					else if (x >= dist.max()) return real_t(1);
+					else return dist.CDF_small_supported(x);
+				}
+
+				//! @brief The accurate complementary CDF (i.e. 1 - CDF(x), without cancellation).
+				real_t CompCDF(real_t const x) const
+				{
+					derived_t const& dist = this->Derived();
+
+					if(x >= dist.max()) return real_t(0);
+					else if (x <= dist.min()) return real_t(1);
+					else return dist.CDF_large_supported(x);
+				}
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		/*! @brief A static distribution with an invertible CDF,
+		 *  sampled by a quantile flip-flop (see pqRand::distributionQ2).
+		 *
+		 *  \param derived_t 	must also define <tt> Q_small(u) </tt> and <tt> Q_large(u) </tt>.
+		*/
+		template<class derived_t>
+		class distributionQ2 : public distributionCDF<derived_t>
+		{
+			public:
+				/*! @brief Sample one variate using a quantile flip-flop
+				 *  (the same draws as pqRand::distributionQ2::operator()).
+				*/
+				real_t operator()(engine& gen) const
+				{
+					if(gen.RandBool())
+						return this->Derived().Q_small(gen.HalfU_uneven());
+					else
+						return this->Derived().Q_large(gen.HalfU_uneven());
+				}
+
+				//! @brief Sample antithetic variates (same u through both Q).
+				two GetTwo_antithetic(engine& gen) const
+				{
+					real_t const hu = gen.HalfU_uneven();
+					return two(this->Derived().Q_small(hu), this->Derived().Q_large(hu));
+				}
+		};
+
+		/////////////////////////////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////
+
+		//! @brief The static form of pqRand::uniform (the closed interval [min, max]).
+		class uniform : public distributionCDF<uniform>
+		{
+			private:
+				real_t min_;
+				real_t spread;
+
+			public:
+				//! @throws throws std::domain_error if (\p max <= \p min).
+				uniform(real_t const min, real_t const max):
+					min_(min), spread(max - min)
+				{
+					if(spread <= real_t(0)) throw std::domain_error("pqRand::uniform: max must be greater than min.");
+				}
+
+				inline real_t min() const {return min_;}
+				inline real_t max() const {return min_ + spread;}
+
+				real_t Mean() const {return real_t(0.5)*(min() + max());}
+				real_t Variance() const {return Squared(max() - min())/real_t(12);}
+
+				real_t operator()(engine& gen) const {return min_ + spread * gen.U_uneven();}
+
+				template<class math = libm>
+				PQR_FORMULA real_t PDF_supported(real_t const) const {return real_t(1)/spread;}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_small_supported(real_t const x) const {return (x - min())/spread;}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_large_supported(real_t const x) const {return (max() - x)/spread;}
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		//! @brief The static form of pqRand::pareto.
+		class pareto : public distributionCDF<pareto>
+		{
+			private:
+				real_t xMin;
+				real_t alpha_;
+				real_t negRecipAlpha;
+				real_t alpha_xM2alpha;
+
+			public:
+				//! @throws throws std::domain_error if either parameter is non-positive.
+				pareto(real_t const xMin_in, real_t const alpha):
+					xMin(xMin_in), alpha_(alpha), negRecipAlpha(-real_t(1)/alpha_),
+					alpha_xM2alpha(alpha_*std::pow(xMin, alpha_))
+				{
+					if(xMin <= real_t(0))
+						throw std::domain_error("pqRand::pareto: x_m must be greater than zero!");
+					if(negRecipAlpha >= real_t(0))
+						throw std::domain_error("pqRand::pareto: alpha must be greater than zero!");
+				}
+
+				inline real_t min() const {return xMin;}
+				inline real_t max() const {return INFINITY;}
+
+				real_t Mean() const
+				{
+					return (alpha_ <= real_t(1)) ? INFINITY : alpha_ * xMin / (alpha_ - real_t(1));
+				}
+
+				real_t Variance() const
+				{
+					return (alpha_ <= real_t(2)) ? INFINITY :
+						alpha_ * Squared(xMin) / (Squared(alpha_ - real_t(1)) * (alpha_ - real_t(2)));
+				}
+
+				real_t operator()(engine& gen) const {return xMin * std::pow(gen.U_uneven(), negRecipAlpha);}
+
+				template<class math = libm>
+				PQR_FORMULA real_t PDF_supported(real_t const x) const {return math::Pow(x, -(alpha_ + real_t(1)))*alpha_xM2alpha;}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_small_supported(real_t const x) const {return -math::Expm1(alpha_ * math::Log(xMin/x));}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_large_supported(real_t const x) const {return math::Exp(alpha_ * math::Log(xMin/x));}
+
+				inline real_t Alpha() const {return alpha_;} //!< The Pareto index
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		//! @brief The static form of pqRand::weibull.
+		class weibull : public distributionQ2<weibull>
+		{
+			private:
+				real_t lambda_;
+				real_t k_;
+				real_t kRecip;
+
+			public:
+				//! @throws throws std::domain_error if either parameter is non-positive.
+				weibull(real_t const lambda, real_t const k):
+					lambda_(lambda), k_(k), kRecip(real_t(1)/k_)
+				{
+					if(lambda_ <= real_t(0))
+						throw std::domain_error("pqRand::weibull: lambda must be greater than zero!");
+					if(kRecip <= real_t(0))
+						throw std::domain_error("pqRand::weibull: k must be greater than zero!");
+				}
+
+				inline real_t min() const {return 0;}
+				inline real_t max() const {return INFINITY;}
+
+				real_t Mean() const {return lambda_ * std::tgamma(real_t(1) + real_t(1) / k_);}
+
+				real_t Variance() const
+				{
+					return Squared(lambda_) *
+						(std::tgamma(real_t(1) + real_t(2) / k_) -
+							Squared(std::tgamma(real_t(1) + real_t(1) / k_)));
+				}
+
+				template<class math = libm>
+				PQR_FORMULA real_t PDF_supported(real_t const x) const
+				{
+					real_t const xOverLambda = x / lambda_;
+					real_t const xl2kminus1 = math::Pow(xOverLambda, k_ - real_t(1));
+
+					return (math::Exp(-xl2kminus1 * xOverLambda) * xl2kminus1 * k_)/lambda_;
+				}
+
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_small_supported(real_t const x) const {return -math::Expm1(-math::Pow(x/lambda_, k_));}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_large_supported(real_t const x) const {return math::Exp(-math::Pow(x/lambda_, k_));}
+
+				template<class math = libm>
+				PQR_FORMULA real_t Q_small(real_t const u) const {return lambda_ * math::Pow(-math::Log1p(-u), kRecip);}
+				template<class math = libm>
+				PQR_FORMULA real_t Q_large(real_t const u) const {return lambda_ * math::Pow(-math::Log(u), kRecip);}
+
+				inline real_t Lambda() const {return lambda_;} //!< The scale parameter.
+				inline real_t k() const {return k_;} //!< The shape parameter.
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		//! @brief The static form of pqRand::exponential.
+		class exponential : public distributionQ2<exponential>
+		{
+			private:
+				real_t lambda_;
+
+			public:
+				//! @throws throws std::domain_error if (\p lambda <= 0).
+				exponential(real_t const lambda):
+					lambda_(lambda)
+				{
+					if(lambda_ <= real_t(0))
+						throw std::domain_error("pqRand::exponential: lambda must be greater than zero!");
+				}
+
+				inline real_t min() const {return 0;}
+				inline real_t max() const {return INFINITY;}
+
+				real_t Mean() const {return real_t(1)/lambda_;}
+				real_t Variance() const {return real_t(1)/Squared(lambda_);}
+
+				template<class math = libm>
+				PQR_FORMULA real_t PDF_supported(real_t const x) const {return lambda_ * math::Exp(-lambda_ * x);}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_small_supported(real_t const x) const {return -math::Expm1(-lambda_ * x);}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_large_supported(real_t const x) const {return math::Exp(-lambda_ * x);}
+
+				template<class math = libm>
+				PQR_FORMULA real_t Q_small(real_t const u) const {return -math::Log1p(-u)/lambda_;}
+				template<class math = libm>
+				PQR_FORMULA real_t Q_large(real_t const u) const {return -math::Log(u)/lambda_;}
+
+				inline real_t Lambda() const {return lambda_;} //!< The rate parameter
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		//! @brief The static form of pqRand::logistic.
+		class logistic : public distributionQ2<logistic>
+		{
+			private:
+				real_t mu_;
+				real_t s_;
+
+			public:
+				//! @throws throws std::domain_error if the (\p scale <= 0).
+				logistic(real_t const mu, real_t const s):
+					mu_(mu), s_(s)
+				{
+					if(s_ <= real_t(0))
+						throw std::domain_error("pqRand::logistic: s must be greater than zero!");
+				}
+
+				inline real_t min() const {return -INFINITY;}
+				inline real_t max() const {return INFINITY;}
+
+				real_t Mean() const {return mu_;}
+				real_t Variance() const {return Squared(s_ * M_PI)/real_t(3);}
+
+				template<class math = libm>
+				PQR_FORMULA real_t PDF_supported(real_t const x) const
+				{
+					real_t const expTerm = math::Exp(-(x-mu_)/s_);
+
+					return expTerm/(s_ * Squared(real_t(1) + expTerm));
+				}
+
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_small_supported(real_t const x) const {return real_t(1) / (real_t(1) + math::Exp(-(x-mu_)/s_));}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_large_supported(real_t const x) const {return real_t(1) / (real_t(1) + math::Exp((x-mu_)/s_));}
+
+				template<class math = libm>
+				PQR_FORMULA real_t Q_small(real_t const u) const {return mu_ - s_ * math::Log(real_t(1)/u - real_t(1));}
+				template<class math = libm>
+				PQR_FORMULA real_t Q_large(real_t const u) const {return mu_ + s_ * math::Log(real_t(1)/u - real_t(1));}
+
+				inline real_t Mu() const {return mu_;} //!< The mean
+				inline real_t s() const {return s_;} //!< The scale
+		};
+
+		/////////////////////////////////////////////////////////////////////
+
+		//! @brief The static form of pqRand::log_logistic.
+		class log_logistic : public distributionQ2<log_logistic>
+		{
+			private:
+				real_t alpha_;
+				real_t beta_;
+				real_t betaInverse;
+
+			public:
+				//! @throws throws std::domain_error if either parameter is non-positive.
+				log_logistic(real_t const alpha, real_t const beta):
+					alpha_(alpha), beta_(beta), betaInverse(real_t(1)/beta_)
+				{
+					if(alpha_ <= real_t(0))
+						throw std::domain_error("pqRand::log_logistic: alpha must be greater than zero!");
+					if(beta_ <= real_t(0))
+						throw std::domain_error("pqRand::log_logistic: beta must be greater than zero!");
+				}
+
+				inline real_t min() const {return 0;}
+				inline real_t max() const {return INFINITY;}
+
+				real_t Mean() const
+				{
+					return (beta_ <= real_t(1)) ? INFINITY :
+						(alpha_*M_PI)/(beta_ * std::sin(M_PI / beta_));
+				}
+
+				real_t Variance() const
+				{
+					if (beta_ <= real_t(2)) return INFINITY;
+
+					real_t const b = M_PI / beta_;
+
+					return Squared(alpha_) * (b * (real_t(1)/std::cos(b) - b / std::sin(b)))/std::sin(b);
+				}
+
+				template<class math = libm>
+				PQR_FORMULA real_t PDF_supported(real_t const x) const
+				{
+					real_t const xOverAlpha = x/alpha_;
+					real_t const xOverAlpha2betaMinus1 = math::Pow(xOverAlpha, beta_ - real_t(1));
+
+					return (xOverAlpha2betaMinus1 * beta_) /
+						(alpha_ * Squared(real_t(1) + xOverAlpha2betaMinus1 * xOverAlpha));
+				}
+
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_small_supported(real_t const x) const {return real_t(1) / (real_t(1) + math::Pow(x/alpha_, -beta_));}
+				template<class math = libm>
+				PQR_FORMULA real_t CDF_large_supported(real_t const x) const {return real_t(1) / (real_t(1) + math::Pow(x/alpha_, beta_));}
+
+				template<class math = libm>
+				PQR_FORMULA real_t Q_small(real_t const u) const {return alpha_ * math::Pow(real_t(1)/u - real_t(1), -betaInverse);}
+				template<class math = libm>
+				PQR_FORMULA real_t Q_large(real_t const u) const {return alpha_ * math::Pow(real_t(1)/u - real_t(1), betaInverse);}
+
+				inline real_t Alpha() const {return alpha_;} //!< The scale
+				inline real_t Beta() const {return beta_;} //!< The shape
+		};
+	}
+}
+
+#endif
@@ -17,12 +17,17 @@
 from sys import version_info
 from distutils.core import setup
 from distutils.extension import Extension
+from numpy import get_include
 
-flags = ['-std=c++11', '-mfpmath=sse', '-mieee-fp', '-march=native', '-ftree-vectorize'] # -O2 is default
+from os import environ
+# Build for this CPU (native), or for a baseline to run anywhere (e.g. "MARCH=x86-64 python3 setup_pYqRand.py ..."),
+# like libpqr's Makefile; no contraction (FMA), so the header's inline math matches every tier of libpqr
+march = environ.get('MARCH', 'native')
+flags = ['-std=c++11', '-mfpmath=sse', '-mieee-fp', '-march=' + march, '-ftree-vectorize', '-ffp-contract=off', '-fno-trapping-math'] # -O2 is default
 
 from subprocess import check_output
-# Add CPU specific flags to accelerate vector math
-extraFlags = check_output(["sh", "getSSE_AVX.sh"]).split()
+# Add CPU specific flags to accelerate vector math (only when building for this CPU)
+extraFlags = check_output(["sh", "getSSE_AVX.sh"]).split() if (march == 'native') else []
 
 # convert 'bytes' to string in python3, and 
 if (version_info > (3, 0)):
@@ -32,30 +37,41 @@ if (version_info > (3, 0)):
 flags += extraFlags
 
 try:
-	from Cython.Distutils import build_ext
+	from Cython.Build import cythonize
 
 	# This build script leverages the pre-compiled pqRand library (libpqr.so), 
 	# a library which must be accessible from anywhere you intend to use pYqRand.
 	# This keeps the C-compilation of pYqRand.pyx to a minimal (so the Python module is smaller),
 	# and allows different compile flags to be used for the Cython build.
+	# The C++ is generated in ./build, leaving source/pYqRand.cpp (the file made by "make pyx") alone.
 	setup(
 		name = "pYqRand",
-		ext_modules=[
+		ext_modules=cythonize([
 			Extension('pYqRand', # <=This name must be the same as *.pYx file
-				sources=['source/pYqRand.pyx'], # But be careful, *.pYx is automatically converted to *.cpp (overwriting ANY existing file without asking)
-				include_dirs = ['./include'],
+				sources=['source/pYqRand.pyx'],
+				include_dirs = ['./include', get_include()], # pYqRand uses numpy's C-API
 				libraries = ['pqr'], # We must build against libpqr.so
 				library_dirs = ['./lib'],
 				extra_compile_args=flags,
 						  language='c++')
-				 ], cmdclass = {'build_ext': build_ext})
+				 ], build_dir = 'build'))
 except ImportError:
+	# Without Cython, build the C++ generated by "make pyx", but only if it came from the current .pyx
+	# (otherwise pYqRand would silently lack whatever the .pyx has gained since)
+	from hashlib import sha256
+	with open('source/pYqRand.pyx', 'rb') as pyx:
+		stamp = 'pYqRand.pyx sha256: ' + sha256(pyx.read()).hexdigest()
+	with open('source/pYqRand.cpp') as cpp:
+		if stamp not in cpp.read():
+			raise SystemExit("setup_pYqRand.py: Cython is not installed, and source/pYqRand.cpp is out of date "
+				+ "(it was not generated from the current source/pYqRand.pyx). Install Cython, or run \"make pyx\".")
+	
 	setup(
 		name = "pYqRand",
 		ext_modules=[
 			Extension('pYqRand', # <=This name must be the same as *.pYx file
-				sources=['source/pYqRand.cpp'], # But be careful, *.pYx is automatically converted to *.cpp (overwriting ANY existing file without asking)
-				include_dirs = ['./include'],
+				sources=['source/pYqRand.cpp'],
+				include_dirs = ['./include', get_include()], # pYqRand uses numpy's C-API
 				libraries = ['pqr'], # We must build against libpqr.so
 				library_dirs = ['./lib'],
 				extra_compile_args=flags,
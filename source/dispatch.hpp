@@ -0,0 +1,75 @@
+/* pqRand: The precise quantile random package
+ * Copyright (C) 2017 Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ * 
+ * This package is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  
+ * See the COPYRIGHT_NOTICE for more details.
+ * 
+ * Under Section 7 of GPL version 3, you are granted additional
+ * permissions described in the GCC Runtime Library Exception, version
+ * 3.1, as published by the Free Software Foundation.
+ * 
+ * You should have received a copy of the GNU General Public License and
+ * a copy of the GCC Runtime Library Exception along with this package;
+ * see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+ * <http://www.gnu.org/licenses/>.
+*/
+
+// Internal to libpqr: compile an array kernel once per tier of pqRand::isa.
+//
+// A kernel's loop is written once (as a template or an always_inline function),
+// then instantiated inside a wrapper carrying each tier's target attribute,
+// so the compiler vectorizes the same source with that tier's instructions.
+// PQR_DISPATCH then calls the wrapper for pqRand::ActiveISA().
+//
+// Every tier must produce bit-identical output, so a kernel may only use
+// correctly-rounded operations (+ - * / sqrt, conversions, bit manipulation)
+// and libm calls (which are the same function in every tier).
+// Contraction into fused multiply-add is disabled by -ffp-contract=off (see the Makefile).
+
+#ifndef PQRAND_DISPATCH
+#define PQRAND_DISPATCH
+
+#include "../include/pqRand.hpp"
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+	#define PQR_CAN_DISPATCH 1
+	#define PQR_TARGET_AVX2 __attribute__((target("avx2")))
+	#define PQR_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512dq,avx512vl")))
+#else
+	#define PQR_CAN_DISPATCH 0
+	#define PQR_TARGET_AVX2
+	#define PQR_TARGET_AVX512
+#endif
+
+#define PQR_ALWAYS_INLINE inline __attribute__((always_inline))
+
+// Force an array kernel's lambda inline into each tier's loop
+// (a kernel built from pqRand::vmath easily exceeds the inliner's size limits).
+#define PQR_KERNEL __attribute__((always_inline))
+
+/* Define name_baseline, name_avx2 and name_avx512, each calling body(args...),
+ * where params is the parenthesized parameter list and args the parenthesized arguments.
+ * The body must be PQR_ALWAYS_INLINE (or a template), so it is compiled for each tier.
+*/
+#define PQR_DEFINE_TIERS(name, body, params, args) \
+	static void name##_baseline params {body args;} \
+	PQR_TARGET_AVX2 static void name##_avx2 params {body args;} \
+	PQR_TARGET_AVX512 static void name##_avx512 params {body args;}
+
+// Call the tier of name selected by pqRand::ActiveISA()
+#define PQR_DISPATCH(name, args) \
+	switch(pqRand::ActiveISA()) \
+	{ \
+		case pqRand::isa::avx512: name##_avx512 args; break; \
+		case pqRand::isa::avx2: name##_avx2 args; break; \
+		default: name##_baseline args; break; \
+	}
+
+#endif
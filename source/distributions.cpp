@@ -22,21 +22,184 @@
 */
 
 #include "../include/distributions.hpp"
+#include "dispatch.hpp"
+#include "vector_math.hpp"
+#include <thread>
+#include <mutex>
+#include <algorithm> // min, max, equal
+#include <cstdio> // snprintf, rename
+#include <cstring> // memcpy
+#include <fstream>
+#include <typeinfo> // typeid (the key of a quantile_table)
+
+// Table files are memory-mapped where POSIX mmap exists (otherwise they are read into memory)
+#if defined(__unix__) or defined(__APPLE__)
+	#define PQR_TABLE_MMAP 1
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#else
+	#define PQR_TABLE_MMAP 0
+#endif
+
+// Exact floating-point equality (e.g. a zero weight, or a converged sum), without == 
+// (which -Wfloat-equal flags, since it is usually a mistake). Like ==, NaN equals nothing.
+static bool ExactlyEqual(pqRand::real_t const a, pqRand::real_t const b)
+{
+	return (a <= b) and (a >= b);
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// Apply a non-virtual kernel to each element of an array (out may alias in).
+// The kernel (a PQR_KERNEL lambda) is inlined into a loop without branches, which the compiler can vectorize
+// (once per tier of pqRand::isa; see dispatch.hpp).
+// The closed-form distributions' kernels call their scalar formulas with libm replaced by
+// pqRand::vmath (the math template parameter of static_dist's formulas, and of the normal formulas below). 
+// Each vmath call is within 1 ulp (like libm's), 
+// so the array and scalar functions agree to within the formula's conditioning
+// (a few ulp, more where e.g. log(x) - mu cancels).
+// A kernel captures a copy of its static_dist (rather than this), so the closure holds the parameters.
+template<class kernel_t>
+PQR_ALWAYS_INLINE void ApplyKernel_Loop(pqRand::real_t const* const in, pqRand::real_t* const out, 
+	size_t const n, kernel_t const& kernel)
+{
+	for(size_t i = 0; i < n; ++i)
+		out[i] = kernel(in[i]);
+}
+
+template<class kernel_t>
+void ApplyKernel_baseline(pqRand::real_t const* const in, pqRand::real_t* const out, 
+	size_t const n, kernel_t const& kernel) {ApplyKernel_Loop(in, out, n, kernel);}
+
+template<class kernel_t>
+PQR_TARGET_AVX2 void ApplyKernel_avx2(pqRand::real_t const* const in, pqRand::real_t* const out, 
+	size_t const n, kernel_t const& kernel) {ApplyKernel_Loop(in, out, n, kernel);}
+
+template<class kernel_t>
+PQR_TARGET_AVX512 void ApplyKernel_avx512(pqRand::real_t const* const in, pqRand::real_t* const out, 
+	size_t const n, kernel_t const& kernel) {ApplyKernel_Loop(in, out, n, kernel);}
+
+template<class kernel_t>
+inline void ApplyKernel(pqRand::real_t const* const in, pqRand::real_t* const out, 
+	size_t const n, kernel_t const& kernel)
+{
+	PQR_DISPATCH(ApplyKernel, (in, out, n, kernel))
+}
 
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+template<typename T>
+void pqRand::distribution<T>::Fill(T* const sample, size_t const sampleSize, engine& gen) const
+{
+	for(size_t i = 0; i < sampleSize; ++i)
+		sample[i] = (*this)(gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
 template<typename T>
 std::vector<T> pqRand::distribution<T>::GetSample(size_t const sampleSize, engine& gen) const
 {
-	std::vector<T> sample;
-	sample.reserve(sampleSize);
+	std::vector<T> sample(sampleSize);
+	this->Fill(sample.data(), sampleSize, gen);
 	
-	for(size_t i = 0; i < sampleSize; ++i)
-		sample.push_back((*this)(gen));
+	return sample;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+#if PRNG_CAN_JUMP
+// Call blockFunction(block, blockGen) for every block in [0, numBlocks), on up to numThreads_in threads
+// (all hardware threads when it is zero), where blockGen is gen's block-th jump.
+// Threads claim the next block, copying gen then jumping it for the next claim,
+// so the blocks do not depend on the number of threads.
+// The jumps are serial, but they are cheap compared to sampling a whole block.
+template<class blockFunction_t>
+static void ForEachJumpedBlock(size_t const numBlocks, size_t const numThreads_in, 
+	pqRand::engine& gen, blockFunction_t const& blockFunction)
+{
+	size_t const numThreads = std::max(size_t(1), std::min(numBlocks, 
+		(numThreads_in > 0) ? numThreads_in : size_t(std::thread::hardware_concurrency())));
+	
+	size_t nextBlock = 0;
+	std::mutex claim;
+	
+	auto const Worker = [&]()
+	{
+		pqRand::engine blockGen(false); // Don't auto-seed, we copy gen's state
+		
+		while(true)
+		{
+			size_t block;
+			{
+				std::lock_guard<std::mutex> lock(claim);
+				
+				if(nextBlock == numBlocks) 
+					return;
+				block = nextBlock++;
+				
+				blockGen = gen;
+				gen.Jump();
+			}
+			blockGen.DiscardBitCache();
+			
+			blockFunction(block, blockGen);
+		}
+	};
+	
+	std::vector<std::thread> threads;
+	for(size_t t = 1; t < numThreads; ++t)
+		threads.emplace_back(Worker);
+	
+	Worker(); // This thread works too
+	
+	for(auto& thread : threads)
+		thread.join();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+size_t constexpr pqRand::distribution<T>::parallelBlockSize;
+
+template<typename T>
+void pqRand::distribution<T>::Fill_Parallel(T* const sample, size_t const sampleSize, 
+	engine& gen, size_t const numThreads) const
+{
+	size_t const numBlocks = (sampleSize + parallelBlockSize - 1) / parallelBlockSize;
+	
+	ForEachJumpedBlock(numBlocks, numThreads, gen, [&](size_t const block, engine& blockGen)
+	{
+		size_t const begin = block * parallelBlockSize;
+		this->Fill(sample + begin, std::min(parallelBlockSize, sampleSize - begin), blockGen);
+	});
+}
+
+////////////////////////////////////////////////////////////////////////
 
+template<typename T>
+std::vector<T> pqRand::distribution<T>::GetSample_Parallel(size_t const sampleSize, 
+	engine& gen, size_t const numThreads) const
+{
+	std::vector<T> sample(sampleSize);
+	this->Fill_Parallel(sample.data(), sampleSize, gen, numThreads);
+	
 	return sample;
 }
+#endif
+
+////////////////////////////////////////////////////////////////////////
+
+// Instantiate the interface for every type a distribution returns
+template class pqRand::distribution<pqRand::real_t>;
+template class pqRand::distribution<int32_t>;
+template class pqRand::distribution<int64_t>;
+template class pqRand::distribution<uint32_t>;
+template class pqRand::distribution<uint64_t>;
 
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
@@ -67,7 +230,15 @@ template<typename int_t>
 int_t pqRand::uniform_integer<int_t>::operator()(pqRand::engine& gen) const
 {
 	rand_t x;
+	
+	#if PQR_REJECTION_STATS
+	uint64_t proposals = 1;
+	while((x = (gen() >> rightShift)) > maxRand)
+		++proposals;
+	rejections.Record(proposals);
+	#else
 	while((x = (gen() >> rightShift)) > maxRand);
+	#endif
 	
 	return int_t(x % spread) + min_;
 }
@@ -79,628 +250,2935 @@ template class pqRand::uniform_integer<uint32_t>;
 template class pqRand::uniform_integer<uint64_t>;
 
 ////////////////////////////////////////////////////////////////////////
-
 ////////////////////////////////////////////////////////////////////////
+
+// The table files of discrete and quantile_table (see "table_files" in distributions.hpp).
+// A file is a table_header, then each section of the table, each starting on a 64-byte boundary.
+// The header records everything the sections' layout depends on, so a file is only used 
+// by the same version of the format, on a machine of the same byte order and word sizes.
+// Section 0 is the table's key (the material it was built from, e.g. discrete's weights), 
+// so a file is only used for the same key, byte-for-byte (a hash of the key could collide).
+
+static constexpr char tableMagic[8] = {'p', 'q', 'R', 't', 'a', 'b', 'l', 'e'};
+static constexpr uint32_t tableVersion = 2;
+static constexpr uint64_t tableByteOrder = 0x0102030405060708; // Reads differently in the other byte order
+static constexpr size_t tableAlignment = 64;
+static constexpr size_t maxTableSections = 6; // Including the key
+
+enum class table_kind : uint32_t {discrete = 1, quantile = 2};
+
+struct table_header
+{
+	char magic[8]; // tableMagic
+	uint32_t version; // tableVersion
+	uint32_t kind; // table_kind
+	uint32_t realBytes; // sizeof(real_t)
+	uint32_t indexBytes; // sizeof(index_t) (discrete) or order (quantile_table)
+	uint64_t byteOrder; // tableByteOrder
+	uint64_t numSections;
+	uint64_t sectionBytes[maxTableSections];
+};
+
+struct table_section
+{
+	void const* data;
+	size_t bytes;
+};
+
+static size_t TableAlign(size_t const bytes)
+{
+	return ((bytes + tableAlignment - 1) / tableAlignment) * tableAlignment;
+}
+
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::distributionPDF::PDF(real_t const x) const
+// Write a table file (sections[0] is the key), via a temporary file renamed over filePath 
+// (so a job mapping filePath at the same time never sees a partial table)
+static void WriteTable(std::string const& filePath, table_kind const kind, uint32_t const indexBytes, 
+	std::vector<table_section> const& sections)
 {
-	if((x >= min()) and (x <= max()))
-		return this->PDF_supported(x);
-	else 
-		return real_t(0);
+	assert(sections.size() <= maxTableSections);
+	
+	table_header header = table_header();
+	std::memcpy(header.magic, tableMagic, sizeof(header.magic));
+	header.version = tableVersion;
+	header.kind = uint32_t(kind);
+	header.realBytes = uint32_t(sizeof(pqRand::real_t));
+	header.indexBytes = indexBytes;
+	header.byteOrder = tableByteOrder;
+	header.numSections = sections.size();
+	for(size_t i = 0; i < sections.size(); ++i)
+		header.sectionBytes[i] = sections[i].bytes;
+	
+	#if PQR_TABLE_MMAP
+		std::string const tempPath = filePath + ".partial." + std::to_string(getpid());
+	#else
+		std::string const tempPath = filePath + ".partial";
+	#endif
+	
+	{
+		std::ofstream file(tempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		
+		if(not file.is_open())
+		{
+			throw std::ofstream::failure("pqRand::WriteTable ... table file <"
+				+ tempPath + "> ... cannot be created!");
+		}
+		
+		char const padding[tableAlignment] = {};
+		
+		file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		file.write(padding, std::streamsize(TableAlign(sizeof(header)) - sizeof(header)));
+		
+		for(table_section const& section : sections)
+		{
+			file.write(static_cast<char const*>(section.data), std::streamsize(section.bytes));
+			file.write(padding, std::streamsize(TableAlign(section.bytes) - section.bytes));
+		}
+		
+		file.close();
+		
+		if(file.fail())
+		{
+			std::remove(tempPath.c_str());
+			throw std::ofstream::failure("pqRand::WriteTable ... table file <"
+				+ tempPath + "> ... cannot be written!");
+		}
+	}
+	
+	#if not PQR_TABLE_MMAP
+		std::remove(filePath.c_str()); // rename does not replace an existing file everywhere
+	#endif
+	
+	if(std::rename(tempPath.c_str(), filePath.c_str()) not_eq 0)
+	{
+		std::remove(tempPath.c_str());
+		throw std::ofstream::failure("pqRand::WriteTable ... table file <"
+			+ filePath + "> ... cannot be created or replaced!");
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::two pqRand::MeanAndVariance(distributionPDF const& dist,
-	size_t const sampleSize, engine& gen)
+// Map a table file read-only and point each section at its data,
+// returning the storage which keeps the map alive (or nothing, if the file is missing or not this table).
+// On input, sections[0] is the table's key, which the file's key must equal byte-for-byte.
+static std::shared_ptr<void const> MapTable(std::string const& filePath, table_kind const kind, 
+	uint32_t const indexBytes, std::vector<table_section>& sections)
 {
-	real_t sum = real_t(0);
-	real_t sum2 = real_t(0);
+	std::shared_ptr<void const> storage;
+	size_t fileBytes = 0;
 	
+	#if PQR_TABLE_MMAP
 	{
-		auto const sample = dist.GetSample(sampleSize, gen);
-						
-		for(real_t const x : sample)
+		int const descriptor = open(filePath.c_str(), O_RDONLY);
+		if(descriptor < 0) return nullptr;
+		
+		struct stat status;
+		if((fstat(descriptor, &status) == 0) and (status.st_size > 0))
 		{
-			sum += x;
-			sum2 += Squared(x);
+			fileBytes = size_t(status.st_size);
+			void* const address = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, descriptor, 0);
+			
+			if(address not_eq MAP_FAILED)
+				storage.reset(address, [fileBytes](void const* const map) {munmap(const_cast<void*>(map), fileBytes);});
 		}
+		
+		close(descriptor); // The map outlives the descriptor
 	}
+	#else
+	{
+		std::ifstream file(filePath.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+		if(not file.is_open()) return nullptr;
+		
+		fileBytes = size_t(file.tellg());
+		file.seekg(0);
+		
+		// Read into 64-bit words, so the sections are aligned for real_t and index_t
+		auto const buffer = std::make_shared<std::vector<uint64_t>>((fileBytes + 7) / 8);
+		
+		if(file.read(reinterpret_cast<char*>(buffer->data()), std::streamsize(fileBytes)))
+			storage = std::shared_ptr<void const>(buffer, buffer->data());
+	}
+	#endif
 	
-	real_t const n = real_t(sampleSize);
+	table_header header;
+	if(not (storage and (fileBytes >= sizeof(header)))) return nullptr;
 	
-	// This may not be the most accurate method to get the standard deviation using floats
-	return two(sum / n, sum2 / n - Squared(sum) / Squared(n));
+	char const* const data = static_cast<char const*>(storage.get());
+	std::memcpy(&header, data, sizeof(header));
+	
+	bool const thisTable = (std::memcmp(header.magic, tableMagic, sizeof(tableMagic)) == 0) 
+		and (header.version == tableVersion) and (header.kind == uint32_t(kind)) 
+		and (header.realBytes == sizeof(pqRand::real_t)) and (header.indexBytes == indexBytes) 
+		and (header.byteOrder == tableByteOrder) and (header.numSections == sections.size())
+		and (header.sectionBytes[0] == sections[0].bytes);
+	
+	if(not thisTable) return nullptr;
+	
+	table_section const key = sections[0];
+	
+	// Every section must be in the file
+	size_t offset = TableAlign(sizeof(header));
+	
+	for(size_t i = 0; i < sections.size(); ++i)
+	{
+		if((offset > fileBytes) or (header.sectionBytes[i] > (fileBytes - offset))) return nullptr;
+		
+		sections[i].data = data + offset;
+		sections[i].bytes = size_t(header.sectionBytes[i]);
+		offset += TableAlign(sections[i].bytes);
+	}
+	
+	if((key.bytes > 0) and (std::memcmp(sections[0].data, key.data, key.bytes) not_eq 0)) return nullptr;
+	
+	return storage;
 }
 
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::distributionCDF::CDF(real_t const x) const
+// Check the weights before the members are built from them
+template<typename index_t>
+static index_t Discrete_NumCategories(std::vector<pqRand::real_t> const& weights)
 {
-	if(x <= min()) return real_t(0);
-	else if (x >= max()) return real_t(1);
-	else return this->CDF_small_supported(x);
+	if(weights.empty())
+		throw std::domain_error("pqRand::discrete: there must be at least one weight");
+	if(weights.size() > size_t(std::numeric_limits<index_t>::max()))
+		throw std::domain_error("pqRand::discrete: too many weights for index_t");
+		
+	return index_t(weights.size());
 }
 
-////////////////////////////////////////////////////////////////////////
+template<typename index_t>
+constexpr size_t pqRand::discrete<index_t>::fillChunk;
 
-typename pqRand::real_t pqRand::distributionCDF::CompCDF(real_t const x) const
+template<typename index_t>
+pqRand::discrete<index_t>::discrete(std::vector<real_t> const& weights):
+	column(0, Discrete_NumCategories<index_t>(weights)), 
+	threshold(nullptr), alias(nullptr)
 {
-	if(x >= max()) return real_t(0);
-	else if (x <= min()) return real_t(1);
-	else return this->CDF_large_supported(x);
+	Build(weights);
 }
-			
-////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::distributionQ2::operator()(engine& gen) const
+template<typename index_t>
+pqRand::discrete<index_t>::discrete(std::vector<real_t> const& weights, std::string const& filePath):
+	column(0, Discrete_NumCategories<index_t>(weights)), 
+	threshold(nullptr), alias(nullptr)
 {
-	if(gen.RandBool())
-		return Q_small(gen.HalfU_uneven());
-	else
-		return Q_large(gen.HalfU_uneven());
+	if(not Map(weights, filePath))
+	{
+		Build(weights);
+		WriteFile(weights, filePath);
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::two pqRand::distributionQ2::GetTwo_antithetic(engine& gen) const
+template<typename index_t>
+void pqRand::discrete<index_t>::Build(std::vector<real_t> const& weights)
 {
-	real_t const hu = gen.HalfU_uneven();
+	// The table, shared by copies of this discrete
+	struct alias_table
+	{
+		std::vector<real_t> threshold;
+		std::vector<index_t> alias;
+	};
 	
-	return two(Q_small(hu), Q_large(hu));
+	size_t const n = weights.size();
+	
+	auto const table = std::make_shared<alias_table>();
+	std::vector<real_t>& thresholds = table->threshold;
+	std::vector<index_t>& aliases = table->alias;
+	thresholds.resize(n);
+	aliases.resize(n);
+	
+	real_t sum = real_t(0);
+	
+	for(real_t const w : weights)
+	{
+		// Written to also catch NaN
+		if(not ((w >= real_t(0)) and (w < INFINITY)))
+			throw std::domain_error("pqRand::discrete: every weight must be finite and non-negative");
+		sum += w;
+	}
+	
+	if(not ((sum > real_t(0)) and (sum < INFINITY)))
+		throw std::domain_error("pqRand::discrete: the weights must have a finite, non-zero sum");
+	
+	// Scale the weights so the average column has a probability of exactly 1. 
+	// Columns in small are under-full (p < 1) and are topped up by a column in large.
+	real_t const scale = real_t(n) / sum;
+	std::vector<index_t> small, large;
+	
+	for(size_t i = 0; i < n; ++i)
+	{
+		thresholds[i] = scale * weights[i];
+		aliases[i] = index_t(i);
+		
+		((thresholds[i] < real_t(1)) ? small : large).push_back(index_t(i));
+	}
+	
+	while(not (small.empty() or large.empty()))
+	{
+		index_t const s = small.back();
+		index_t const l = large.back();
+		small.pop_back();
+		
+		// Give the unused part of column s to l, and take it from l's probability
+		aliases[s] = l;
+		thresholds[l] = (thresholds[l] + thresholds[s]) - real_t(1);
+		
+		if(thresholds[l] < real_t(1))
+		{
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+	
+	// What remains is full to within rounding error (Vose's fix for numerical stability)
+	for(index_t const l : large)
+		thresholds[l] = real_t(1);
+	for(index_t const s : small)
+		thresholds[s] = real_t(1);
+	
+	threshold = thresholds.data();
+	alias = aliases.data();
+	storage = table;
 }
 
-////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::uniform::uniform(real_t const min_in, real_t const max_in):
-	min_(min_in), spread(max_in - min_in)
+template<typename index_t>
+bool pqRand::discrete<index_t>::Map(std::vector<real_t> const& weights, std::string const& filePath)
 {
-	if(spread <= real_t(0)) throw std::domain_error("pqRand::uniform: max must be greater than min.");
+	// The weights (the key), then the thresholds and aliases
+	std::vector<table_section> sections = {{weights.data(), weights.size() * sizeof(real_t)}, {}, {}};
+	std::shared_ptr<void const> const map = MapTable(filePath, table_kind::discrete, 
+		uint32_t(sizeof(index_t)), sections);
+	
+	if(not (map and (sections[1].bytes == Size() * sizeof(real_t)) 
+		and (sections[2].bytes == Size() * sizeof(index_t))))
+		return false;
+	
+	threshold = static_cast<real_t const*>(sections[1].data);
+	alias = static_cast<index_t const*>(sections[2].data);
+	storage = map;
+	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-// Checked PDF/CDF (16.12.2017 @ 11:29)
-typename pqRand::real_t pqRand::uniform::PDF_supported(real_t const x) const 
+template<typename index_t>
+void pqRand::discrete<index_t>::WriteFile(std::vector<real_t> const& weights, std::string const& filePath) const
 {
-	return real_t(1)/spread;
+	WriteTable(filePath, table_kind::discrete, uint32_t(sizeof(index_t)), 
+		{{weights.data(), Size() * sizeof(real_t)}, {threshold, Size() * sizeof(real_t)}, {alias, Size() * sizeof(index_t)}});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::uniform::CDF_small_supported(real_t const x) const 
+template<typename index_t>
+void pqRand::discrete<index_t>::Write(std::vector<real_t> const& weights, std::string const& filePath) const
 {
-	return (x - min())/spread;
+	// The weights key the file, so they must be the weights of this table (Build is deterministic)
+	discrete const rebuilt(weights);
+	
+	if(not ((rebuilt.Size() == Size()) 
+		and std::equal(threshold, threshold + Size(), rebuilt.threshold)
+		and std::equal(alias, alias + Size(), rebuilt.alias)))
+		throw std::domain_error("pqRand::discrete::Write: the table was not built from these weights");
+	
+	WriteFile(weights, filePath);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::uniform::CDF_large_supported(real_t const x) const 
+template<typename index_t>
+index_t pqRand::discrete<index_t>::operator()(pqRand::engine& gen) const
 {
-	return (max() - x)/spread;
+	index_t const i = column(gen);
+	return (gen.U_even() < threshold[i]) ? i : alias[i];
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::uniform::operator()(pqRand::engine& gen) const
+template<typename index_t>
+void pqRand::discrete<index_t>::Fill(index_t* const sample, size_t const sampleSize, 
+	pqRand::engine& gen) const
 {
-	return min_ + spread * gen.U_uneven();
+	real_t u[fillChunk];
+	
+	for(size_t begin = 0; begin < sampleSize; begin += fillChunk)
+	{
+		size_t const n = std::min(fillChunk, sampleSize - begin);
+		index_t* const chunk = sample + begin;
+		
+		// Draw all the random numbers first, then the lookups are independent
+		for(size_t i = 0; i < n; ++i)
+		{
+			chunk[i] = column(gen);
+			u[i] = gen.U_even();
+		}
+		
+		for(size_t i = 0; i < n; ++i)
+			chunk[i] = (u[i] < threshold[chunk[i]]) ? chunk[i] : alias[chunk[i]];
+	}
 }
 
+// Instantiate the common types
+template class pqRand::discrete<uint32_t>;
+template class pqRand::discrete<uint64_t>;
+
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-// Checked PDF/CDF (16.12.2017 @ 11:33)
-pqRand::real_t pqRand::standard_normal::PDF_supported(real_t const x) const
+template<typename index_t>
+constexpr pqRand::real_t pqRand::dynamic_discrete<index_t>::rebuildFraction;
+
+template<typename index_t>
+constexpr size_t pqRand::dynamic_discrete<index_t>::branchFreeNodes;
+
+template<typename index_t>
+pqRand::dynamic_discrete<index_t>::dynamic_discrete(std::vector<real_t> const& weights_in):
+	weights(weights_in), topStep(1), 
+	total(0), peak(0), numPositive(0), updates(0)
 {
-	return std::exp(-real_t(0.5)*Squared(x))/real_t(std::sqrt(2 * M_PI));
+	if(weights.empty())
+		throw std::domain_error("pqRand::dynamic_discrete: there must be at least one weight");
+	if(weights.size() > size_t(std::numeric_limits<index_t>::max()))
+		throw std::domain_error("pqRand::dynamic_discrete: too many weights for index_t");
+		
+	for(real_t const w : weights)
+		CheckWeight(w);
+	
+	while((topStep << 1) <= weights.size())
+		topStep <<= 1;
+		
+	// The descent can visit any node up to (2 * topStep - 1). Nodes past n are never updated,
+	// and the largest real_t keeps the descent from stepping onto them (INFINITY would make NaN in Descend).
+	tree.assign(2 * topStep, std::numeric_limits<real_t>::max());
+		
+	Build();
 }
 
 ////////////////////////////////////////////////////////////////////////
-				
-pqRand::real_t pqRand::standard_normal::CDF_small_supported(real_t const x) const
+
+template<typename index_t>
+pqRand::dynamic_discrete<index_t>::~dynamic_discrete() {}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::CheckWeight(real_t const weight)
 {
-	// To use the error function we have to add, creating a cancellation
-	return CDF_large_supported(-x);
+	// Written to also catch NaN
+	if(not ((weight >= real_t(0)) and (weight < INFINITY)))
+		throw std::domain_error("pqRand::dynamic_discrete: every weight must be finite and non-negative");
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::real_t pqRand::standard_normal::CDF_large_supported(real_t const x) const
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::CheckIndex(index_t const i) const
 {
-	return real_t(0.5)*std::erfc(x/std::sqrt(real_t(2)));
+	if(size_t(i) >= weights.size())
+		throw std::domain_error("pqRand::dynamic_discrete: index out of bounds");
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::standard_normal::operator()(pqRand::engine& gen) const
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::Build()
 {
-	if(valueCached)
+	size_t const n = weights.size();
+	
+	numPositive = 0;
+	for(size_t i = 1; i <= n; ++i)
 	{
-		valueCached = false;
-		return cache;
+		tree[i] = weights[i - 1];
+		numPositive += size_t(weights[i - 1] > real_t(0));
 	}
-	else
+	
+	// Add each node to its parent (i + lowest set bit of i), in O(n)
+	for(size_t i = 1; i <= n; ++i)
 	{
-		valueCached = true;
-		two const pair = GetTwo(gen);
-		cache = pair.y;
-		return pair.x;
+		size_t const parent = i + (i bitand (~i + 1));
+		if(parent <= n)
+			tree[parent] += tree[i];
 	}
+	
+	// The total is the sum of the roots of the tree (one for each set bit of n)
+	total = real_t(0);
+	for(size_t i = n; i > 0; i -= (i bitand (~i + 1)))
+		total += tree[i];
+	
+	peak = total;
+	updates = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::two pqRand::standard_normal::GetTwo(pqRand::engine& gen) const
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::Set(index_t const i, real_t const weight)
 {
-	two pair;
-	real_t u;
-	
-	// The Marsaglia polar method -- modeled after GNU's std::normal_distribution 
-	// (bits/random.tcc, line 1925, <https://gcc.gnu.org/onlinedocs/gcc-4.8.5/libstdc++/api/a01147_source.html>)
-	// on or about March 2017 -- but with the added precision of the quantile flip-flop and U_Q.
-	// As such, we don't do x = (1 - U) to get a cheap random sign; 
-	// this destroys the precision of quasiuniform U.
-	do
-	{
-		pair.x = gen.U_uneven();
-		pair.y = gen.U_uneven();
-	
-		// Draw x and y from U, and reject when we don't land in the circle
-		u = pair.x*pair.x + pair.y*pair.y;
-		
-		// Reject 2/3 of the region that rounds to 1
-		// (we want the epsilon/2 to the left of 1, but not the epsilon the right of 1).
-		// There is a small region near (1, 0), (0, 1), etc. where the right region 
-		// doesn't exist, but it is vanishingly small).
-		if((u == real_t(1)) and (gen.U_even()*real_t(3) < real_t(2)))
-			u = 2.; // Easy way to reject
-	}
-	while(u > real_t(1));
-
-	// Give x and y a random sign via the pqRand::engine (using its bitCache)
-	gen.ApplyRandomSign(pair.x);
-	gen.ApplyRandomSign(pair.y);
+	real_t const delta = weight - weights[i];
 	
-	// Implement the quantile flip-flop and scale x and y
-	u = (gen.RandBool() ? 
-		std::sqrt(-real_t(2)*std::log(real_t(0.5)*u)/u) : 
-		std::sqrt(-real_t(2)*std::log1p(-real_t(0.5)*u)/u));		
+	if(ExactlyEqual(delta, real_t(0))) return;
 	
-	pair.x *= u;
-	pair.y *= u;
+	numPositive += size_t(weight > real_t(0));
+	numPositive -= size_t(weights[i] > real_t(0));
+	weights[i] = weight;
 	
-	return pair;
+	for(size_t j = size_t(i) + 1; j <= weights.size(); j += (j bitand (~j + 1)))
+		tree[j] += delta;
+		
+	total += delta;
+	peak = std::max(peak, total);
+	++updates;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-std::vector<pqRand::real_t> pqRand::standard_normal::GetSample
-	(size_t const sampleSize, pqRand::engine& gen) const
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::MaybeRebuild()
 {
-	size_t const loopSize = (sampleSize + 1)/2; // This is at least sampleSize / 2;
-			
-	std::vector<real_t> sample;
-	sample.reserve(sampleSize);
+	if((updates >= weights.size()) or (total < peak * rebuildFraction))
+		Build();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::Update(index_t const i, real_t const weight)
+{
+	CheckIndex(i);
+	CheckWeight(weight);
 	
-	for(size_t i = 0; i < loopSize; ++i)
+	Set(i, weight);
+	MaybeRebuild();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+size_t pqRand::dynamic_discrete<index_t>::BulkThreshold() const
+{
+	size_t log2n = 1;
+	while((size_t(1) << log2n) < weights.size())
+		++log2n;
+	
+	return weights.size() / log2n;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::Update(index_t const* const indices, 
+	real_t const* const newWeights, size_t const count)
+{
+	// Check everything first, so that a bad entry leaves the weights unchanged
+	for(size_t j = 0; j < count; ++j)
 	{
-		two const pair = this->GetTwo(gen);
-		sample.push_back(pair.x);
-		sample.push_back(pair.y);
+		CheckIndex(indices[j]);
+		CheckWeight(newWeights[j]);
 	}
 	
-	// sample.size() is now a multiple of 2; make it odd if requested
-	if(sample.size() > sampleSize) 
-		sample.pop_back();
-	assert(sample.size() == sampleSize);
+	if(count >= BulkThreshold())
+	{
+		for(size_t j = 0; j < count; ++j)
+			weights[indices[j]] = newWeights[j];
+		Build();
+	}
+	else
+	{
+		for(size_t j = 0; j < count; ++j)
+			Set(indices[j], newWeights[j]);
+		MaybeRebuild();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::Update(std::vector<real_t> const& newWeights)
+{
+	if(newWeights.size() not_eq weights.size())
+		throw std::domain_error("pqRand::dynamic_discrete: there must be one new weight per category");
 	
-	return sample;
+	for(real_t const w : newWeights)
+		CheckWeight(w);
+		
+	weights = newWeights;
+	Build();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+size_t pqRand::dynamic_discrete<index_t>::Descend(real_t u) const
+{
+	size_t position = 0;
+	
+	// Find the first category whose cumulative weight exceeds u.
+	// Each step is unpredictable; when the tree fits in cache, a mispredicted branch 
+	// costs more than a dependent chain of arithmetic, so the step is taken (or not) without a branch. 
+	// When the tree does not fit in cache, the branch is better, because speculating 
+	// past it overlaps the cache misses of successive levels.
+	if(tree.size() <= branchFreeNodes)
+	{
+		for(size_t step = topStep; step > 0; step >>= 1)
+		{
+			real_t const partial = tree[position + step];
+			bool const take = (partial <= u);
+			
+			position += step * size_t(take);
+			u -= partial * real_t(take);
+		}
+	}
+	else
+	{
+		for(size_t step = topStep; step > 0; step >>= 1)
+		{
+			real_t const partial = tree[position + step];
+			
+			if(partial <= u)
+			{
+				position += step;
+				u -= partial;
+			}
+		}
+	}
+	
+	return position;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+index_t pqRand::dynamic_discrete<index_t>::Sample(pqRand::engine& gen) const
+{
+	size_t i;
+	
+	// Rounding error can (very rarely) land us past the end, or on a zero weight; try again
+	while(((i = Descend(gen.U_even() * total)) >= weights.size()) or 
+		ExactlyEqual(weights[i], real_t(0)));
+		
+	return index_t(i);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+index_t pqRand::dynamic_discrete<index_t>::operator()(pqRand::engine& gen) const
+{
+	if(numPositive == 0)
+		throw std::domain_error("pqRand::dynamic_discrete: every weight is zero");
+		
+	return Sample(gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<typename index_t>
+void pqRand::dynamic_discrete<index_t>::Fill(index_t* const sample, size_t const sampleSize, 
+	pqRand::engine& gen) const
+{
+	if((sampleSize > 0) and (numPositive == 0))
+		throw std::domain_error("pqRand::dynamic_discrete: every weight is zero");
+		
+	for(size_t i = 0; i < sampleSize; ++i)
+		sample[i] = Sample(gen);
+}
+
+// Instantiate the common types
+template class pqRand::dynamic_discrete<uint32_t>;
+template class pqRand::dynamic_discrete<uint64_t>;
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+pqRand::pmf_table::~pmf_table() {}
+
+////////////////////////////////////////////////////////////////////////
+
+pqRand::pmf_table::pmf_table(std::vector<real_t> const& pmf):
+	cdf(pmf.size()), ccdf(pmf.size()), upperStart(0)
+{
+	// Accumulate each tail from its far end, so that small probabilities are summed first
+	real_t sum = real_t(0);
+	for(size_t k = 0; k < pmf.size(); ++k)
+		cdf[k] = (sum += pmf[k]);
+	
+	sum = real_t(0);
+	for(size_t k = pmf.size(); k-- > 0;)
+	{
+		ccdf[k] = sum;
+		sum += pmf[k];
+	}
+	
+	while((upperStart < ccdf.size()) and (ccdf[upperStart] >= real_t(0.5)))
+		++upperStart;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+uint64_t pqRand::pmf_table::operator()(pqRand::engine& gen) const
+{
+	real_t const u = gen.HalfU_uneven();
+	uint64_t k;
+	
+	// The lower search ends because cdf reaches ~1, the upper because ccdf.back() = 0
+	if(gen.RandBool())
+	{
+		// The lower half: the smallest k with P(X <= k) > u
+		k = 0;
+		while(cdf[k] <= u) ++k;
+	}
+	else
+	{
+		// The upper half: the smallest k with P(X > k) < u
+		k = upperStart;
+		while(ccdf[k] >= u) ++k;
+	}
+	
+	return k;
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// The largest real_t which can be converted to a uint64_t is less than 2**64
+static constexpr pqRand::real_t uint64_limit = pqRand::real_t(18446744073709551616.);
+
+// The log of the PMF of the Poisson and binomial distributions, without the catastrophic 
+// cancellation of the textbook formulae (e.g. -mu + k log(mu) - lgamma(k + 1), 
+// whose terms are much larger than their sum when mu is large), from
+// 	Loader, C. "Fast and accurate computation of binomial probabilities" (2000)
+
+// The error of Stirling's approximation: lgamma(n + 1) - [(n + 1/2) log(n) - n + log(sqrt(2 pi))]
+static pqRand::real_t StirlingError(pqRand::real_t const n)
+{
+	using pqRand::real_t;
+	
+	if(n <= real_t(15))
+		return std::lgamma(n + real_t(1)) - (n + real_t(0.5)) * std::log(n) + n - 
+			real_t(0.918938533204672741780329736406); // log(sqrt(2 pi))
+	else
+	{
+		real_t const nn = n * n;
+		return (real_t(1./12.) - (real_t(1./360.) - (real_t(1./1260.) - 
+			(real_t(1./1680.) - real_t(1./1188.) / nn) / nn) / nn) / nn) / n;
+	}
+}
+
+// The deviance: x log(x / mean) + mean - x (with a series when x ~= mean)
+static pqRand::real_t Deviance(pqRand::real_t const x, pqRand::real_t const mean)
+{
+	using pqRand::real_t;
+	
+	if(std::fabs(x - mean) < real_t(0.1) * (x + mean))
+	{
+		real_t const v = (x - mean) / (x + mean);
+		real_t const v2 = v * v;
+		real_t sum = (x - mean) * v;
+		real_t term = real_t(2) * x * v;
+		
+		for(real_t j = real_t(3); ; j += real_t(2))
+		{
+			term *= v2;
+			real_t const next = sum + term / j;
+			if(ExactlyEqual(next, sum)) return sum; // Converged
+			sum = next;
+		}
+	}
+	else
+		return x * std::log(x / mean) + mean - x;
+}
+
+// log(2 pi)
+static constexpr pqRand::real_t log2pi = pqRand::real_t(1.83787706640934548356065947281);
+
+static pqRand::real_t Poisson_LogPMF(pqRand::real_t const k, pqRand::real_t const mu)
+{
+	using pqRand::real_t;
+	
+	if(k < real_t(1)) return -mu; // k = 0 (k is a non-negative integer)
+	
+	return -StirlingError(k) - Deviance(k, mu) - real_t(0.5) * (log2pi + std::log(k));
+}
+
+static pqRand::real_t Binomial_LogPMF(pqRand::real_t const k, pqRand::real_t const n, 
+	pqRand::real_t const p)
+{
+	using pqRand::real_t;
+	
+	// k is an integer in [0, n]
+	if(k < real_t(1)) return n * std::log1p(-p);
+	if(k >= n) return n * std::log(p);
+	
+	real_t const q = real_t(1) - p;
+	
+	return StirlingError(n) - StirlingError(k) - StirlingError(n - k) 
+		- Deviance(k, n * p) - Deviance(n - k, n * q) 
+		- real_t(0.5) * (log2pi + std::log(k) + std::log1p(-k / n));
+}
+
+// The Poisson PMF, until it underflows (empty when PTRS is used)
+static std::vector<pqRand::real_t> Poisson_PMF(pqRand::real_t const mu)
+{
+	using pqRand::real_t;
+	std::vector<real_t> pmf;
+	
+	if((mu > real_t(0)) and (mu < pqRand::poisson::tableMean))
+	{
+		pmf.push_back(std::exp(-mu));
+		
+		// Go past the mode before testing for underflow
+		while((pmf.back() > real_t(0)) or (real_t(pmf.size()) < mu))
+			pmf.push_back(pmf.back() * mu / real_t(pmf.size()));
+	}
+	return pmf;
+}
+
+constexpr pqRand::real_t pqRand::poisson::tableMean;
+
+pqRand::poisson::poisson(real_t const mu_in):
+	mu_(mu_in), 
+	b(real_t(0.931) + real_t(2.53) * std::sqrt(mu_)), 
+	a(real_t(-0.059) + real_t(0.02483) * b), 
+	invAlpha(real_t(1.1239) + real_t(1.1328) / (b - real_t(3.4))), 
+	vr(real_t(0.9277) - real_t(3.6224) / (b - real_t(2))), 
+	logInvAlpha(std::log(invAlpha)),
+	table(Poisson_PMF(mu_))
+{
+	// Written to also catch NaN
+	if(not ((mu_ > real_t(0)) and (mu_ < INFINITY)))
+		throw std::domain_error("pqRand::poisson: mu must be positive and finite!");
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool pqRand::poisson::Accept(pqRand::engine& gen, uint64_t& variate) const
+{
+	// Sample the distance from the tails (us = 0.5 - |u|) with an uneven variate,
+	// so that proposals in the far tails are precise.
+	real_t const us = gen.HalfU_uneven();
+	real_t const u = gen.RandBool() ? (real_t(0.5) - us) : (us - real_t(0.5));
+	real_t const v = gen.U_uneven();
+	
+	real_t const k = std::floor((real_t(2) * a / us + b) * u + mu_ + real_t(0.43));
+	
+	if(not ((k >= real_t(0)) and (k < uint64_limit)))
+		return false;
+	
+	// The transformed hat; the first test accepts most proposals without a log
+	if(((us >= real_t(0.07)) and (v <= vr)) or
+		(((us >= real_t(0.013)) or (v <= us)) and 
+		((std::log(v) + logInvAlpha - std::log(a / Squared(us) + b)) <= 
+			Poisson_LogPMF(k, mu_))))
+	{
+		variate = uint64_t(k);
+		return true;
+	}
+	else
+		return false;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+uint64_t pqRand::poisson::Sample_PTRS(pqRand::engine& gen) const
+{
+	uint64_t variate;
+	
+	#if PQR_REJECTION_STATS
+	uint64_t proposals = 1;
+	while(not Accept(gen, variate))
+		++proposals;
+	rejections.Record(proposals);
+	#else
+	while(not Accept(gen, variate));
+	#endif
+	
+	return variate;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+uint64_t pqRand::poisson::operator()(pqRand::engine& gen) const
+{
+	return table.empty() ? Sample_PTRS(gen) : table(gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::poisson::Fill(uint64_t* const sample, size_t const sampleSize, 
+	pqRand::engine& gen) const
+{
+	if(table.empty())
+	{
+		for(size_t i = 0; i < sampleSize; ++i)
+			sample[i] = Sample_PTRS(gen);
+	}
+	else
+	{
+		for(size_t i = 0; i < sampleSize; ++i)
+			sample[i] = table(gen);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// The binomial PMF (with p <= 1/2), until it underflows (empty when BTRS is used)
+static std::vector<pqRand::real_t> Binomial_PMF(uint64_t const n, pqRand::real_t const p)
+{
+	using pqRand::real_t;
+	std::vector<real_t> pmf;
+	
+	if((p >= real_t(0)) and (p <= real_t(0.5)) and (real_t(n) * p < pqRand::binomial::tableMean))
+	{
+		real_t const ratio = p / (real_t(1) - p);
+		
+		pmf.push_back(std::exp(real_t(n) * std::log1p(-p)));
+		
+		// Go past the mode before testing for underflow
+		for(uint64_t k = 0; (k < n) and ((pmf.back() > real_t(0)) or (real_t(k) < real_t(n) * p)); ++k)
+			pmf.push_back(pmf.back() * (real_t(n - k) / real_t(k + 1)) * ratio);
+	}
+	return pmf;
+}
+
+constexpr pqRand::real_t pqRand::binomial::tableMean;
+
+pqRand::binomial::binomial(uint64_t const n_in, real_t const p_in):
+	n_(n_in), p_(p_in), 
+	pSmall((p_ > real_t(0.5)) ? (real_t(1) - p_) : p_), // 1 - p is exact for p > 1/2
+	spq(std::sqrt(real_t(n_) * pSmall * (real_t(1) - pSmall))),
+	b(real_t(1.15) + real_t(2.53) * spq),
+	a(real_t(-0.0873) + real_t(0.0248) * b + real_t(0.01) * pSmall),
+	c(real_t(n_) * pSmall + real_t(0.5)),
+	vr(real_t(0.92) - real_t(4.2) / b),
+	alpha((real_t(2.83) + real_t(5.1) / b) * spq),
+	logPMF_mode(Binomial_LogPMF(std::floor((real_t(n_) + real_t(1)) * pSmall), real_t(n_), pSmall)),
+	table(Binomial_PMF(n_, pSmall)),
+	flip(p_ > real_t(0.5)), padding()
+{
+	// Written to also catch NaN
+	if(not ((p_ >= real_t(0)) and (p_ <= real_t(1))))
+		throw std::domain_error("pqRand::binomial: p must be in [0, 1]!");
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool pqRand::binomial::Accept(pqRand::engine& gen, uint64_t& variate) const
+{
+	// Sample the distance from the tails (us = 0.5 - |u|) with an uneven variate,
+	// so that proposals in the far tails are precise.
+	real_t const us = gen.HalfU_uneven();
+	real_t const u = gen.RandBool() ? (real_t(0.5) - us) : (us - real_t(0.5));
+	real_t const v = gen.U_uneven();
+	
+	real_t const k = std::floor((real_t(2) * a / us + b) * u + c);
+	
+	if(not ((k >= real_t(0)) and (k < uint64_limit) and (uint64_t(k) <= n_)))
+		return false;
+	
+	// The transformed hat; the first test accepts most proposals without a log
+	if(((us >= real_t(0.07)) and (v <= vr)) or
+		(std::log(v * alpha / (a / Squared(us) + b)) <= 
+			(Binomial_LogPMF(k, real_t(n_), pSmall) - logPMF_mode)))
+	{
+		variate = uint64_t(k);
+		return true;
+	}
+	else
+		return false;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+uint64_t pqRand::binomial::Sample_BTRS(pqRand::engine& gen) const
+{
+	uint64_t variate;
+	
+	#if PQR_REJECTION_STATS
+	uint64_t proposals = 1;
+	while(not Accept(gen, variate))
+		++proposals;
+	rejections.Record(proposals);
+	#else
+	while(not Accept(gen, variate));
+	#endif
+	
+	return variate;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+uint64_t pqRand::binomial::operator()(pqRand::engine& gen) const
+{
+	return Unflip(table.empty() ? Sample_BTRS(gen) : table(gen));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::binomial::Fill(uint64_t* const sample, size_t const sampleSize, 
+	pqRand::engine& gen) const
+{
+	if(table.empty())
+	{
+		for(size_t i = 0; i < sampleSize; ++i)
+			sample[i] = Unflip(Sample_BTRS(gen));
+	}
+	else
+	{
+		for(size_t i = 0; i < sampleSize; ++i)
+			sample[i] = Unflip(table(gen));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+constexpr size_t pqRand::bernoulli::bitParallelThreshold;
+
+pqRand::bernoulli::bernoulli(real_t const p_in):
+	p_(p_in), leadingZeros(0), mantissa(0)
+{
+	// Written to also catch NaN
+	if(not ((p_ >= real_t(0)) and (p_ <= real_t(1))))
+		throw std::domain_error("pqRand::bernoulli: p must be in [0, 1]!");
+		
+	if((p_ > real_t(0)) and (p_ < real_t(1)))
+	{
+		// p = m * 2**exponent, with m in [1/2, 1), so p's first non-zero bit is at (-exponent)
+		int exponent;
+		real_t const m = std::frexp(p_, &exponent);
+		
+		leadingZeros = uint64_t(-exponent);
+		mantissa = uint64_t(std::ldexp(m, 64)); // Exact (m has at most 53 significant bits)
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool pqRand::bernoulli::Compare(pqRand::engine& gen, uint64_t j) const
+{
+	// Once p's bits run out, they are all zero, so the next 1 from U decides (false)
+	while(true)
+	{
+		bool const pBit = Bit(j++);
+		
+		if(gen.RandBool() not_eq pBit)
+			return pBit; // U's bit is 0 where p's is 1 => U < p
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+uint64_t pqRand::bernoulli::Window(uint64_t const j) const
+{
+	if(j >= leadingZeros)
+		return ((j - leadingZeros) < 64) ? (mantissa << (j - leadingZeros)) : 0;
+	else
+		return ((leadingZeros - j) < 64) ? (mantissa >> (leadingZeros - j)) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool pqRand::bernoulli::Compare(bit_stream& stream, pqRand::engine& gen, uint64_t j) const
+{
+	uint64_t constexpr numGoodBits = std::numeric_limits<pqRand::engine::result_type>::digits - pqRand::engine::badBits;
+	
+	while(true)
+	{
+		if(stream.count == 0)
+		{
+			stream.bits = (gen() >> pqRand::engine::badBits) << pqRand::engine::badBits;
+			stream.count = numGoodBits;
+		}
+		
+		// Compare all the unused bits at once; the first difference decides
+		uint64_t const window = Window(j);
+		uint64_t const diff = (stream.bits xor window) bitand 
+			((~uint64_t(0)) << (64 - stream.count));
+			
+		if(diff)
+		{
+			uint64_t const position = uint64_t(__builtin_clzll(diff)); // < stream.count <= 62
+			
+			stream.bits <<= (position + 1);
+			stream.count -= (position + 1);
+			
+			return bool((window << position) >> 63); // U's bit is 0 where p's is 1 => U < p
+		}
+		else
+		{
+			j += stream.count;
+			stream.count = 0;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool pqRand::bernoulli::operator()(pqRand::engine& gen) const
+{
+	if(p_ <= real_t(0)) return false;
+	if(p_ >= real_t(1)) return true;
+	
+	return Compare(gen, 0);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+uint64_t pqRand::bernoulli::Packed64(bit_stream& stream, pqRand::engine& gen) const
+{
+	if(p_ <= real_t(0)) return 0;
+	if(p_ >= real_t(1)) return ~uint64_t(0);
+	
+	// The engine supplies (64 - badBits) good bits per word, so the bit-parallel trials 
+	// use the low lanes, and the high lanes are run one at a time (with the stragglers).
+	uint64_t constexpr numLanes = std::numeric_limits<pqRand::engine::result_type>::digits - pqRand::engine::badBits;
+	uint64_t constexpr lanes = (~uint64_t(0)) >> (64 - numLanes);
+	
+	uint64_t undecided = lanes;
+	uint64_t result = 0;
+	uint64_t j = 0;
+	
+	while(size_t(__builtin_popcountll(undecided)) > bitParallelThreshold)
+	{
+		// One random bit for each lane
+		uint64_t const uBits = (gen() >> pqRand::engine::badBits);
+		
+		if(Bit(j))
+		{
+			result |= (undecided bitand (compl uBits)); // U's bit is 0 and p's is 1 => U < p
+			undecided &= uBits;
+		}
+		else
+			undecided &= (compl uBits); // U's bit is 1 and p's is 0 => U > p
+		
+		++j;
+	}
+	
+	// Finish the stragglers (whose first j bits matched p's) one at a time
+	for(; undecided; undecided &= (undecided - 1))
+	{
+		if(Compare(stream, gen, j))
+			result |= (undecided bitand (compl undecided + 1)); // The lowest undecided lane
+	}
+	
+	// Then the lanes outside the bit-parallel trials
+	for(uint64_t lane = numLanes; lane < 64; ++lane)
+	{
+		if(Compare(stream, gen, 0))
+			result |= (uint64_t(1) << lane);
+	}
+	
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::bernoulli::FillPacked(uint64_t* const words, size_t const numTrials, 
+	pqRand::engine& gen) const
+{
+	size_t const fullWords = numTrials / 64;
+	size_t const remainder = numTrials % 64;
+	bit_stream stream;
+	
+	for(size_t i = 0; i < fullWords; ++i)
+		words[i] = Packed64(stream, gen);
+		
+	if(remainder)
+		words[fullWords] = Packed64(stream, gen) bitand ((uint64_t(1) << remainder) - 1);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::vector<uint64_t> pqRand::bernoulli::GetPacked(size_t const numTrials, 
+	pqRand::engine& gen) const
+{
+	std::vector<uint64_t> words((numTrials + 63) / 64);
+	FillPacked(words.data(), numTrials, gen);
+	return words;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::bernoulli::Fill(bool* const sample, size_t const sampleSize, 
+	pqRand::engine& gen) const
+{
+	bit_stream stream;
+	
+	for(size_t begin = 0; begin < sampleSize; begin += 64)
+	{
+		uint64_t const word = Packed64(stream, gen);
+		size_t const n = std::min(size_t(64), sampleSize - begin);
+		
+		for(size_t i = 0; i < n; ++i)
+			sample[begin + i] = bool((word >> i) bitand 1);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::distributionPDF::PDF(real_t const x) const
+{
+	if((x >= min()) and (x <= max()))
+		return this->PDF_supported(x);
+	else 
+		return real_t(0);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+size_t constexpr pqRand::distributionPDF::arrayChunk;
+
+void pqRand::distributionPDF::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	// The scalar checks, because a PDF_supported() may assume a supported x (e.g. take a log)
+	for(size_t i = 0; i < n; ++i)
+		pdf[i] = this->PDF(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::distributionPDF::PDF(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	real_t const xMin = min();
+	real_t const xMax = max();
+	real_t kernel[arrayChunk]; // So that pdf can alias x
+	
+	for(size_t i = 0; i < n; i += arrayChunk)
+	{
+		size_t const m = std::min(arrayChunk, n - i);
+		
+		this->PDF_array(x + i, kernel, m);
+		
+		// Mask the unsupported values (NaN is unsupported, like the scalar PDF)
+		for(size_t j = 0; j < m; ++j)
+			pdf[i + j] = ((x[i + j] >= xMin) and (x[i + j] <= xMax)) ? kernel[j] : real_t(0);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::string pqRand::RejectionReport(std::string const& name, rejection_stats const& stats, 
+	real_t const minAcceptance, uint64_t const maxRetries)
+{
+	real_t const rate = stats.AcceptanceRate();
+	bool const pathological = (rate < minAcceptance) or (stats.maxRetries > maxRetries);
+	
+	char line[256];
+	snprintf(line, sizeof(line), 
+		": %llu variates, %llu proposals, acceptance %.4g, max retries %llu%s",
+		(unsigned long long)stats.acceptances, (unsigned long long)stats.proposals, 
+		double(rate), (unsigned long long)stats.maxRetries, 
+		pathological ? " [WARNING: pathological rejection rate]" : "");
+	
+	return name + line;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::two pqRand::MeanAndVariance(distributionPDF const& dist,
+	size_t const sampleSize, engine& gen)
+{
+	real_t sum = real_t(0);
+	real_t sum2 = real_t(0);
+	
+	{
+		auto const sample = dist.GetSample(sampleSize, gen);
+						
+		for(real_t const x : sample)
+		{
+			sum += x;
+			sum2 += Squared(x);
+		}
+	}
+	
+	real_t const n = real_t(sampleSize);
+	
+	// This may not be the most accurate method to get the standard deviation using floats
+	return two(sum / n, sum2 / n - Squared(sum) / Squared(n));
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::distributionCDF::CDF(real_t const x) const
+{
+	if(x <= min()) return real_t(0);
+	else if (x >= max()) return real_t(1);
+	else return this->CDF_small_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::distributionCDF::CompCDF(real_t const x) const
+{
+	if(x >= max()) return real_t(0);
+	else if (x <= min()) return real_t(1);
+	else return this->CDF_large_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::distributionCDF::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	for(size_t i = 0; i < n; ++i)
+		cdf[i] = this->CDF(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::distributionCDF::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	for(size_t i = 0; i < n; ++i)
+		ccdf[i] = this->CompCDF(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::distributionCDF::CDF(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	real_t const xMin = min();
+	real_t const xMax = max();
+	real_t kernel[arrayChunk];
+	
+	for(size_t i = 0; i < n; i += arrayChunk)
+	{
+		size_t const m = std::min(arrayChunk, n - i);
+		
+		this->CDF_small_array(x + i, kernel, m);
+		
+		// The same order of checks as the scalar CDF (NaN passes through the kernel)
+		for(size_t j = 0; j < m; ++j)
+			cdf[i + j] = (x[i + j] <= xMin) ? real_t(0) : 
+				((x[i + j] >= xMax) ? real_t(1) : kernel[j]);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::distributionCDF::CompCDF(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	real_t const xMin = min();
+	real_t const xMax = max();
+	real_t kernel[arrayChunk];
+	
+	for(size_t i = 0; i < n; i += arrayChunk)
+	{
+		size_t const m = std::min(arrayChunk, n - i);
+		
+		this->CDF_large_array(x + i, kernel, m);
+		
+		for(size_t j = 0; j < m; ++j)
+			ccdf[i + j] = (x[i + j] >= xMax) ? real_t(0) : 
+				((x[i + j] <= xMin) ? real_t(1) : kernel[j]);
+	}
+}
+			
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::distributionQ2::operator()(engine& gen) const
+{
+	if(gen.RandBool())
+		return Q_small(gen.HalfU_uneven());
+	else
+		return Q_large(gen.HalfU_uneven());
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::two pqRand::distributionQ2::GetTwo_antithetic(engine& gen) const
+{
+	real_t const hu = gen.HalfU_uneven();
+	
+	return two(Q_small(hu), Q_large(hu));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Marsaglia and Tsang's test of the proposal from the normal variate x (see gammaDist_MarsagliaTsang), 
+// with d = k - 1/3 and c = 1/sqrt(9 d); an accepted proposal is a unit-scale gamma variate of shape k >= 1.
+static bool MarsagliaTsang_Accept(pqRand::real_t const d, pqRand::real_t const c, 
+	pqRand::real_t const x, pqRand::engine& gen, pqRand::real_t& variate)
+{
+	using pqRand::real_t;
+	
+	real_t v = real_t(1) + c * x;
+	
+	if(v <= real_t(0)) // Outside the support of the transformation
+		return false;
+		
+	v = v * v * v;
+	
+	real_t const u = gen.U_uneven();
+	real_t const x2 = pqRand::Squared(x);
+	
+	// The squeeze accepts ~98% of proposals without a log; the second test is exact
+	if((u < real_t(1) - real_t(0.0331) * pqRand::Squared(x2)) or 
+		(std::log(u) < real_t(0.5) * x2 + d * (real_t(1) - v + std::log(v))))
+	{
+		variate = d * v;
+		return true;
+	}
+	else 
+		return false;
+}
+
+// A unit-scale gamma variate of shape k >= 1 (the draws of gammaDist_MarsagliaTsang(1, k)'s first variate), 
+// computing only the constants of the sampler (not a gammaDist_MarsagliaTsang, whose PDF needs a pow and an lgamma).
+static pqRand::real_t StandardGamma(pqRand::real_t const k, pqRand::engine& gen)
+{
+	using pqRand::real_t;
+	
+	real_t const d = k - real_t(1)/real_t(3);
+	real_t const c = real_t(1)/std::sqrt(real_t(9)*d);
+	pqRand::standard_normal const normal; // Its spare variate serves the next proposal
+	
+	real_t variate;
+	while(not MarsagliaTsang_Accept(d, c, normal(gen), gen, variate));
+	return variate;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// The quantile of a CDF given both ways (cdf + ccdf = 1), using the smaller (the precise one)
+static pqRand::real_t PreciseQuantile(pqRand::distributionQ2 const& dist, 
+	pqRand::real_t const cdf, pqRand::real_t const ccdf)
+{
+	return (cdf <= ccdf) ? dist.Q_small(cdf) : dist.Q_large(ccdf);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::distributionQ2::SampleMax(uint64_t const n, engine& gen) const
+{
+	if(n == 0)
+		throw std::domain_error("pqRand::distributionQ2::SampleMax: n must be at least 1");
+	
+	// CDF(max) = exp(-E/n) and CompCDF(max) = -expm1(-E/n)
+	real_t const t = static_dist::exponential(real_t(1))(gen) / real_t(n);
+	return PreciseQuantile(*this, std::exp(-t), -std::expm1(-t));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::distributionQ2::SampleMin(uint64_t const n, engine& gen) const
+{
+	if(n == 0)
+		throw std::domain_error("pqRand::distributionQ2::SampleMin: n must be at least 1");
+	
+	// CompCDF(min) = exp(-E/n) and CDF(min) = -expm1(-E/n)
+	real_t const t = static_dist::exponential(real_t(1))(gen) / real_t(n);
+	return PreciseQuantile(*this, -std::expm1(-t), std::exp(-t));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::distributionQ2::SampleOrderStatistic(uint64_t const k, uint64_t const n, 
+	engine& gen) const
+{
+	if(not ((k >= 1) and (k <= n)))
+		throw std::domain_error("pqRand::distributionQ2::SampleOrderStatistic: k must be in [1, n]");
+	
+	if(k == 1) return SampleMin(n, gen);
+	if(k == n) return SampleMax(n, gen);
+	
+	// CDF(x_k) ~ Beta(k, n - k + 1), and CompCDF(x_k) ~ Beta(n - k + 1, k)
+	real_t const below = StandardGamma(real_t(k), gen);
+	real_t const above = StandardGamma(real_t(n - k + 1), gen);
+	real_t const sum = below + above;
+	
+	return PreciseQuantile(*this, below / sum, above / sum);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// One block of a sorted sample, with its spacings in units of the sample's total
+struct sorted_block
+{
+	pqRand::real_t total; // The sum of the block's spacings (a gamma variate)
+	pqRand::real_t below; // The sum of the spacings of all lower blocks
+	pqRand::real_t above; // The sum of the spacings of all higher blocks (and the final spacing)
+};
+
+// Draw the total of each block (and the final spacing), which fixes where every block lies
+static std::vector<sorted_block> SortedBlocks(size_t const sampleSize, size_t const blockSize,
+	pqRand::engine& gen)
+{
+	using pqRand::real_t;
+
+	std::vector<sorted_block> blocks((sampleSize + blockSize - 1) / blockSize);
+
+	for(size_t b = 0; b < blocks.size(); ++b)
+	{
+		size_t const m = std::min(blockSize, sampleSize - b * blockSize);
+		blocks[b].total = StandardGamma(real_t(m), gen);
+	}
+
+	// Sum from the bottom for "below" and from the top for "above", so both tails are precise
+	real_t below = real_t(0);
+	for(auto& block : blocks)
+	{
+		block.below = below;
+		below += block.total;
+	}
+
+	real_t above = pqRand::static_dist::exponential(real_t(1))(gen);
+	for(auto block = blocks.rbegin(); block not_eq blocks.rend(); ++block)
+	{
+		block->above = above;
+		above += block->total;
+	}
+
+	real_t const total = below + blocks.back().above;
+
+	for(auto& block : blocks)
+	{
+		block.total /= total;
+		block.below /= total;
+		block.above /= total;
+	}
+
+	return blocks;
+}
+
+// Sample one block of a sorted sample (the block's share of FillSorted)
+static void SortedBlock(pqRand::distributionQ2 const& dist, sorted_block const& block,
+	pqRand::real_t* const x, size_t const m, pqRand::engine& gen)
+{
+	using pqRand::real_t;
+
+	// The normalized spacings are independent of their sum, so we can rescale them to the block's total
+	pqRand::exponential(real_t(1)).Fill(x, m, gen);
+
+	real_t sum = real_t(0);
+	for(size_t j = 0; j < m; ++j)
+		sum += x[j];
+	real_t const scale = block.total / sum;
+
+	// CDF(x_j) is the sum of the spacings up to j (from the bottom) ...
+	real_t cdf = block.below;
+	size_t j = 0;
+	for(; j < m; ++j)
+	{
+		real_t const next = cdf + x[j] * scale;
+		if(next > real_t(0.5)) break;
+
+		cdf = next;
+		x[j] = cdf;
+	}
+	size_t const numSmall = j;
+
+	// ... and CompCDF(x_j) is the sum of the spacings after j (from the top)
+	real_t ccdf = block.above;
+	for(j = m; j-- > numSmall;)
+	{
+		real_t const spacing = x[j] * scale;
+		x[j] = ccdf;
+		ccdf += spacing;
+	}
+
+	dist.Q_small(x, x, numSmall);
+	dist.Q_large(x + numSmall, x + numSmall, m - numSmall);
+
+	for(j = 1; j < m; ++j)
+		x[j] = std::max(x[j], x[j - 1]);
+}
+
+// Each block is sorted, so only a near-tie across the edge of a block (at begin) can be out of order
+static void SortedSeam(pqRand::real_t* const sample, size_t const begin, size_t const sampleSize)
+{
+	for(size_t j = begin; (j < sampleSize) and (sample[j] < sample[j - 1]); ++j)
+		sample[j] = sample[j - 1];
+}
+
+////////////////////////////////////////////////////////////////////////
+
+size_t constexpr pqRand::distributionQ2::sortedBlockSize;
+
+void pqRand::distributionQ2::FillSorted(real_t* const sample, size_t const sampleSize, engine& gen) const
+{
+	if(sampleSize == 0) return;
+
+	auto const blocks = SortedBlocks(sampleSize, sortedBlockSize, gen);
+
+	for(size_t b = 0; b < blocks.size(); ++b)
+	{
+		size_t const begin = b * sortedBlockSize;
+		SortedBlock(*this, blocks[b], sample + begin, std::min(sortedBlockSize, sampleSize - begin), gen);
+
+		if(b > 0)
+			SortedSeam(sample, begin, sampleSize);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::vector<pqRand::real_t> pqRand::distributionQ2::GetSortedSample(size_t const sampleSize,
+	engine& gen) const
+{
+	std::vector<real_t> sample(sampleSize);
+	FillSorted(sample.data(), sampleSize, gen);
+
+	return sample;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+#if PRNG_CAN_JUMP
+void pqRand::distributionQ2::FillSorted_Parallel(real_t* const sample, size_t const sampleSize,
+	engine& gen, size_t const numThreads) const
+{
+	if(sampleSize == 0) return;
+
+	auto const blocks = SortedBlocks(sampleSize, sortedBlockSize, gen);
+	size_t const numBlocks = blocks.size();
+
+	ForEachJumpedBlock(numBlocks, numThreads, gen, [&](size_t const block, engine& blockGen)
+	{
+		size_t const begin = block * sortedBlockSize;
+		SortedBlock(*this, blocks[block], sample + begin,
+			std::min(sortedBlockSize, sampleSize - begin), blockGen);
+	});
+
+	for(size_t b = 1; b < numBlocks; ++b)
+		SortedSeam(sample, b * sortedBlockSize, sampleSize);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::vector<pqRand::real_t> pqRand::distributionQ2::GetSortedSample_Parallel(size_t const sampleSize,
+	engine& gen, size_t const numThreads) const
+{
+	std::vector<real_t> sample(sampleSize);
+	FillSorted_Parallel(sample.data(), sampleSize, gen, numThreads);
+
+	return sample;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::distributionQ2::Q_small_array(real_t const* const u, real_t* const x, size_t const n) const
+{
+	for(size_t i = 0; i < n; ++i)
+		x[i] = Q_small(u[i]);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::distributionQ2::Q_large_array(real_t const* const u, real_t* const x, size_t const n) const
+{
+	for(size_t i = 0; i < n; ++i)
+		x[i] = Q_large(u[i]);
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+pqRand::uniform::uniform(real_t const min_in, real_t const max_in):
+	kernel(min_in, max_in) {}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::uniform::PDF_supported(real_t const x) const
+{
+	return kernel.PDF_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::uniform::CDF_small_supported(real_t const x) const
+{
+	return kernel.CDF_small_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::uniform::CDF_large_supported(real_t const x) const
+{
+	return kernel.CDF_large_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::uniform::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	static_dist::uniform const dist = kernel;
+
+	ApplyKernel(x, pdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.PDF_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::uniform::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	static_dist::uniform const dist = kernel;
+
+	ApplyKernel(x, cdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_small_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::uniform::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	static_dist::uniform const dist = kernel;
+
+	ApplyKernel(x, ccdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_large_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::uniform::operator()(pqRand::engine& gen) const
+{
+	return kernel(gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::uniform::Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
+{
+	kernel.Fill(sample, sampleSize, gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// The formulas of standard_normal, normal and log_normal, with libm (static_dist::libm, 
+// for the scalar functions) or vmath (vmath::math, for the array kernels).
+// standard_normal passes (mu, sigma) = (0, 1), which changes none of the roundings.
+
+template<class math>
+PQR_ALWAYS_INLINE pqRand::real_t Normal_PDF(pqRand::real_t const x, 
+	pqRand::real_t const mu, pqRand::real_t const sigma)
+{
+	return math::Exp(-pqRand::real_t(0.5)*pqRand::Squared(x - mu)/pqRand::Squared(sigma))/
+		(sigma*pqRand::real_t(std::sqrt(2*M_PI)));
+}
+
+// To use the error function we have to add, creating a cancellation
+template<class math>
+PQR_ALWAYS_INLINE pqRand::real_t Normal_CDF_small(pqRand::real_t const x, 
+	pqRand::real_t const mu, pqRand::real_t const sigma)
+{
+	return pqRand::real_t(0.5)*math::Erfc((mu - x)/(std::sqrt(pqRand::real_t(2))*sigma));
+}
+
+template<class math>
+PQR_ALWAYS_INLINE pqRand::real_t Normal_CDF_large(pqRand::real_t const x, 
+	pqRand::real_t const mu, pqRand::real_t const sigma)
+{
+	return pqRand::real_t(0.5)*math::Erfc((x - mu)/(std::sqrt(pqRand::real_t(2))*sigma));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Checked PDF/CDF (16.12.2017 @ 11:33)
+pqRand::real_t pqRand::standard_normal::PDF_supported(real_t const x) const
+{
+	return Normal_PDF<static_dist::libm>(x, real_t(0), real_t(1));
+}
+
+////////////////////////////////////////////////////////////////////////
+				
+pqRand::real_t pqRand::standard_normal::CDF_small_supported(real_t const x) const
+{
+	return Normal_CDF_small<static_dist::libm>(x, real_t(0), real_t(1));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+pqRand::real_t pqRand::standard_normal::CDF_large_supported(real_t const x) const
+{
+	return Normal_CDF_large<static_dist::libm>(x, real_t(0), real_t(1));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::standard_normal::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	ApplyKernel(x, pdf, n, [](real_t const x_i) PQR_KERNEL
+		{return Normal_PDF<vmath::math>(x_i, real_t(0), real_t(1));});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::standard_normal::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	ApplyKernel(x, cdf, n, [](real_t const x_i) PQR_KERNEL
+		{return Normal_CDF_small<vmath::math>(x_i, real_t(0), real_t(1));});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::standard_normal::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	ApplyKernel(x, ccdf, n, [](real_t const x_i) PQR_KERNEL
+		{return Normal_CDF_large<vmath::math>(x_i, real_t(0), real_t(1));});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::standard_normal::operator()(pqRand::engine& gen) const
+{
+	if(valueCached)
+	{
+		valueCached = false;
+		return cache;
+	}
+	else
+	{
+		valueCached = true;
+		two const pair = GetTwo(gen);
+		cache = pair.y;
+		return pair.x;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::two pqRand::standard_normal::GetTwo(pqRand::engine& gen) const
+{
+	two pair;
+	real_t u;
+	
+	#if PQR_REJECTION_STATS
+	uint64_t proposals = 0;
+	#endif
+	
+	// The Marsaglia polar method -- modeled after GNU's std::normal_distribution 
+	// (bits/random.tcc, line 1925, <https://gcc.gnu.org/onlinedocs/gcc-4.8.5/libstdc++/api/a01147_source.html>)
+	// on or about March 2017 -- but with the added precision of the quantile flip-flop and U_Q.
+	// As such, we don't do x = (1 - U) to get a cheap random sign; 
+	// this destroys the precision of quasiuniform U.
+	do
+	{
+		pair.x = gen.U_uneven();
+		pair.y = gen.U_uneven();
+	
+		// Draw x and y from U, and reject when we don't land in the circle
+		u = pair.x*pair.x + pair.y*pair.y;
+		
+		// Reject 2/3 of the region that rounds to 1
+		// (we want the epsilon/2 to the left of 1, but not the epsilon the right of 1).
+		// There is a small region near (1, 0), (0, 1), etc. where the right region 
+		// doesn't exist, but it is vanishingly small).
+		if(ExactlyEqual(u, real_t(1)) and (gen.U_even()*real_t(3) < real_t(2)))
+			u = 2.; // Easy way to reject
+			
+		#if PQR_REJECTION_STATS
+		++proposals;
+		#endif
+	}
+	while(u > real_t(1));
+	
+	#if PQR_REJECTION_STATS
+	rejections.Record(proposals);
+	#endif
+
+	// Give x and y a random sign via the pqRand::engine (using its bitCache)
+	gen.ApplyRandomSign(pair.x);
+	gen.ApplyRandomSign(pair.y);
+	
+	// Implement the quantile flip-flop and scale x and y
+	u = (gen.RandBool() ? 
+		std::sqrt(-real_t(2)*std::log(real_t(0.5)*u)/u) : 
+		std::sqrt(-real_t(2)*std::log1p(-real_t(0.5)*u)/u));		
+	
+	pair.x *= u;
+	pair.y *= u;
+	
+	return pair;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::standard_normal::Fill
+	(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
+{
+	size_t const loopSize = sampleSize/2;
+	
+	for(size_t i = 0; i < loopSize; ++i)
+	{
+		two const pair = this->GetTwo(gen);
+		sample[2*i] = pair.x;
+		sample[2*i + 1] = pair.y;
+	}
+	
+	// If sampleSize is odd, draw one more pair and discard y (don't cache it)
+	if(2*loopSize < sampleSize)
+		sample[2*loopSize] = this->GetTwo(gen).x;
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+pqRand::normal::normal(real_t const mu_in, real_t const sigma_in):
+	standard_normal(), mu_(mu_in), sigma_(sigma_in) 
+{
+	if(sigma_ <= real_t(0)) throw std::domain_error("pqRand::normal: sigma must be greater than zero!");
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Normal takes numbers from standard_normal and adjusts them to sigma and mu
+typename pqRand::two pqRand::normal::GetTwo(pqRand::engine& gen) const
+{
+	two pair = pqRand::standard_normal::GetTwo(gen);
+	
+	pair.x = mu_ + sigma_ * pair.x;
+	pair.y = mu_ + sigma_ * pair.y;
+	
+	return pair;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Checked PDF/CDF (16.12.2017 @ 11:35)
+typename pqRand::real_t pqRand::normal::PDF_supported(real_t const x) const
+{
+	return Normal_PDF<static_dist::libm>(x, mu_, sigma_);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::normal::CDF_small_supported(real_t const x) const
+{
+	return Normal_CDF_small<static_dist::libm>(x, mu_, sigma_);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::normal::CDF_large_supported(real_t const x) const
+{
+	return Normal_CDF_large<static_dist::libm>(x, mu_, sigma_);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::normal::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	ApplyKernel(x, pdf, n, [this](real_t const x_i) PQR_KERNEL
+		{return Normal_PDF<vmath::math>(x_i, mu_, sigma_);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::normal::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	ApplyKernel(x, cdf, n, [this](real_t const x_i) PQR_KERNEL
+		{return Normal_CDF_small<vmath::math>(x_i, mu_, sigma_);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::normal::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	ApplyKernel(x, ccdf, n, [this](real_t const x_i) PQR_KERNEL
+		{return Normal_CDF_large<vmath::math>(x_i, mu_, sigma_);});
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// This is the syntax to catch an exception from the super-ctor
+pqRand::log_normal::log_normal(real_t const mu_in, real_t const sigma_in)
+try : normal(mu_in, sigma_in), muScale(std::exp(mu_)) {}
+catch(std::domain_error const& e)
+{
+	// Catch a domain_error from normal, to rename it (and redirect blame)
+	throw std::domain_error("pqRand::log_normal: sigma must be greater than zero!");
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Checked PDF/CDF (16.12.2017 @ 11:36)
+typename pqRand::real_t pqRand::log_normal::PDF_supported(real_t const x) const
+{
+	return normal::PDF_supported(std::log(x))/x;
+}
+
+////////////////////////////////////////////////////////////////////////
+		
+typename pqRand::real_t pqRand::log_normal::CDF_small_supported(real_t const x) const
+{
+	return normal::CDF_small_supported(std::log(x));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::log_normal::CDF_large_supported(real_t const x) const
+{
+	return normal::CDF_large_supported(std::log(x));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::log_normal::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	ApplyKernel(x, pdf, n, [this](real_t const x_i) PQR_KERNEL
+		{return Normal_PDF<vmath::math>(vmath::Log(x_i), mu_, sigma_)/x_i;});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::log_normal::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	ApplyKernel(x, cdf, n, [this](real_t const x_i) PQR_KERNEL
+		{return Normal_CDF_small<vmath::math>(vmath::Log(x_i), mu_, sigma_);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::log_normal::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	ApplyKernel(x, ccdf, n, [this](real_t const x_i) PQR_KERNEL
+		{return Normal_CDF_large<vmath::math>(vmath::Log(x_i), mu_, sigma_);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::log_normal::Mean() const 
+{
+	return std::exp(mu_ + real_t(0.5)*Squared(sigma_));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::log_normal::Variance() const 
+{
+	return std::exp(real_t(2)*mu_ + Squared(sigma_))*std::expm1(Squared(sigma_));
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Log_normal also takes from standard_normal, then exponentiates
+typename pqRand::two pqRand::log_normal::GetTwo(pqRand::engine& gen) const
+{
+	// Draw from standard normal, apply mu as a multiplicative scale
+	two pair = pqRand::standard_normal::GetTwo(gen);
+	
+	pair.x = muScale * std::exp(sigma_ * pair.x);
+	pair.y = muScale * std::exp(sigma_ * pair.y);
+	
+	return pair;
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+pqRand::weibull::weibull(real_t const lambda_in, real_t const k_in):
+	kernel(lambda_in, k_in) {}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::weibull::PDF_supported(real_t const x) const
+{
+	return kernel.PDF_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::weibull::CDF_small_supported(real_t const x) const
+{
+	return kernel.CDF_small_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::weibull::CDF_large_supported(real_t const x) const
+{
+	return kernel.CDF_large_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::weibull::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	static_dist::weibull const dist = kernel;
+
+	ApplyKernel(x, pdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.PDF_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::weibull::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	static_dist::weibull const dist = kernel;
+
+	ApplyKernel(x, cdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_small_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::weibull::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	static_dist::weibull const dist = kernel;
+
+	ApplyKernel(x, ccdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_large_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::weibull::Mean() const
+{
+	return kernel.Mean();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::weibull::Variance() const
+{
+	return kernel.Variance();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::weibull::Q_small(real_t const u) const
+{
+	return kernel.Q_small(u);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::weibull::Q_large(real_t const u) const
+{
+	return kernel.Q_large(u);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::weibull::Q_small_array(real_t const* const u, real_t* const x, size_t const n) const
+{
+	static_dist::weibull const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_small<vmath::math>(u_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::weibull::Q_large_array(real_t const* const u, real_t* const x, size_t const n) const
+{
+	static_dist::weibull const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_large<vmath::math>(u_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// The flip-flop of static_dist::distributionQ2 (the same draws as distributionQ2::operator()),
+// with Q_small/Q_large inlined instead of called virtually
+typename pqRand::real_t pqRand::weibull::operator()(pqRand::engine& gen) const
+{
+	return kernel(gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::weibull::Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
+{
+	kernel.Fill(sample, sampleSize, gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+pqRand::pareto::pareto(real_t const xMin_in, real_t const alpha_in):
+	kernel(xMin_in, alpha_in) {}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::pareto::Mean() const
+{
+	return kernel.Mean();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::pareto::Variance() const
+{
+	return kernel.Variance();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::pareto::operator()(pqRand::engine& gen) const
+{
+	return kernel(gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::pareto::Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
+{
+	kernel.Fill(sample, sampleSize, gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::pareto::PDF_supported(real_t const x) const
+{
+	return kernel.PDF_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::pareto::CDF_small_supported(real_t const x) const
+{
+	return kernel.CDF_small_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::pareto::CDF_large_supported(real_t const x) const
+{
+	return kernel.CDF_large_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::pareto::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	static_dist::pareto const dist = kernel;
+
+	ApplyKernel(x, pdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.PDF_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::pareto::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	static_dist::pareto const dist = kernel;
+
+	ApplyKernel(x, cdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_small_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::pareto::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	static_dist::pareto const dist = kernel;
+
+	ApplyKernel(x, ccdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_large_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+pqRand::exponential::exponential(real_t const lambda_in):
+	kernel(lambda_in) {}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::exponential::PDF_supported(real_t const x) const
+{
+	return kernel.PDF_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::exponential::CDF_small_supported(real_t const x) const
+{
+	return kernel.CDF_small_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::exponential::CDF_large_supported(real_t const x) const
+{
+	return kernel.CDF_large_supported(x);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::exponential::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	static_dist::exponential const dist = kernel;
+
+	ApplyKernel(x, pdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.PDF_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::exponential::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
+{
+	static_dist::exponential const dist = kernel;
+
+	ApplyKernel(x, cdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_small_supported<vmath::math>(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::exponential::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
+{
+	static_dist::exponential const dist = kernel;
+
+	ApplyKernel(x, ccdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_large_supported<vmath::math>(x_i);});
 }
 
-////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::normal::normal(real_t const mu_in, real_t const sigma_in):
-	standard_normal(), mu_(mu_in), sigma_(sigma_in) 
+typename pqRand::real_t pqRand::exponential::Q_small(real_t const u) const
 {
-	if(sigma_ <= real_t(0)) throw std::domain_error("pqRand::normal: sigma must be greater than zero!");
+	return kernel.Q_small(u);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-// Normal takes numbers from standard_normal and adjusts them to sigma and mu
-typename pqRand::two pqRand::normal::GetTwo(pqRand::engine& gen) const
+typename pqRand::real_t pqRand::exponential::Q_large(real_t const u) const
 {
-	two pair = pqRand::standard_normal::GetTwo(gen);
-	
-	pair.x = mu_ + sigma_ * pair.x;
-	pair.y = mu_ + sigma_ * pair.y;
-	
-	return pair;
+	return kernel.Q_large(u);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-// Checked PDF/CDF (16.12.2017 @ 11:35)
-typename pqRand::real_t pqRand::normal::PDF_supported(real_t const x) const
+void pqRand::exponential::Q_small_array(real_t const* const u, real_t* const x, size_t const n) const
 {
-	return std::exp(-real_t(0.5)*Squared(x - mu_)/Squared(sigma_))/
-			(sigma_*real_t(std::sqrt(2*M_PI)));
+	static_dist::exponential const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_small<vmath::math>(u_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::normal::CDF_small_supported(real_t const x) const
+void pqRand::exponential::Q_large_array(real_t const* const u, real_t* const x, size_t const n) const
 {
-	return real_t(0.5)*std::erfc((mu_-x)/(std::sqrt(real_t(2))*sigma_));
+	static_dist::exponential const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_large<vmath::math>(u_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::normal::CDF_large_supported(real_t const x) const
+// The flip-flop of static_dist::distributionQ2 (the same draws as distributionQ2::operator()),
+// with Q_small/Q_large inlined instead of called virtually
+typename pqRand::real_t pqRand::exponential::operator()(pqRand::engine& gen) const
 {
-	return real_t(0.5)*std::erfc((x-mu_)/(std::sqrt(real_t(2))*sigma_));
+	return kernel(gen);
 }
 
-////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-// This is the syntax to catch an exception from the super-ctor
-pqRand::log_normal::log_normal(real_t const mu_in, real_t const sigma_in)
-try : normal(mu_in, sigma_in), muScale(std::exp(mu_)) {}
-catch(std::domain_error const& e)
+void pqRand::exponential::Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
 {
-	// Catch a domain_error from normal, to rename it (and redirect blame)
-	throw std::domain_error("pqRand::log_normal: sigma must be greater than zero!");
+	kernel.Fill(sample, sampleSize, gen);
 }
 
+////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-// Checked PDF/CDF (16.12.2017 @ 11:36)
-typename pqRand::real_t pqRand::log_normal::PDF_supported(real_t const x) const
-{
-	return normal::PDF_supported(std::log(x))/x;
-}
+pqRand::logistic::logistic(real_t const mu_in, real_t const s_in):
+	kernel(mu_in, s_in) {}
 
 ////////////////////////////////////////////////////////////////////////
-		
-typename pqRand::real_t pqRand::log_normal::CDF_small_supported(real_t const x) const
+
+typename pqRand::real_t pqRand::logistic::PDF_supported(real_t const x) const
 {
-	return normal::CDF_small_supported(std::log(x));
+	return kernel.PDF_supported(x);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::log_normal::CDF_large_supported(real_t const x) const
+typename pqRand::real_t pqRand::logistic::CDF_small_supported(real_t const x) const
 {
-	return normal::CDF_large_supported(std::log(x));
+	return kernel.CDF_small_supported(x);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::log_normal::Mean() const 
+typename pqRand::real_t pqRand::logistic::CDF_large_supported(real_t const x) const
 {
-	return std::exp(mu_ + real_t(0.5)*Squared(sigma_));
+	return kernel.CDF_large_supported(x);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::log_normal::Variance() const 
+void pqRand::logistic::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
 {
-	return std::exp(real_t(2)*mu_ + Squared(sigma_))*std::expm1(Squared(sigma_));
+	static_dist::logistic const dist = kernel;
+
+	ApplyKernel(x, pdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.PDF_supported<vmath::math>(x_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-// Log_normal also takes from standard_normal, then exponentiates
-typename pqRand::two pqRand::log_normal::GetTwo(pqRand::engine& gen) const
+void pqRand::logistic::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
 {
-	// Draw from standard normal, apply mu as a multiplicative scale
-	two pair = pqRand::standard_normal::GetTwo(gen);
-	
-	pair.x = muScale * std::exp(sigma_ * pair.x);
-	pair.y = muScale * std::exp(sigma_ * pair.y);
-	
-	return pair;
+	static_dist::logistic const dist = kernel;
+
+	ApplyKernel(x, cdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_small_supported<vmath::math>(x_i);});
 }
 
-////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::weibull::weibull(real_t const lambda_in, real_t const k_in):
-	lambda_(lambda_in), k_(k_in), kRecip(real_t(1)/k_)
+void pqRand::logistic::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
 {
-	if(lambda_ <= real_t(0)) 
-		throw std::domain_error("pqRand::weibull: lambda must be greater than zero!");
-	if(kRecip <= real_t(0))
-		throw std::domain_error("pqRand::weibull: k must be greater than zero!");
+	static_dist::logistic const dist = kernel;
+
+	ApplyKernel(x, ccdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_large_supported<vmath::math>(x_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-// Checked PDF/CDF (16.12.2017 @ 11:39)
-typename pqRand::real_t pqRand::weibull::PDF_supported(real_t const x) const
+typename pqRand::real_t pqRand::logistic::Q_small(real_t const u) const
 {
-	real_t const xOverLambda = x / lambda_;
-	real_t const xl2kminus1 = std::pow(xOverLambda, k_ - real_t(1));
-	
-	return (std::exp(-xl2kminus1 * xOverLambda) * xl2kminus1 * k_)/lambda_;
+	return kernel.Q_small(u);
 }
 
 ////////////////////////////////////////////////////////////////////////
-					
-typename pqRand::real_t pqRand::weibull::CDF_small_supported(real_t const x) const
+
+typename pqRand::real_t pqRand::logistic::Q_large(real_t const u) const
 {
-	return -std::expm1(-std::pow(x/lambda_, k_));
+	return kernel.Q_large(u);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::weibull::CDF_large_supported(real_t const x) const 
+void pqRand::logistic::Q_small_array(real_t const* const u, real_t* const x, size_t const n) const
 {
-	return std::exp(-std::pow(x/lambda_, k_));
+	static_dist::logistic const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_small<vmath::math>(u_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::weibull::Mean() const 
+void pqRand::logistic::Q_large_array(real_t const* const u, real_t* const x, size_t const n) const
 {
-	return lambda_ * std::tgamma(real_t(1) + real_t(1) / k_);
+	static_dist::logistic const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_large<vmath::math>(u_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::weibull::Variance() const 
+// The flip-flop of static_dist::distributionQ2 (the same draws as distributionQ2::operator()),
+// with Q_small/Q_large inlined instead of called virtually
+typename pqRand::real_t pqRand::logistic::operator()(pqRand::engine& gen) const
 {
-	return Squared(lambda_) * 
-				(std::tgamma(real_t(1) + real_t(2) / k_) - 
-					Squared(std::tgamma(real_t(1) + real_t(1) / k_)));
+	return kernel(gen);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::weibull::Q_small(real_t const u) const
+void pqRand::logistic::Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
 {
-	return lambda_ * std::pow(-std::log1p(-u), kRecip);
+	kernel.Fill(sample, sampleSize, gen);
 }
 
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+pqRand::log_logistic::log_logistic(real_t const alpha_in, real_t const beta_in):
+	kernel(alpha_in, beta_in) {}
+
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::weibull::Q_large(real_t const u) const
+typename pqRand::real_t pqRand::log_logistic::PDF_supported(real_t const x) const
 {
-	return lambda_ * std::pow(-std::log(u), kRecip);
+	return kernel.PDF_supported(x);
 }
 
-////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::pareto::pareto(real_t const xMin_in, real_t const alpha_in):
-	xMin(xMin_in), alpha_(alpha_in), negRecipAlpha(-real_t(1)/alpha_), 
-	alpha_xM2alpha(alpha_*std::pow(xMin, alpha_))
+typename pqRand::real_t pqRand::log_logistic::CDF_small_supported(real_t const x) const
 {
-	if(xMin <= real_t(0)) 
-		throw std::domain_error("pqRand::pareto: x_m must be greater than zero!");
-	if(negRecipAlpha >= real_t(0)) 
-		throw std::domain_error("pqRand::pareto: alpha must be greater than zero!");
+	return kernel.CDF_small_supported(x);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::pareto::Mean() const 
+typename pqRand::real_t pqRand::log_logistic::CDF_large_supported(real_t const x) const
 {
-	return (alpha_ <= real_t(1)) ? INFINITY : alpha_ * xMin / (alpha_ - real_t(1));
+	return kernel.CDF_large_supported(x);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::pareto::Variance() const 
+void pqRand::log_logistic::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
 {
-	return (alpha_ <= real_t(2)) ? INFINITY : 
-		alpha_ * Squared(xMin) / (Squared(alpha_ - real_t(1)) * (alpha_ - real_t(2)));
-}			
+	static_dist::log_logistic const dist = kernel;
+
+	ApplyKernel(x, pdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.PDF_supported<vmath::math>(x_i);});
+}
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::pareto::operator()(pqRand::engine& gen) const
+void pqRand::log_logistic::CDF_small_array(real_t const* const x, real_t* const cdf, size_t const n) const
 {
-	return xMin * std::pow(gen.U_uneven(), negRecipAlpha);
+	static_dist::log_logistic const dist = kernel;
+
+	ApplyKernel(x, cdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_small_supported<vmath::math>(x_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-// Checked PDF/CDF (16.12.2017 @ 11:43)
-typename pqRand::real_t pqRand::pareto::PDF_supported(real_t const x) const
+void pqRand::log_logistic::CDF_large_array(real_t const* const x, real_t* const ccdf, size_t const n) const
 {
-	return std::pow(x, -(alpha_ + real_t(1)))*alpha_xM2alpha;
+	static_dist::log_logistic const dist = kernel;
+
+	ApplyKernel(x, ccdf, n, [dist](real_t const x_i) PQR_KERNEL {return dist.CDF_large_supported<vmath::math>(x_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
-					
-typename pqRand::real_t pqRand::pareto::CDF_small_supported(real_t const x) const 
+
+typename pqRand::real_t pqRand::log_logistic::Mean() const
 {
-	return -std::expm1(alpha_ * std::log(xMin/x));
+	return kernel.Mean();
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::pareto::CDF_large_supported(real_t const x) const
+typename pqRand::real_t pqRand::log_logistic::Variance() const
 {
-	return std::exp(alpha_ * std::log(xMin/x));
+	return kernel.Variance();
 }
 
-////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::exponential::exponential(real_t const lambda_in):
-	lambda_(lambda_in)
+typename pqRand::real_t pqRand::log_logistic::Q_small(real_t const u) const
 {
-	if(lambda_ <= real_t(0))
-		throw std::domain_error("pqRand::exponential: lambda must be greater than zero!");
+	return kernel.Q_small(u);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-// Checked PDF/CDF (16.12.2017 @ 11:43)
-typename pqRand::real_t pqRand::exponential::PDF_supported(real_t const x) const
+typename pqRand::real_t pqRand::log_logistic::Q_large(real_t const u) const
 {
-	return lambda_ * std::exp(-lambda_ * x);
+	return kernel.Q_large(u);
 }
 
 ////////////////////////////////////////////////////////////////////////
-					
-typename pqRand::real_t pqRand::exponential::CDF_small_supported(real_t const x) const
+
+void pqRand::log_logistic::Q_small_array(real_t const* const u, real_t* const x, size_t const n) const
 {
-	return -std::expm1(-lambda_ * x);
+	static_dist::log_logistic const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_small<vmath::math>(u_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::exponential::CDF_large_supported(real_t const x) const
+void pqRand::log_logistic::Q_large_array(real_t const* const u, real_t* const x, size_t const n) const
 {
-	return std::exp(-lambda_ * x);
+	static_dist::log_logistic const dist = kernel;
+
+	ApplyKernel(u, x, n, [dist](real_t const u_i) PQR_KERNEL {return dist.Q_large<vmath::math>(u_i);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::exponential::Q_small(real_t const u) const
+// The flip-flop of static_dist::distributionQ2 (the same draws as distributionQ2::operator()),
+// with Q_small/Q_large inlined instead of called virtually
+typename pqRand::real_t pqRand::log_logistic::operator()(pqRand::engine& gen) const
 {
-	return -std::log1p(-u)/lambda_;
+	return kernel(gen);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::exponential::Q_large(real_t const u) const
+void pqRand::log_logistic::Fill(real_t* const sample, size_t const sampleSize, pqRand::engine& gen) const
 {
-	return -std::log(u)/lambda_;
+	kernel.Fill(sample, sampleSize, gen);
 }
 
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::logistic::logistic(real_t const mu_in, real_t const s_in):
-	mu_(mu_in), s_(s_in)
+// The tables read the binade and the piece of u from its bits
+static_assert(std::numeric_limits<pqRand::real_t>::is_iec559 and (std::numeric_limits<pqRand::real_t>::digits == 53),
+	"pqRand::quantile_table: real_t must be an IEEE double");
+
+constexpr pqRand::real_t pqRand::quantile_table::minU;
+constexpr size_t pqRand::quantile_table::numBinades;
+constexpr size_t pqRand::quantile_table::maxLog2Pieces;
+constexpr size_t pqRand::quantile_table::order;
+
+// Map each real to a uint64_t of the same order (-0 just below +0),
+// so that bisection halves the number of reals between its bounds (not their distance)
+static uint64_t OrderedBits(pqRand::real_t const x)
 {
-	if(s_ <= real_t(0))
-		throw std::domain_error("pqRand::exponential: s must be greater than zero!");
+	uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	return (bits >> 63) ? compl bits : (bits bitor (uint64_t(1) << 63));
 }
 
-////////////////////////////////////////////////////////////////////////
+static pqRand::real_t FromOrderedBits(uint64_t const ordered)
+{
+	uint64_t const bits = (ordered >> 63) ? (ordered bitand compl (uint64_t(1) << 63)) : compl ordered;
+	pqRand::real_t x;
+	std::memcpy(&x, &bits, sizeof(x));
+	return x;
+}
 
-// Checked PDF/CDF (16.12.2017 @ 11:44)
-typename pqRand::real_t pqRand::logistic::PDF_supported(real_t const x) const
+// The smallest x in [min, max] which has reached the target (reached must be monotonic in x),
+// in at most 64 steps (there are fewer than 2**64 reals)
+template<class reached_t>
+static pqRand::real_t Bisect(pqRand::distributionCDF const& dist, reached_t const& reached)
 {
-	real_t const expTerm = std::exp(-(x-mu_)/s_);
+	using pqRand::real_t;
+	
+	real_t const xMin = std::max(dist.min(), std::numeric_limits<real_t>::lowest());
+	real_t const xMax = std::min(dist.max(), std::numeric_limits<real_t>::max());
+	
+	if(reached(xMin)) return xMin;
+	
+	// reached(max) is true (the CDF is 1 there), so the answer is in (lo, hi]
+	uint64_t lo = OrderedBits(xMin);
+	uint64_t hi = OrderedBits(xMax);
+	
+	while((hi - lo) > 1)
+	{
+		uint64_t const mid = lo + (hi - lo)/2;
+		
+		if(reached(FromOrderedBits(mid)))
+			hi = mid;
+		else
+			lo = mid;
+	}
 	
-	return expTerm/(s_ * Squared(real_t(1) + expTerm));
+	return FromOrderedBits(hi);
 }
 
 ////////////////////////////////////////////////////////////////////////
-								
-typename pqRand::real_t pqRand::logistic::CDF_small_supported(real_t const x) const
+
+typename pqRand::real_t pqRand::quantile_table::Invert_small(distributionCDF const& dist, real_t const u)
 {
-	return real_t(1) / (real_t(1) + std::exp(-(x-mu_)/s_));
+	return Bisect(dist, [&dist, u](real_t const x) {return (dist.CDF(x) >= u);});
 }
 
 ////////////////////////////////////////////////////////////////////////
-	
-typename pqRand::real_t pqRand::logistic::CDF_large_supported(real_t const x) const
+
+typename pqRand::real_t pqRand::quantile_table::Invert_large(distributionCDF const& dist, real_t const u)
 {
-	return real_t(1) / (real_t(1) + std::exp((x-mu_)/s_));
+	return Bisect(dist, [&dist, u](real_t const x) {return (dist.CompCDF(x) <= u);});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-//~ return mu_ + s_ * gen.ApplyRandomSign(std::log(real_t(1)/gen.HalfU_uneven() - real_t(1)));
+// Check uResolution before the key is made from it
+static pqRand::real_t QuantileTable_Resolution(pqRand::real_t const uResolution)
+{
+	if(not ((uResolution > pqRand::real_t(0)) and (uResolution < pqRand::real_t(1))))
+		throw std::domain_error("pqRand::quantile_table: uResolution must be in (0, 1)");
+	
+	return uResolution;
+}
 
-typename pqRand::real_t pqRand::logistic::Q_small(real_t const u) const
+pqRand::quantile_table::quantile_table(distributionCDF const& dist, real_t const uResolution):
+	smallTail(), largeTail(), maxError(0), key(Key(dist, QuantileTable_Resolution(uResolution), std::string()))
 {
-	return mu_ - s_ * std::log(real_t(1)/u - real_t(1));
+	BuildTables(dist, uResolution);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::logistic::Q_large(real_t const u) const
+pqRand::quantile_table::quantile_table(distributionCDF const& dist, real_t const uResolution, 
+	std::string const& filePath, std::string const& parameters):
+	smallTail(), largeTail(), maxError(0), key(Key(dist, QuantileTable_Resolution(uResolution), parameters))
 {
-	return mu_ + s_ * std::log(real_t(1)/u - real_t(1));
+	if(not Map(filePath))
+	{
+		BuildTables(dist, uResolution);
+		Write(filePath);
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////
+
+pqRand::quantile_table::~quantile_table() {}
+
 ////////////////////////////////////////////////////////////////////////
 
-pqRand::log_logistic::log_logistic(real_t const alpha_in, real_t const beta_in):
-	alpha_(alpha_in), beta_(beta_in), betaInverse(real_t(1)/beta_)
+std::string pqRand::quantile_table::Key(distributionCDF const& dist, real_t const uResolution, 
+	std::string const& parameters)
 {
-	if(alpha_ <= real_t(0))
-		throw std::domain_error("pqRand::exponential: alpha must be greater than zero!");
-	if(beta_ <= real_t(0))
-		throw std::domain_error("pqRand::exponential: beta must be greater than zero!");
+	// The type (with its terminating null) alone does not identify the distribution; 
+	// its exact quantiles at a few u (which depend on every parameter) nearly always do,
+	// and the caller's parameters always do. Only the parameters vary in length, so they come last.
+	char const* const type = typeid(dist).name();
+	std::string key(type, std::strlen(type) + 1);
+	key.append(reinterpret_cast<char const*>(&uResolution), sizeof(uResolution));
+	
+	for(int const exponent : {-1, -8, -64, -512})
+	{
+		real_t const u = std::ldexp(real_t(1), exponent);
+		real_t const x[2] = {Invert_small(dist, u), Invert_large(dist, u)};
+		key.append(reinterpret_cast<char const*>(x), sizeof(x));
+	}
+	
+	return key.append(parameters);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::log_logistic::PDF_supported(real_t const x) const
+void pqRand::quantile_table::BuildTables(distributionCDF const& dist, real_t const uResolution)
 {
-	real_t const xOverAlpha = x/alpha_;
-	real_t const xOverAlpha2betaMinus1 = std::pow(xOverAlpha, beta_ - real_t(1));
-					
-	return (xOverAlpha2betaMinus1 * beta_) / 
-		(alpha_ * Squared(real_t(1) + xOverAlpha2betaMinus1 * xOverAlpha));
+	// The tables, shared by copies of this quantile_table
+	struct built_tables
+	{
+		std::vector<binade> binades[2];
+		std::vector<real_t> coefficients[2];
+	};
+	
+	auto const tables = std::make_shared<built_tables>();
+	
+	Build(tables->binades[0], tables->coefficients[0], smallTail, dist, false, uResolution, maxError);
+	Build(tables->binades[1], tables->coefficients[1], largeTail, dist, true, uResolution, maxError);
+	
+	storage = tables;
 }
 
 ////////////////////////////////////////////////////////////////////////
-					
-typename pqRand::real_t pqRand::log_logistic::CDF_small_supported(real_t const x) const
+
+bool pqRand::quantile_table::Map(std::string const& filePath)
 {
-	return real_t(1) / (real_t(1) + std::pow(x/alpha_, -beta_));
+	// The key, the binades and coefficients of each tail, then (xHalf, xMinU) of each tail and maxError
+	std::vector<table_section> sections = {{key.data(), key.size()}, {}, {}, {}, {}, {}};
+	std::shared_ptr<void const> const map = MapTable(filePath, table_kind::quantile, 
+		uint32_t(order), sections);
+	
+	if(not (map and (sections[5].bytes == 5 * sizeof(real_t))))
+		return false;
+	
+	real_t const* const scalars = static_cast<real_t const*>(sections[5].data);
+	tail mapped[2];
+	
+	for(size_t t = 0; t < 2; ++t)
+	{
+		table_section const& binades = sections[2 * t + 1];
+		table_section const& coefficients = sections[2 * t + 2];
+		
+		if(not ((binades.bytes == numBinades * sizeof(binade)) 
+			and ((coefficients.bytes % (order * sizeof(real_t))) == 0)))
+			return false;
+		
+		mapped[t].binades = static_cast<binade const*>(binades.data);
+		mapped[t].coefficients = static_cast<real_t const*>(coefficients.data);
+		mapped[t].numPieces = coefficients.bytes / (order * sizeof(real_t));
+		mapped[t].xHalf = scalars[2 * t];
+		mapped[t].xMinU = scalars[2 * t + 1];
+		
+		// Every binade's pieces must be in the table (so a damaged file is never read out of bounds)
+		for(size_t b = 0; b < numBinades; ++b)
+		{
+			binade const& thisBinade = mapped[t].binades[b];
+			
+			if(not ((thisBinade.shift >= (52 - maxLog2Pieces)) and (thisBinade.shift <= 52) 
+				and ((size_t(thisBinade.first) + (size_t(1) << (52 - thisBinade.shift))) <= mapped[t].numPieces)))
+				return false;
+		}
+	}
+	
+	smallTail = mapped[0];
+	largeTail = mapped[1];
+	maxError = scalars[4];
+	storage = map;
+	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////
-	
-typename pqRand::real_t pqRand::log_logistic::CDF_large_supported(real_t const x) const
+
+void pqRand::quantile_table::Write(std::string const& filePath) const
 {
-	return real_t(1) / (real_t(1) + std::pow(x/alpha_, beta_));
+	if(not storage)
+		throw std::domain_error("pqRand::quantile_table::Write: the table is empty");
+	
+	real_t const scalars[5] = {smallTail.xHalf, smallTail.xMinU, largeTail.xHalf, largeTail.xMinU, maxError};
+	
+	WriteTable(filePath, table_kind::quantile, uint32_t(order), 
+		{{key.data(), key.size()}, {smallTail.binades, numBinades * sizeof(binade)}, {smallTail.coefficients, smallTail.numPieces * order * sizeof(real_t)}, 
+		{largeTail.binades, numBinades * sizeof(binade)}, {largeTail.coefficients, largeTail.numPieces * order * sizeof(real_t)},
+		{scalars, sizeof(scalars)}});
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::log_logistic::Mean() const 
+void pqRand::quantile_table::Build(std::vector<binade>& binades, std::vector<real_t>& coefficients, tail& table, 
+	distributionCDF const& dist, bool const large, real_t const uResolution, real_t& maxError)
 {
-	return (beta_ <= real_t(1)) ? INFINITY : 
-	(alpha_*M_PI)/(beta_ * std::sin(M_PI / beta_));
+	size_t constexpr degree = order - 1;
+	
+	// The Chebyshev points of the second kind (where the quantile is solved), s_i = cos(pi i / degree), 
+	// and the midpoints between them (where the interpolant is tested)
+	std::vector<real_t> sNode(order), sTest(degree);
+	for(size_t i = 0; i < order; ++i)
+		sNode[i] = std::cos(real_t(M_PI) * real_t(i) / real_t(degree));
+	for(size_t i = 0; i < degree; ++i)
+		sTest[i] = std::cos(real_t(M_PI) * (real_t(i) + real_t(0.5)) / real_t(degree));
+	
+	// The monomial coefficients of the Chebyshev polynomials T_0 ... T_degree
+	std::vector<real_t> chebyshev(order * order, real_t(0));
+	chebyshev[0] = real_t(1);
+	chebyshev[order + 1] = real_t(1);
+	for(size_t k = 2; k < order; ++k)
+		for(size_t i = 0; i < order; ++i)
+			chebyshev[k * order + i] = ((i > 0) ? real_t(2) * chebyshev[(k - 1) * order + i - 1] : real_t(0)) 
+				- chebyshev[(k - 2) * order + i];
+	
+	auto const Invert = [&dist, &large](real_t const u) // By reference (a bool would pad the closure)
+		{return large ? Invert_large(dist, u) : Invert_small(dist, u);};
+	
+	binades.clear();
+	coefficients.clear();
+	table.xHalf = Invert(real_t(0.5));
+	
+	std::vector<real_t> x(order), pieces, lastPieces;
+	real_t lastWorst = real_t(0);
+	
+	for(size_t b = 0; b < numBinades; ++b)
+	{
+		real_t const uLow = std::ldexp(real_t(1), -2 - int(b)); // The binade is [uLow, 2 uLow)
+		
+		for(size_t k = 0;; ++k)
+		{
+			size_t const numPieces = (size_t(1) << k);
+			
+			// u at s in piece j (the piece is f in [j, j + 1) / numPieces, with u = uLow * (1 + f))
+			auto const U = [uLow, numPieces](size_t const j, real_t const s)
+				{return uLow * (real_t(1) + (real_t(j) + real_t(0.5)*(s + real_t(1))) / real_t(numPieces));};
+			
+			pieces.assign(numPieces * order, real_t(0));
+			real_t worst = real_t(0);
+			
+			for(size_t j = 0; j < numPieces; ++j)
+			{
+				real_t* const c = pieces.data() + j * order;
+				
+				for(size_t i = 0; i < order; ++i)
+					x[i] = Invert(U(j, sNode[i]));
+				
+				// Interpolate the difference from the middle node (which is exact for nearby x), 
+				// so that a quantile far from zero (e.g. near a finite min) keeps its small variation precise
+				real_t const xRef = x[order / 2];
+				for(size_t i = 0; i < order; ++i)
+					x[i] -= xRef;
+				
+				// The Chebyshev coefficients of the interpolant (a discrete cosine transform), 
+				// accumulated as monomials in s
+				for(size_t m = 0; m < order; ++m)
+				{
+					real_t a = real_t(0);
+					for(size_t i = 0; i < order; ++i)
+						a += (((i == 0) or (i == degree)) ? real_t(0.5) : real_t(1)) * x[i] * 
+							std::cos(real_t(M_PI) * real_t(m * i) / real_t(degree));
+					a *= (((m == 0) or (m == degree)) ? real_t(1) : real_t(2)) / real_t(degree);
+					
+					for(size_t i = 0; i < order; ++i)
+						c[i] += a * chebyshev[m * order + i];
+				}
+				c[0] += xRef;
+				
+				for(size_t i = 0; i < degree; ++i)
+				{
+					real_t xHat = c[degree];
+					for(size_t m = degree; m-- > 0;)
+						xHat = xHat * sTest[i] + c[m];
+					
+					// Deep in a tail, even the exact quantile misses u by more than uResolution 
+					// (one ulp of x spans that much u), so only the error beyond x's rounding (by 2 ulp) counts
+					real_t const xDown = std::nextafter(std::nextafter(xHat, -INFINITY), -INFINITY);
+					real_t const xUp = std::nextafter(std::nextafter(xHat, INFINITY), INFINITY);
+					
+					real_t const u = U(j, sTest[i]);
+					real_t const uDown = large ? dist.CompCDF(xUp) : dist.CDF(xDown);
+					real_t const uUp = large ? dist.CompCDF(xDown) : dist.CDF(xUp);
+					
+					real_t const error = std::max(std::max(uDown - u, u - uUp), real_t(0)) / u;
+					
+					// A NaN error (e.g. from a NaN PDF) is the worst error
+					worst = (error <= worst) ? worst : error;
+				}
+			}
+			
+			// When halving the pieces did not halve the error, the CDF's own rounding error 
+			// (or a point where the quantile is not smooth) has been reached, so keep the last pieces
+			bool const stalled = (k > 0) and not (worst <= real_t(0.5) * lastWorst);
+			
+			if(stalled)
+			{
+				pieces.swap(lastPieces);
+				worst = lastWorst;
+			}
+			
+			if(stalled or (worst <= uResolution) or (k == maxLog2Pieces))
+			{
+				size_t const log2Pieces = stalled ? (k - 1) : k;
+				
+				binade newBinade;
+				newBinade.first = uint32_t(coefficients.size() / order);
+				newBinade.shift = uint32_t(52 - log2Pieces);
+				newBinade.sScale = std::ldexp(real_t(1), 1 - int(newBinade.shift));
+				binades.push_back(newBinade);
+				
+				coefficients.insert(coefficients.end(), pieces.begin(), pieces.end());
+				maxError = (worst <= maxError) ? maxError : worst;
+				break;
+			}
+			
+			pieces.swap(lastPieces);
+			lastWorst = worst;
+		}
+	}
+	
+	table.binades = binades.data();
+	table.coefficients = coefficients.data();
+	table.numPieces = coefficients.size() / order;
+	table.xMinU = Invert(minU);
 }
 
 ////////////////////////////////////////////////////////////////////////
-		
-typename pqRand::real_t pqRand::log_logistic::Variance() const
+
+typename pqRand::real_t pqRand::quantile_table::Evaluate(tail const& table, real_t const u)
 {
-	if (beta_ <= real_t(2)) return INFINITY;
+	uint64_t bits;
+	std::memcpy(&bits, &u, sizeof(bits));
+	
+	// u is in [2**e, 2**(e + 1)) with e = (biased exponent - 1023); binade b is e = -2 - b
+	int64_t const b = int64_t(1021) - int64_t(bits >> 52);
+	
+	if(b < 0) return table.xHalf; // u = 1/2 (or invalid)
+	if(b >= int64_t(numBinades)) return table.xMinU; // A subnormal u (or zero)
 	
-	real_t const b = M_PI / beta_;
+	binade const& thisBinade = table.binades[size_t(b)];
+	uint64_t const mantissa = bits bitand uint64_t(0x000fffffffffffff);
 	
-	return Squared(alpha_) * (b * (real_t(1)/std::cos(b) - b / std::sin(b)))/std::sin(b);
+	// The top bits of the mantissa choose the piece, the rest are s = 2t - 1 (exactly)
+	real_t const* const c = table.coefficients + order * (thisBinade.first + (mantissa >> thisBinade.shift));
+	real_t const s = real_t(mantissa bitand ((uint64_t(1) << thisBinade.shift) - 1)) * thisBinade.sScale - real_t(1);
+	
+	real_t x = c[order - 1];
+	for(size_t m = order - 1; m-- > 0;)
+		x = x * s + c[m];
+	
+	return x;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-//~ return alpha_ * std::pow(real_t(1)/gen.HalfU_uneven() - real_t(1), 
-		//~ gen.ApplyRandomSign(real_t(betaInverse))); // real_t to make a copy we can alter
-		
-typename pqRand::real_t pqRand::log_logistic::Q_small(real_t const u) const
+typename pqRand::real_t pqRand::quantile_table::Q_small(real_t const u) const
 {
-	return alpha_ * std::pow(real_t(1)/u - real_t(1), -betaInverse);
+	return (u <= real_t(0.5)) ? Evaluate(smallTail, u) : Evaluate(largeTail, real_t(1) - u);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-typename pqRand::real_t pqRand::log_logistic::Q_large(real_t const u) const
+typename pqRand::real_t pqRand::quantile_table::Q_large(real_t const u) const
 {
-	return alpha_ * std::pow(real_t(1)/u - real_t(1), betaInverse);
+	return (u <= real_t(0.5)) ? Evaluate(largeTail, u) : Evaluate(smallTail, real_t(1) - u);
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -733,6 +3211,13 @@ typename pqRand::real_t pqRand::gammaDist::PDF_supported(real_t const x) const
 
 ////////////////////////////////////////////////////////////////////////
 
+void pqRand::gammaDist::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	ApplyKernel(x, pdf, n, [this](real_t const x_i) PQR_KERNEL {return gammaDist::PDF_supported(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
 bool pqRand::gammaDist::Reject(real_t const x, pqRand::engine& gen) const
 {
 	real_t const xOverK = x / k_;
@@ -755,7 +3240,15 @@ typename pqRand::real_t pqRand::gammaDist::operator()(pqRand::engine& gen) const
 {
 	// sample from lambda = 1, then scale by the actual lambda.
 	real_t x;
+	
+	#if PQR_REJECTION_STATS
+	uint64_t proposals = 1;
+	while(Reject(x = proposal(gen), gen))
+		++proposals;
+	rejections.Record(proposals);
+	#else
 	while(Reject(x = proposal(gen), gen));
+	#endif
 	
 	return x / lambda_;
 }
@@ -763,12 +3256,93 @@ typename pqRand::real_t pqRand::gammaDist::operator()(pqRand::engine& gen) const
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
+pqRand::gammaDist_MarsagliaTsang::gammaDist_MarsagliaTsang(real_t const lambda_in, real_t const k_in):
+	lambda_(lambda_in), k_(k_in),
+	d(((k_ < real_t(1)) ? (k_ + real_t(1)) : k_) - real_t(1)/real_t(3)), 
+	c(real_t(1)/std::sqrt(real_t(9)*d)), 
+	kRecip(real_t(1)/k_),
+	lambda2k(std::pow(lambda_, k_)), logGamma_k(std::lgamma(k_)),
+	normal_(), boost(k_ < real_t(1)), padding()
+{
+	if(lambda_ <= real_t(0))
+		throw std::domain_error("pqRand::gammaDist_MarsagliaTsang: lambda must be greater than zero!");
+	// Written to also catch NaN
+	if(not (k_ > real_t(0)))
+		throw std::domain_error("pqRand::gammaDist_MarsagliaTsang: k must be greater than zero!");
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::gammaDist_MarsagliaTsang::PDF_supported(real_t const x) const
+{
+	return lambda2k * 
+		std::exp((k_ - real_t(1)) * std::log(x) - lambda_ * x - logGamma_k);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::gammaDist_MarsagliaTsang::PDF_array(real_t const* const x, real_t* const pdf, size_t const n) const
+{
+	ApplyKernel(x, pdf, n, [this](real_t const x_i) PQR_KERNEL {return gammaDist_MarsagliaTsang::PDF_supported(x_i);});
+}
+
+////////////////////////////////////////////////////////////////////////
+
+bool pqRand::gammaDist_MarsagliaTsang::Accept(real_t const x, pqRand::engine& gen, real_t& variate) const
+{
+	return MarsagliaTsang_Accept(d, c, x, gen, variate);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::gammaDist_MarsagliaTsang::Finalize(real_t const variate, pqRand::engine& gen) const
+{
+	// U_uneven is precise near zero, so the boosted small-value tail stays precise
+	return (boost ? (variate * std::pow(gen.U_uneven(), kRecip)) : variate) / lambda_;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+typename pqRand::real_t pqRand::gammaDist_MarsagliaTsang::operator()(pqRand::engine& gen) const
+{
+	real_t variate;
+	
+	#if PQR_REJECTION_STATS
+	uint64_t proposals = 1;
+	while(not Accept(normal_(gen), gen, variate))
+		++proposals;
+	rejections.Record(proposals);
+	#else
+	while(not Accept(normal_(gen), gen, variate));
+	#endif
+	
+	return Finalize(variate, gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void pqRand::gammaDist_MarsagliaTsang::Fill(real_t* const sample, size_t const sampleSize, 
+	pqRand::engine& gen) const
+{
+	// The draws of operator(), without a virtual call per variate. The spare normal of each pair 
+	// stays in normal_'s cache, so consecutive calls continue one stream (Fill(a) then Fill(b) equals Fill(a + b)).
+	for(size_t i = 0; i < sampleSize; ++i)
+		sample[i] = gammaDist_MarsagliaTsang::operator()(gen);
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
 // This version will draw 0 occasionally (when either x or y is 0, but never both).
 typename pqRand::two pqRand::standard_normal_lowPrecision::GetTwo(pqRand::engine& gen) const
 {
 	two pair;
 	real_t u;
 	
+	#if PQR_REJECTION_STATS
+	uint64_t proposals = 0;
+	#endif
+	
 	do
 	{
 		pair.x = real_t(1.) - real_t(2.) * gen.U_even();
@@ -776,8 +3350,16 @@ typename pqRand::two pqRand::standard_normal_lowPrecision::GetTwo(pqRand::engine
 	
 		// Draw x and y from U, and reject when we don't land in the circle
 		u = pair.x*pair.x + pair.y*pair.y;
+		
+		#if PQR_REJECTION_STATS
+		++proposals;
+		#endif
 	}
 	while(u >= real_t(1.) or (u == 0.));
+	
+	#if PQR_REJECTION_STATS
+	rejections.Record(proposals);
+	#endif
 
 	u = std::sqrt(real_t(-2.)*std::log(u)/u);
 	
@@ -33,7 +33,7 @@
 # We first declare the C++ functions we intend to call
 ########################################################################
 
-from libc.stdint cimport int64_t
+from libc.stdint cimport int64_t, uint32_t, uint64_t
 from libcpp cimport bool # access bool as bool
 from libcpp.string cimport string # access std::string as string
 from libc.string cimport memcpy
@@ -93,7 +93,7 @@ IF PRNG_CAN_JUMP:
 			# so we simply rename "operator=" for use in this file 
 			engine_c& assign "pqRand::engine::operator=" (const engine_c&)
 			
-			result_type operator()()
+			result_type operator()() nogil
 					
 			void Seed() except +
 			# Note, cython does not recognize 'string const&', my preferred way to declare variables,
@@ -109,10 +109,16 @@ IF PRNG_CAN_JUMP:
 			
 			bool RandBool()
 			real_t ApplyRandomSign(const real_t)
+			result_type RandBits(const size_t) except +
+			void FillBools(uint64_t*, const size_t) nogil
+			void ApplyRandomSigns(real_t*, const size_t) nogil
+			void Fill_U_even(real_t*, const size_t) nogil
+			void RecycleEntropy(const bool)
+			bool RecyclingEntropy()
 			
 			real_t U_uneven()
 			real_t HalfU_uneven()
-			real_t U_even()
+			real_t U_even() nogil
 			
 			void Jump()
 			vector[string] GetState_JumpVec(const size_t)
@@ -126,7 +132,7 @@ ELSE:
 			
 			engine_c& assign "pqRand::engine::operator=" (const engine_c&)
 			
-			result_type operator()()
+			result_type operator()() nogil
 					
 			void Seed() except +
 			void Seed_FromFile(const string&) except +
@@ -138,10 +144,25 @@ ELSE:
 			
 			bool RandBool()
 			real_t ApplyRandomSign(const real_t)
+			result_type RandBits(const size_t) except +
+			void FillBools(uint64_t*, const size_t) nogil
+			void ApplyRandomSigns(real_t*, const size_t) nogil
+			void Fill_U_even(real_t*, const size_t) nogil
+			void RecycleEntropy(const bool)
+			bool RecyclingEntropy()
 			
 			real_t U_uneven()
 			real_t HalfU_uneven()
-			real_t U_even()
+			real_t U_even() nogil
+			
+# The tier of the runtime-dispatched array kernels
+cdef extern from "pqRand.hpp" namespace "pqRand":
+	
+	cdef enum class isa_c "pqRand::isa":
+		baseline, avx2, avx512
+	
+	isa_c ActiveISA_c "pqRand::ActiveISA"()
+	const char* ISA_Name_c "pqRand::ISA_Name"(isa_c)
 			
 ########################################################################
 # declare distributions from distributions.hpp
@@ -160,8 +181,14 @@ cdef extern from "distributions.hpp" namespace "pqRand":
 		
 		real_t operator()(engine_c& gen) const
 		vector[real_t] GetSample(const size_t sampleSize, engine_c& gen) const
+		# Fill is declared nogil so we can release the GIL while sampling
+		void Fill(real_t* sample, const size_t sampleSize, engine_c& gen) nogil const
+		# Only defined when PRNG_CAN_JUMP (only used in that case)
+		void Fill_Parallel(real_t* sample, const size_t sampleSize, engine_c& gen, const size_t numThreads) nogil const
 		
 		real_t PDF(const real_t x) const
+		# The array overloads are nogil so we can release the GIL while evaluating
+		void PDF(const real_t* x, real_t* pdf, const size_t n) nogil const
 		real_t Mean() const
 		real_t Variance() const
 	
@@ -177,12 +204,22 @@ cdef extern from "distributions.hpp" namespace "pqRand":
 	cdef cppclass distributionCDF_c "pqRand::distributionCDF":
 		real_t CDF(const real_t x) const
 		real_t CompCDF(const real_t x) const
+		void CDF(const real_t* x, real_t* cdf, const size_t n) nogil const
+		void CompCDF(const real_t* x, real_t* ccdf, const size_t n) nogil const
 		
 	########################################################################
 	
 	cdef cppclass distributionQ2_c "pqRand::distributionQ2":
 		real_t Q_small(const real_t u) const
 		real_t Q_large(const real_t u) const
+		void Q_small(const real_t* u, real_t* x, const size_t n) nogil const
+		void Q_large(const real_t* u, real_t* x, const size_t n) nogil const
+		real_t SampleMax(const uint64_t n, engine_c& gen) except +
+		real_t SampleMin(const uint64_t n, engine_c& gen) except +
+		real_t SampleOrderStatistic(const uint64_t k, const uint64_t n, engine_c& gen) except +
+		void FillSorted(real_t* sample, const size_t sampleSize, engine_c& gen) nogil const
+		# Only defined when PRNG_CAN_JUMP (only used in that case)
+		void FillSorted_Parallel(real_t* sample, const size_t sampleSize, engine_c& gen, const size_t numThreads) nogil const
 			
 	########################################################################
 	# Now we declare the actual distributions, but only those functions
@@ -259,6 +296,12 @@ cdef extern from "distributions.hpp" namespace "pqRand":
 		real_t Lambda() const
 		real_t k() const
 		
+	cdef cppclass gammaDist_MarsagliaTsang_c "pqRand::gammaDist_MarsagliaTsang":
+		gammaDist_MarsagliaTsang_c(real_t const, real_t const) except +
+		
+		real_t Lambda() const
+		real_t k() const
+		
 	########################################################################
 	
 	cdef cppclass uniform_integer_c "pqRand::uniform_integer<int64_t>":
@@ -266,10 +309,88 @@ cdef extern from "distributions.hpp" namespace "pqRand":
 		
 		int64_t operator()(engine_c& gen) const
 		vector[int64_t] GetSample(const size_t sampleSize, engine_c& gen) const
+		void Fill(int64_t* sample, const size_t sampleSize, engine_c& gen) nogil const
+		# Only defined when PRNG_CAN_JUMP (only used in that case)
+		void Fill_Parallel(int64_t* sample, const size_t sampleSize, engine_c& gen, const size_t numThreads) nogil const
 		
 		int64_t min() const
 		int64_t max() const
 		
+	########################################################################
+	
+	cdef cppclass discrete_c "pqRand::discrete<uint32_t>":
+		discrete_c(const vector[real_t]& weights) except +
+		discrete_c(const vector[real_t]& weights, const string& filePath) except +
+		void Write(const vector[real_t]& weights, const string& filePath) except +
+		
+		uint32_t operator()(engine_c& gen) const
+		void Fill(uint32_t* sample, const size_t sampleSize, engine_c& gen) nogil const
+		# Only defined when PRNG_CAN_JUMP (only used in that case)
+		void Fill_Parallel(uint32_t* sample, const size_t sampleSize, engine_c& gen, const size_t numThreads) nogil const
+		
+		uint32_t min() const
+		uint32_t max() const
+		size_t Size() const
+		
+	########################################################################
+	
+	cdef cppclass dynamic_discrete_c "pqRand::dynamic_discrete<uint32_t>":
+		dynamic_discrete_c(const vector[real_t]& weights) except +
+		
+		uint32_t operator()(engine_c& gen) except + 
+		void Fill(uint32_t* sample, const size_t sampleSize, engine_c& gen) except +
+		
+		void Update(const uint32_t i, const real_t weight) except +
+		void Update(const uint32_t* indices, const real_t* newWeights, const size_t count) except +
+		
+		uint32_t min() const
+		uint32_t max() const
+		size_t Size() const
+		real_t Weight(const uint32_t i) except +
+		real_t Total() const
+		
+	########################################################################
+	
+	cdef cppclass poisson_c "pqRand::poisson":
+		poisson_c(const real_t mu) except +
+		
+		uint64_t operator()(engine_c& gen) const
+		void Fill(uint64_t* sample, const size_t sampleSize, engine_c& gen) nogil const
+		# Only defined when PRNG_CAN_JUMP (only used in that case)
+		void Fill_Parallel(uint64_t* sample, const size_t sampleSize, engine_c& gen, const size_t numThreads) nogil const
+		
+		real_t Mean() const
+		real_t Variance() const
+		real_t Mu() const
+		
+	########################################################################
+	
+	cdef cppclass bernoulli_c "pqRand::bernoulli":
+		bernoulli_c(const real_t p) except +
+		
+		bool operator()(engine_c& gen) const
+		void Fill(bool* sample, const size_t sampleSize, engine_c& gen) nogil const
+		void FillPacked(uint64_t* words, const size_t numTrials, engine_c& gen) nogil const
+		
+		real_t Mean() const
+		real_t Variance() const
+		real_t p() const
+		
+	########################################################################
+	
+	cdef cppclass binomial_c "pqRand::binomial":
+		binomial_c(const uint64_t n, const real_t p) except +
+		
+		uint64_t operator()(engine_c& gen) const
+		void Fill(uint64_t* sample, const size_t sampleSize, engine_c& gen) nogil const
+		# Only defined when PRNG_CAN_JUMP (only used in that case)
+		void Fill_Parallel(uint64_t* sample, const size_t sampleSize, engine_c& gen, const size_t numThreads) nogil const
+		
+		real_t Mean() const
+		real_t Variance() const
+		uint64_t n() const
+		real_t p() const
+		
 ########################################################################
 ########################################################################
 ########################################################################
@@ -299,40 +420,54 @@ else:
 		return s.decode()
 		
 ########################################################################		
-# We cannot directly steal the data from a std::vector and 
-# repackage it in a numpy.ndarray (like a std::move or swap),
-# at least not without using undefined or implementation-specific behavior
-# (hacking std::vector so it doesn't dellocate its data).
-# Instead, we use a standard, quick copy. This is MUCH faster than 
-# the automated version (return numpy.array(functionWhichReturnsStdVector()))
+# Samples are drawn directly into the buffer of a numpy.ndarray, via the C++ batch path
+# (distribution::Fill), so there is no intermediate std::vector to copy.
+# The array is either allocated here, or supplied by the user (the "out" argument of GetSample).
 
 cimport numpy
 import numpy
 
-cdef _CopyToNumpy(const vector[real_t]& stdVec):
-	# Using this "C API" for numpy is deprecated, as the compiler warns,
-	# but I don't know any alternative
-	cdef numpy.ndarray[double, ndim = 1, mode="c"] numpyVec = numpy.empty(stdVec.size())
-	cdef double* vec = <double*>numpyVec.data
-	
-	# The memcpy appears to the be no faster than the loop, and is less readable
-#~ 	memcpy(<void*>vec, <void*>stdVec.data(), stdVec.size()*sizeof(real_t))
-	for i in range(stdVec.size()):
-		vec[i] = stdVec[i]
-	return numpyVec
-	
-cdef _CopyToNumpy_int(const vector[int64_t]& stdVec):
-	# Using this "C API" for numpy is deprecated, as the compiler warns,
-	# but I don't know any alternative
-	cdef numpy.ndarray[int64_t, ndim = 1, mode="c"] numpyVec = numpy.empty(stdVec.size(), dtype=int) # This is the python int (aka int64_t)
-	cdef int64_t* vec = <int64_t*>numpyVec.data
-	
-	# The memcpy appears to the be no faster than the loop, and is less readable
-#~ 	memcpy(<void*>vec, <void*>stdVec.data(), stdVec.size()*sizeof(real_t))
-	for i in range(stdVec.size()):
-		vec[i] = stdVec[i]
-	return numpyVec
+# Initialize numpy's C-API (required before using any numpy.PyArray_* function)
+numpy.import_array()
+
+# The input of an array function (PDF, CDF, ...): x as a C-contiguous float64 array (copied only if necessary).
+# The functions return a new array of the same shape (like a numpy ufunc), 
+# evaluated by the C++ array overloads with the GIL released.
+cdef numpy.ndarray _ArrayIn(x):
+	return numpy.ascontiguousarray(x, dtype = numpy.float64)
+
+def ActiveISA():
+	'''Return the instruction-set tier of the array kernels ("baseline", "avx2" or "avx512"),
+	which is selected once per process (the environment variable PQR_ISA can select a lower tier).'''
+	return ISA_Name_c(ActiveISA_c()).decode()
+
+# Validate the threads argument of GetSample (None => serial, returned as 0)
+cdef size_t _NumThreads(threads) except? 0:
+	if threads is None:
+		return 0
+	IF not PRNG_CAN_JUMP:
+		raise ValueError("pYqRand: parallel sampling requires a PRNG which can Jump")
+	if threads < 0:
+		raise ValueError("pYqRand: threads must be non-negative")
+	return <size_t>threads
 
+cdef numpy.ndarray _SampleBuffer(sampleSize, out, dtype):
+	if (sampleSize < 0):
+		raise ValueError("sampleSize must be non-negative")
+	
+	if out is None:
+		return numpy.empty(<size_t>sampleSize, dtype = dtype)
+	
+	# We write straight into out's buffer, so it must be a contiguous block of the correct type
+	if not isinstance(out, numpy.ndarray):
+		raise TypeError("out must be a numpy.ndarray")
+	if (out.dtype != dtype) or (not out.flags.c_contiguous) or (not out.flags.writeable):
+		raise ValueError("out must be a writeable, C-contiguous numpy.ndarray of dtype " + numpy.dtype(dtype).name)
+	if (out.size != sampleSize):
+		raise ValueError("out.size must equal sampleSize")
+	
+	return out
+	
 ########################################################################		
 # First we declare the public pYqRand engine
 
@@ -472,6 +607,76 @@ cdef class engine:
 		'''Return the argument (float) with a random sign.'''
 		return self.c_engine.ApplyRandomSign(victim)
 	
+	def RecycleEntropy(self, bool recycle):
+		'''Turn entropy recycling on or off (off by default). When on, a uniform variate which finds 
+		the bit cache of RandBool empty reloads it with the unused low bits of its own random word, 
+		so coin flips (and random signs) rarely need a word of their own. This changes the stream, 
+		so the default stream is only reproduced with recycling off (the mode is not part of the state-string).'''
+		self.c_engine.RecycleEntropy(recycle)
+		
+	def RecyclingEntropy(self):
+		'''Return True if entropy recycling is on (see RecycleEntropy).'''
+		return self.c_engine.RecyclingEntropy()
+	
+	def RandBits(self, size_t numBits):
+		'''Return numBits random bits (at most 62) as an integer; they are the next numBits 
+		RandBool() would have returned (the first being the most significant bit).'''
+		return self.c_engine.RandBits(numBits)
+	
+	def GetBools(self, numBools):
+		'''
+		Return numBools random bools (the next numBools that RandBool() would have returned) as a packed bitset:
+		a numpy.ndarray of dtype uint64, where bool i is bit (i % 64) of word (i // 64) 
+		(unused bits of the last word are zero).
+		
+		Raises:
+			ValueError if numBools is negative'''
+		if numBools < 0:
+			raise ValueError("pYqRand.engine: numBools must be non-negative")
+		
+		cdef numpy.ndarray words = numpy.empty((numBools + 63) // 64, dtype = numpy.uint64)
+		
+		cdef uint64_t* data = <uint64_t*>numpy.PyArray_DATA(words)
+		cdef size_t size = <size_t>numBools
+		cdef engine_c* c_gen = self.c_engine
+		
+		with nogil:
+			c_gen.FillBools(data, size)
+		
+		return words
+		
+	def ApplyRandomSigns(self, victims):
+		'''
+		Give every element of victims (a writeable, C-contiguous numpy.ndarray of dtype float64) 
+		a random sign, in place, identical to calling ApplyRandomSign on each element in turn.
+		Returns victims.'''
+		cdef numpy.ndarray out = _SampleBuffer(numpy.size(victims), victims, numpy.float64)
+		
+		cdef real_t* data = <real_t*>numpy.PyArray_DATA(out)
+		cdef size_t size = <size_t>out.size
+		cdef engine_c* c_gen = self.c_engine
+		
+		with nogil:
+			c_gen.ApplyRandomSigns(data, size)
+		
+		return out
+	
+	def GetSample_U_even(self, sampleSize, out = None):
+		'''
+		Return sampleSize values of U_even (a numpy.ndarray of dtype float64), 
+		identical to calling U_even sampleSize times, but drawn in bulk. 
+		If out is supplied, it is filled and returned (see distribution.GetSample).'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.float64)
+		
+		cdef real_t* data = <real_t*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef engine_c* c_gen = self.c_engine
+		
+		with nogil:
+			c_gen.Fill_U_even(data, size)
+		
+		return sample
+	
 	def U_uneven(self):
 		'''Return a random real number from the uniform distribution U(0,1], rounded to the nearest float.'''
 		return self.c_engine.U_uneven()
@@ -485,6 +690,95 @@ cdef class engine:
 		EVENLY-spaced sample space (du = 2**-53).'''
 		return self.c_engine.U_even()
 		
+########################################################################		
+# numpy's BitGenerator interface (a "BitGenerator" capsule holding a bitgen_t),
+# so that numpy.random.Generator can draw from a pYqRand.engine.
+# numpy calls these C functions directly (without the GIL), 
+# so they only dereference the engine_c stored in bitgen_t.state.
+
+from libc.stdint cimport uint32_t, uint64_t
+from cpython.pycapsule cimport PyCapsule_New
+from numpy.random cimport bitgen_t
+
+cdef uint64_t _bitgen_next_uint64(void* state) noexcept nogil:
+	return deref(<engine_c*>state)()
+
+# The upper bits of xorshift1024* are its best bits
+cdef uint32_t _bitgen_next_uint32(void* state) noexcept nogil:
+	return <uint32_t>(deref(<engine_c*>state)() >> 32)
+
+cdef double _bitgen_next_double(void* state) noexcept nogil:
+	return (<engine_c*>state).U_even()
+
+cdef class bit_generator:
+	'''
+	bitGen = pqr.bit_generator(gen) ... wrap an engine for use by numpy.random.Generator
+	
+		rng = numpy.random.Generator(pqr.bit_generator(gen))
+		rng.permutation(10)
+	
+	numpy draws directly from the engine (without a Python call per draw):
+		next_uint64 => gen()
+		next_uint32 => the upper 32 bits of gen()
+		next_double => gen.U_even()
+	
+	The engine is shared, not copied, so drawing from the Generator advances gen
+	(and storing gen's state captures the Generator's state).
+	numpy serializes access through the lock attribute; 
+	do not use gen directly while another thread uses the Generator.'''
+	cdef bitgen_t _bitgen
+	cdef readonly engine gen # Keep the engine alive as long as numpy holds its capsule
+	cdef readonly object capsule
+	cdef readonly object lock
+	
+	def __cinit__(self, engine gen):
+		self.gen = gen
+		
+		self._bitgen.state = <void*>gen.c_engine
+		self._bitgen.next_uint64 = &_bitgen_next_uint64
+		self._bitgen.next_uint32 = &_bitgen_next_uint32
+		self._bitgen.next_double = &_bitgen_next_double
+		self._bitgen.next_raw = &_bitgen_next_uint64
+		
+		self.capsule = PyCapsule_New(<void*>&self._bitgen, "BitGenerator", NULL)
+		
+		import threading
+		self.lock = threading.Lock()
+		
+	def random_raw(self, size = None, output = True):
+		'''
+		Return raw 64-bit words from the engine (as numpy.uint64), 
+		filled without the GIL.
+		
+		Args:
+			   size: None (for one word) or the number of words
+			 output: if False, advance the engine without returning the words'''
+		cdef engine_c* c_gen = self.gen.c_engine
+		cdef bint keep = output
+		cdef size_t i, n
+		cdef uint64_t[::1] words
+		
+		if size is None:
+			with self.lock:
+				word = deref(c_gen)()
+			return numpy.uint64(word) if keep else None
+		
+		if (size < 0):
+			raise ValueError("size must be non-negative")
+		n = <size_t>size
+		words = numpy.empty(n if keep else 0, dtype = numpy.uint64)
+		
+		with self.lock:
+			with nogil:
+				if keep:
+					for i in range(n):
+						words[i] = deref(c_gen)()
+				else:
+					for i in range(n):
+						deref(c_gen)()
+		
+		return numpy.asarray(words) if keep else None
+		
 ########################################################################		
 # Next we declare Python objects wrapping the polymorphic distribution classes
 # These define the distribution interface, so that each Python object
@@ -511,11 +805,22 @@ cdef class _distributionPDF:
 		'''The maximum variate sampled.'''
 		return self.dist.max()
 	
-	# IMPORTANT: even though this is a python function, using "float"
-	# as x's type is not a Python float, but a C++ float (binary32).
-	def PDF(self, double x):
-		'''The probability distribution function (zero outside of [min, max]).'''
-		return self.dist.PDF(x)
+	def PDF(self, x):
+		'''The probability distribution function (zero outside of [min, max]).
+		
+		x may be a number (returning a float) or array-like (returning a numpy.ndarray of the same shape).'''
+		if numpy.ndim(x) == 0:
+			return self.dist.PDF(<double>x)
+		
+		cdef numpy.ndarray xArr = _ArrayIn(x)
+		cdef numpy.ndarray result = numpy.empty_like(xArr)
+		cdef real_t* in_ = <real_t*>numpy.PyArray_DATA(xArr)
+		cdef real_t* out = <real_t*>numpy.PyArray_DATA(result)
+		cdef size_t n = <size_t>xArr.size
+		
+		with nogil:
+			self.dist.PDF(in_, out, n)
+		return result
 		
 	def Mean(self):
 		'''The distribution's mean.'''
@@ -533,21 +838,45 @@ cdef class _distributionPDF:
 			gen (engine): a pYqRand.engine PRNG'''
 		return deref(self.dist)(deref(gen.c_engine))
 	
-	def GetSample(self, sampleSize, engine gen):
+	def GetSample(self, sampleSize, engine gen, out = None, threads = None):
 		'''
 		Sample many variates and return them in a numpy.ndarray
 		
 		Args:
 			  sampleSize: the number of variates to sample
 			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) a writeable, C-contiguous numpy.ndarray of dtype float64 
+			              (and size sampleSize) to fill in place (and return), instead of a new array
+			     threads: (optional) sample in parallel using this many threads (0 => all cores).
+			              The sample is split into blocks, each sampled from gen after a number of Jumps,
+			              so it is the same for any number of threads (but differs from threads = None).
+			              Afterwards, gen has been Jumped once per block.
+		
+		The variates are sampled directly into the array, with the GIL released 
+		(so do not use the same engine in another Python thread at the same time).
 			
 		Raises:
-			ValueError if sampleSize is negative'''
-		if (sampleSize < 0):
-			raise ValueError("sampleSize must be non-negative")
+			ValueError if sampleSize is negative, if out is not a valid output array,
+			or if threads is negative (or given when the PRNG cannot Jump)'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.float64)
+		
+		# Get the C++ pointers before releasing the GIL
+		cdef real_t* data = <real_t*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef distributionPDF_c* dist = self.dist
+		cdef engine_c* c_gen = gen.c_engine
+		
+		cdef size_t numThreads = _NumThreads(threads)
 		
-		# type cast in Cython using carrots
-		return _CopyToNumpy(self.dist.GetSample(<const size_t>sampleSize, deref(gen.c_engine)))
+		if threads is None:
+			with nogil:
+				dist.Fill(data, size, deref(c_gen))
+		else:
+			IF PRNG_CAN_JUMP:
+				with nogil:
+					dist.Fill_Parallel(data, size, deref(c_gen), numThreads)
+		
+		return sample
 		
 def MeanAndVariance(_distributionPDF distro, int sampleSize, engine gen):
 	'''
@@ -572,13 +901,37 @@ cdef class _distributionCDF(_distributionPDF):
 	def __cinit__(self):
 		return
 		
-	def CDF(self, double x):
-		'''The cumulative distribution function.'''
-		return  (<distributionCDF_c*> self.dist).CDF(x)
+	def CDF(self, x):
+		'''The cumulative distribution function (x may be a number or array-like, see PDF).'''
+		if numpy.ndim(x) == 0:
+			return (<distributionCDF_c*> self.dist).CDF(<double>x)
+		
+		cdef numpy.ndarray xArr = _ArrayIn(x)
+		cdef numpy.ndarray result = numpy.empty_like(xArr)
+		cdef real_t* in_ = <real_t*>numpy.PyArray_DATA(xArr)
+		cdef real_t* out = <real_t*>numpy.PyArray_DATA(result)
+		cdef size_t n = <size_t>xArr.size
+		cdef distributionCDF_c* dist = <distributionCDF_c*> self.dist
+		
+		with nogil:
+			dist.CDF(in_, out, n)
+		return result
 		
-	def CompCDF(self, double x):
+	def CompCDF(self, x):
 		'''The accurate complementary CDF (i.e. 1 - CDF(x), without cancellation).'''
-		return  (<distributionCDF_c*> self.dist).CompCDF(x)
+		if numpy.ndim(x) == 0:
+			return (<distributionCDF_c*> self.dist).CompCDF(<double>x)
+		
+		cdef numpy.ndarray xArr = _ArrayIn(x)
+		cdef numpy.ndarray result = numpy.empty_like(xArr)
+		cdef real_t* in_ = <real_t*>numpy.PyArray_DATA(xArr)
+		cdef real_t* out = <real_t*>numpy.PyArray_DATA(result)
+		cdef size_t n = <size_t>xArr.size
+		cdef distributionCDF_c* dist = <distributionCDF_c*> self.dist
+		
+		with nogil:
+			dist.CompCDF(in_, out, n)
+		return result
 		
 ########################################################################
 		
@@ -587,16 +940,99 @@ cdef class _distributionQ2(_distributionCDF):
 	def __cinit__(self):
 		return
 		
-	def Q_small(self, double u):
+	def Q_small(self, u):
 		'''The quantile function (the inverse of the CDF), which 
-		accurately samples the small-value tail (given \p u < 1/2).'''
-		return (<distributionQ2_c*> self.dist).Q_small(u)
+		accurately samples the small-value tail (given \p u < 1/2).
+		
+		u may be a number or array-like (see PDF).'''
+		if numpy.ndim(u) == 0:
+			return (<distributionQ2_c*> self.dist).Q_small(<double>u)
 		
-	def Q_large(self, double u):
+		cdef numpy.ndarray xArr = _ArrayIn(u)
+		cdef numpy.ndarray result = numpy.empty_like(xArr)
+		cdef real_t* in_ = <real_t*>numpy.PyArray_DATA(xArr)
+		cdef real_t* out = <real_t*>numpy.PyArray_DATA(result)
+		cdef size_t n = <size_t>xArr.size
+		cdef distributionQ2_c* dist = <distributionQ2_c*> self.dist
+		
+		with nogil:
+			dist.Q_small(in_, out, n)
+		return result
+		
+	def Q_large(self, u):
 		'''The complementary quantile function 
 		(the inverse of the Complementary CDF, by taking u -> 1 - u in Q_small),
 		which accurately samples the large-value tail (given \p u < 1/2).'''
-		return (<distributionQ2_c*> self.dist).Q_large(u)
+		if numpy.ndim(u) == 0:
+			return (<distributionQ2_c*> self.dist).Q_large(<double>u)
+		
+		cdef numpy.ndarray xArr = _ArrayIn(u)
+		cdef numpy.ndarray result = numpy.empty_like(xArr)
+		cdef real_t* in_ = <real_t*>numpy.PyArray_DATA(xArr)
+		cdef real_t* out = <real_t*>numpy.PyArray_DATA(result)
+		cdef size_t n = <size_t>xArr.size
+		cdef distributionQ2_c* dist = <distributionQ2_c*> self.dist
+		
+		with nogil:
+			dist.Q_large(in_, out, n)
+		return result
+		
+	def SampleMax(self, n, engine gen):
+		'''Sample the largest of n variates, in constant time (without sampling all n).
+		
+		Args:
+			         n: the number of variates
+			gen (engine): a pYqRand.engine PRNG
+		
+		Raises:
+			ValueError if n is zero.'''
+		return (<distributionQ2_c*> self.dist).SampleMax(<uint64_t>n, deref(gen.c_engine))
+		
+	def SampleMin(self, n, engine gen):
+		'''Sample the smallest of n variates, in constant time (see SampleMax).'''
+		return (<distributionQ2_c*> self.dist).SampleMin(<uint64_t>n, deref(gen.c_engine))
+		
+	def SampleOrderStatistic(self, k, n, engine gen):
+		'''Sample the k-th smallest of n variates (k = 1 is the minimum, k = n the maximum), 
+		in constant time (via a Beta(k, n - k + 1) variate of the CDF).
+		
+		Raises:
+			ValueError unless 1 <= k <= n.'''
+		return (<distributionQ2_c*> self.dist).SampleOrderStatistic(<uint64_t>k, <uint64_t>n, deref(gen.c_engine))
+		
+	def GetSortedSample(self, sampleSize, engine gen, out = None, threads = None):
+		'''
+		Sample many variates in ascending order (in O(sampleSize), without sorting)
+		and return them in a numpy.ndarray
+		
+		Args:
+			  sampleSize: the number of variates to sample
+			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) an output array, as in GetSample
+			     threads: (optional) sample in parallel using this many threads, as in GetSample
+			              (the sample is the same for any number of threads, but differs from threads = None)
+			
+		Raises:
+			ValueError as in GetSample'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.float64)
+		
+		# Get the C++ pointers before releasing the GIL
+		cdef real_t* data = <real_t*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef distributionQ2_c* dist = <distributionQ2_c*> self.dist
+		cdef engine_c* c_gen = gen.c_engine
+		
+		cdef size_t numThreads = _NumThreads(threads)
+		
+		if threads is None:
+			with nogil:
+				dist.FillSorted(data, size, deref(c_gen))
+		else:
+			IF PRNG_CAN_JUMP:
+				with nogil:
+					dist.FillSorted_Parallel(data, size, deref(c_gen), numThreads)
+		
+		return sample
 
 ########################################################################
 
@@ -853,6 +1289,40 @@ cdef class gammaDist(_distributionPDF):
 		'''The shape (how many exponentials are summed)'''
 		return (<gammaDist_c*> self.dist).k()
 		
+########################################################################	
+		
+cdef class gammaDist_MarsagliaTsang(_distributionPDF):
+	'''
+		gammaD = pqr.gammaDist_MarsagliaTsang(Lambda, k)
+			
+	An object which samples from a gamma distribution with rate Lambda 
+	and any shape k > 0, with PDF
+	
+		f(x) = Lambda**k x**(k-1) exp(-Lambda * x)/Gamma(k)      (x >= 0)
+		
+	Uses the rejection method of Marsaglia and Tsang (much faster than gammaDist).
+	When k < 1, shape (k + 1) is sampled, then boosted by U**(1/k).
+	
+	operator() caches variates, so give each thread its own object.
+		
+	Raises:
+		ValueError if (Lambda <= 0) or (k <= 0).'''
+		
+	def __cinit__(self, double lambda_in, double k_in):
+		self.dist = <distributionPDF_c*>(new gammaDist_MarsagliaTsang_c(lambda_in, k_in))
+		
+	def __str__(self):
+		return "gamma distribution (Marsaglia-Tsang) with rate Lambda = {:.2e} and shape k = {:.2e}".format(
+			self.Lambda(), self.k())
+		
+	def Lambda(self):
+		'''The rate'''
+		return (<gammaDist_MarsagliaTsang_c*> self.dist).Lambda()
+		
+	def k(self):
+		'''The shape'''
+		return (<gammaDist_MarsagliaTsang_c*> self.dist).k()
+		
 cdef class uniform_integer:
 	'''
 		uni_int = pqr.uniform_integer(min, max)
@@ -883,21 +1353,45 @@ cdef class uniform_integer:
 			gen (engine): a pYqRand.engine PRNG'''
 		return deref(self.dist)(deref(gen.c_engine))
 	
-	def GetSample(self, sampleSize, engine gen):
+	def GetSample(self, sampleSize, engine gen, out = None, threads = None):
 		'''
 		Sample many variates and return them in a numpy.ndarray
 		
 		Args:
 			  sampleSize: the number of variates to sample
 			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) a writeable, C-contiguous numpy.ndarray of dtype int64 
+			              (and size sampleSize) to fill in place (and return), instead of a new array
+			     threads: (optional) sample in parallel using this many threads (0 => all cores).
+			              The sample is split into blocks, each sampled from gen after a number of Jumps,
+			              so it is the same for any number of threads (but differs from threads = None).
+			              Afterwards, gen has been Jumped once per block.
+		
+		The variates are sampled directly into the array, with the GIL released 
+		(so do not use the same engine in another Python thread at the same time).
 			
 		Raises:
-			ValueError if sampleSize is negative'''
-		if (sampleSize < 0):
-			raise ValueError("sampleSize must be non-negative")
+			ValueError if sampleSize is negative, if out is not a valid output array,
+			or if threads is negative (or given when the PRNG cannot Jump)'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.int64)
+		
+		# Get the C++ pointers before releasing the GIL
+		cdef int64_t* data = <int64_t*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef uniform_integer_c* dist = self.dist
+		cdef engine_c* c_gen = gen.c_engine
 		
-		# type cast in Cython using carrots
-		return _CopyToNumpy_int(self.dist.GetSample(<const size_t>sampleSize, deref(gen.c_engine)))
+		cdef size_t numThreads = _NumThreads(threads)
+		
+		if threads is None:
+			with nogil:
+				dist.Fill(data, size, deref(c_gen))
+		else:
+			IF PRNG_CAN_JUMP:
+				with nogil:
+					dist.Fill_Parallel(data, size, deref(c_gen), numThreads)
+		
+		return sample
 		
 	def min(self):
 		'''The minimum variate sampled.'''
@@ -906,3 +1400,484 @@ cdef class uniform_integer:
 	def max(self):
 		'''One past the maximum variate sampled.'''
 		return self.dist.max()
+
+########################################################################
+
+cdef class discrete:
+	'''
+		disc = pqr.discrete(weights)
+		disc = pqr.discrete(weights, filePath)
+			
+	An object which samples the index of a category (0, 1, ..., len(weights) - 1)
+	with a probability proportional to its weight, in constant time 
+	(via Vose's alias table, which is built once from the weights).
+	
+	Given a filePath, the table is memory-mapped (read-only) from that file
+	if it holds the table of these weights; otherwise the table is built 
+	and written to the file (so later jobs with the same weights skip the build).
+		
+	Raises:
+		ValueError if weights is empty, has more than 2**32 - 1 categories,
+		has any negative or non-finite weight, or sums to zero.
+		OSError if the table must be written to filePath, but cannot be.'''
+	
+	cdef discrete_c* dist
+	
+	def __cinit__(self, weights, filePath = None):
+		cdef vector[real_t] c_weights = numpy.ascontiguousarray(weights, dtype = numpy.float64).ravel()
+		
+		if filePath is None:
+			self.dist = new discrete_c(c_weights)
+		else:
+			self.dist = new discrete_c(c_weights, _str2string(filePath))
+		
+	def __dealloc__(self):
+		del self.dist
+		
+	def __str__(self):
+		return "discrete distribution over {} categories".format(self.Size())
+		
+	def __call__(self, engine gen):
+		'''
+		Sample one variate by supplying a pYqRand.engine.
+		
+		Args:
+			gen (engine): a pYqRand.engine PRNG'''
+		return deref(self.dist)(deref(gen.c_engine))
+	
+	def GetSample(self, sampleSize, engine gen, out = None, threads = None):
+		'''
+		Sample many variates and return them in a numpy.ndarray
+		
+		Args:
+			  sampleSize: the number of variates to sample
+			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) a writeable, C-contiguous numpy.ndarray of dtype uint32 
+			              (and size sampleSize) to fill in place (and return), instead of a new array
+			     threads: (optional) sample in parallel using this many threads (0 => all cores).
+			              The sample is split into blocks, each sampled from gen after a number of Jumps,
+			              so it is the same for any number of threads (but differs from threads = None).
+			              Afterwards, gen has been Jumped once per block.
+		
+		The variates are sampled directly into the array, with the GIL released 
+		(so do not use the same engine in another Python thread at the same time).
+			
+		Raises:
+			ValueError if sampleSize is negative, if out is not a valid output array,
+			or if threads is negative (or given when the PRNG cannot Jump)'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.uint32)
+		
+		# Get the C++ pointers before releasing the GIL
+		cdef uint32_t* data = <uint32_t*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef discrete_c* dist = self.dist
+		cdef engine_c* c_gen = gen.c_engine
+		
+		cdef size_t numThreads = _NumThreads(threads)
+		
+		if threads is None:
+			with nogil:
+				dist.Fill(data, size, deref(c_gen))
+		else:
+			IF PRNG_CAN_JUMP:
+				with nogil:
+					dist.Fill_Parallel(data, size, deref(c_gen), numThreads)
+		
+		return sample
+		
+	def min(self):
+		'''The minimum variate sampled.'''
+		return self.dist.min()
+		
+	def max(self):
+		'''The maximum variate sampled (the last category).'''
+		return self.dist.max()
+		
+	def Size(self):
+		'''The number of categories.'''
+		return self.dist.Size()
+		
+	def Write(self, weights, str filePath):
+		'''Write the alias table to a file (replacing it if it already exists), 
+		which pqr.discrete(weights, filePath) then maps instead of building the table.
+		The table does not keep its weights, so pass the weights it was built from (they key the file).
+		
+		Raises:
+			ValueError if the table was not built from these weights.
+			OSError if the file cannot be written.'''
+		cdef vector[real_t] c_weights = numpy.ascontiguousarray(weights, dtype = numpy.float64).ravel()
+		self.dist.Write(c_weights, _str2string(filePath))
+
+########################################################################
+
+cdef class dynamic_discrete:
+	'''
+		dyn = pqr.dynamic_discrete(weights)
+			
+	An object which samples the index of a category (0, 1, ..., len(weights) - 1)
+	with a probability proportional to its weight, where the weights can be 
+	changed between draws (via Update). Sampling and updating a weight are both O(log n).
+		
+	Raises:
+		ValueError if weights is empty, has more than 2**32 - 1 categories,
+		or has any negative or non-finite weight.'''
+	
+	cdef dynamic_discrete_c* dist
+	
+	def __cinit__(self, weights):
+		self.dist = new dynamic_discrete_c(numpy.ascontiguousarray(weights, dtype = numpy.float64).ravel())
+		
+	def __dealloc__(self):
+		del self.dist
+		
+	def __str__(self):
+		return "dynamic discrete distribution over {} categories".format(self.Size())
+		
+	def __call__(self, engine gen):
+		'''
+		Sample one variate by supplying a pYqRand.engine.
+		
+		Args:
+			gen (engine): a pYqRand.engine PRNG
+			
+		Raises:
+			ValueError if every weight is zero'''
+		return deref(self.dist)(deref(gen.c_engine))
+	
+	def GetSample(self, sampleSize, engine gen, out = None):
+		'''
+		Sample many variates and return them in a numpy.ndarray
+		
+		Args:
+			  sampleSize: the number of variates to sample
+			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) a writeable, C-contiguous numpy.ndarray of dtype uint32 
+			              (and size sampleSize) to fill in place (and return), instead of a new array
+			
+		Raises:
+			ValueError if sampleSize is negative, if out is not a valid output array,
+			or if every weight is zero'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.uint32)
+		
+		self.dist.Fill(<uint32_t*>numpy.PyArray_DATA(sample), <size_t>sample.size, deref(gen.c_engine))
+		
+		return sample
+		
+	def Update(self, index, weight):
+		'''
+		Change the weight of category index (or, when index and weight are arrays 
+		of the same size, change the weight of every category in index).
+		
+		Raises:
+			ValueError if an index is out of bounds, or a weight is negative or non-finite
+			(in which case no weight is changed)'''
+		if numpy.ndim(index) == 0:
+			self.dist.Update(<uint32_t>index, <real_t>weight)
+			return
+		
+		cdef numpy.ndarray indices = numpy.ascontiguousarray(index, dtype = numpy.uint32).ravel()
+		cdef numpy.ndarray newWeights = numpy.ascontiguousarray(weight, dtype = numpy.float64).ravel()
+		
+		if indices.size != newWeights.size:
+			raise ValueError("pYqRand.dynamic_discrete: there must be one weight per index")
+		
+		self.dist.Update(<uint32_t*>numpy.PyArray_DATA(indices), 
+			<real_t*>numpy.PyArray_DATA(newWeights), <size_t>indices.size)
+		
+	def Weight(self, index):
+		'''The weight of category index.'''
+		return self.dist.Weight(index)
+		
+	def Total(self):
+		'''The sum of the weights.'''
+		return self.dist.Total()
+		
+	def min(self):
+		'''The minimum variate sampled.'''
+		return self.dist.min()
+		
+	def max(self):
+		'''The maximum variate sampled (the last category).'''
+		return self.dist.max()
+		
+	def Size(self):
+		'''The number of categories.'''
+		return self.dist.Size()
+
+########################################################################
+
+cdef class poisson:
+	'''
+		pois = pqr.poisson(mu)
+			
+	An object which samples from a Poisson distribution with mean mu, with PMF
+	
+		P(k) = mu**k exp(-mu) / k!      (k = 0, 1, 2, ...)
+		
+	Small means are sampled by inversion of a table, large means by 
+	transformed rejection (PTRS); both sample the far tails precisely.
+		
+	Raises:
+		ValueError if mu is not positive and finite.'''
+	
+	cdef poisson_c* dist
+	
+	def __cinit__(self, double mu):
+		self.dist = new poisson_c(mu)
+		
+	def __dealloc__(self):
+		del self.dist
+		
+	def __str__(self):
+		return "Poisson distribution with mean mu = {:.2e}".format(self.Mu())
+		
+	def __call__(self, engine gen):
+		'''
+		Sample one variate by supplying a pYqRand.engine.
+		
+		Args:
+			gen (engine): a pYqRand.engine PRNG'''
+		return deref(self.dist)(deref(gen.c_engine))
+	
+	def GetSample(self, sampleSize, engine gen, out = None, threads = None):
+		'''
+		Sample many variates and return them in a numpy.ndarray
+		
+		Args:
+			  sampleSize: the number of variates to sample
+			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) a writeable, C-contiguous numpy.ndarray of dtype uint64 
+			              (and size sampleSize) to fill in place (and return), instead of a new array
+			     threads: (optional) sample in parallel using this many threads (0 => all cores).
+			              The sample is split into blocks, each sampled from gen after a number of Jumps,
+			              so it is the same for any number of threads (but differs from threads = None).
+			              Afterwards, gen has been Jumped once per block.
+		
+		The variates are sampled directly into the array, with the GIL released 
+		(so do not use the same engine in another Python thread at the same time).
+			
+		Raises:
+			ValueError if sampleSize is negative, if out is not a valid output array,
+			or if threads is negative (or given when the PRNG cannot Jump)'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.uint64)
+		
+		# Get the C++ pointers before releasing the GIL
+		cdef uint64_t* data = <uint64_t*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef poisson_c* dist = self.dist
+		cdef engine_c* c_gen = gen.c_engine
+		
+		cdef size_t numThreads = _NumThreads(threads)
+		
+		if threads is None:
+			with nogil:
+				dist.Fill(data, size, deref(c_gen))
+		else:
+			IF PRNG_CAN_JUMP:
+				with nogil:
+					dist.Fill_Parallel(data, size, deref(c_gen), numThreads)
+		
+		return sample
+		
+	def Mean(self):
+		'''The mean of the distribution.'''
+		return self.dist.Mean()
+		
+	def Variance(self):
+		'''The variance of the distribution.'''
+		return self.dist.Variance()
+		
+	def Mu(self):
+		'''The mean'''
+		return self.dist.Mu()
+		
+########################################################################
+
+cdef class binomial:
+	'''
+		binom = pqr.binomial(n, p)
+			
+	An object which samples from a binomial distribution (the number of successes 
+	in n trials, each with success probability p), with PMF
+	
+		P(k) = (n choose k) p**k (1 - p)**(n - k)      (k = 0, 1, ..., n)
+		
+	Small means are sampled by inversion of a table, large means by 
+	transformed rejection (BTRS); both sample the far tails precisely.
+		
+	Raises:
+		ValueError if p is not in [0, 1].'''
+	
+	cdef binomial_c* dist
+	
+	def __cinit__(self, uint64_t n, double p):
+		self.dist = new binomial_c(n, p)
+		
+	def __dealloc__(self):
+		del self.dist
+		
+	def __str__(self):
+		return "binomial distribution with n = {} trials and success probability p = {:.2e}".format(
+			self.n(), self.p())
+		
+	def __call__(self, engine gen):
+		'''
+		Sample one variate by supplying a pYqRand.engine.
+		
+		Args:
+			gen (engine): a pYqRand.engine PRNG'''
+		return deref(self.dist)(deref(gen.c_engine))
+	
+	def GetSample(self, sampleSize, engine gen, out = None, threads = None):
+		'''
+		Sample many variates and return them in a numpy.ndarray
+		
+		Args:
+			  sampleSize: the number of variates to sample
+			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) a writeable, C-contiguous numpy.ndarray of dtype uint64 
+			              (and size sampleSize) to fill in place (and return), instead of a new array
+			     threads: (optional) sample in parallel using this many threads (0 => all cores).
+			              The sample is split into blocks, each sampled from gen after a number of Jumps,
+			              so it is the same for any number of threads (but differs from threads = None).
+			              Afterwards, gen has been Jumped once per block.
+		
+		The variates are sampled directly into the array, with the GIL released 
+		(so do not use the same engine in another Python thread at the same time).
+			
+		Raises:
+			ValueError if sampleSize is negative, if out is not a valid output array,
+			or if threads is negative (or given when the PRNG cannot Jump)'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.uint64)
+		
+		# Get the C++ pointers before releasing the GIL
+		cdef uint64_t* data = <uint64_t*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef binomial_c* dist = self.dist
+		cdef engine_c* c_gen = gen.c_engine
+		
+		cdef size_t numThreads = _NumThreads(threads)
+		
+		if threads is None:
+			with nogil:
+				dist.Fill(data, size, deref(c_gen))
+		else:
+			IF PRNG_CAN_JUMP:
+				with nogil:
+					dist.Fill_Parallel(data, size, deref(c_gen), numThreads)
+		
+		return sample
+		
+	def Mean(self):
+		'''The mean of the distribution.'''
+		return self.dist.Mean()
+		
+	def Variance(self):
+		'''The variance of the distribution.'''
+		return self.dist.Variance()
+		
+	def n(self):
+		'''The number of trials'''
+		return self.dist.n()
+		
+	def p(self):
+		'''The probability of success'''
+		return self.dist.p()
+
+########################################################################
+
+cdef class bernoulli:
+	'''
+		coin = pqr.bernoulli(p)
+			
+	An object which samples Bernoulli trials (True with probability p),
+	using about 2 random bits per trial (by comparing random bits to the bits of p).
+		
+	Raises:
+		ValueError if p is not in [0, 1].'''
+	
+	cdef bernoulli_c* dist
+	
+	def __cinit__(self, double p):
+		self.dist = new bernoulli_c(p)
+		
+	def __dealloc__(self):
+		del self.dist
+		
+	def __str__(self):
+		return "Bernoulli distribution with p = {:.2e}".format(self.p())
+		
+	def __call__(self, engine gen):
+		'''
+		Run one trial by supplying a pYqRand.engine.
+		
+		Args:
+			gen (engine): a pYqRand.engine PRNG'''
+		return deref(self.dist)(deref(gen.c_engine))
+	
+	def GetSample(self, sampleSize, engine gen, out = None):
+		'''
+		Run many trials and return them in a numpy.ndarray of dtype bool
+		
+		Args:
+			  sampleSize: the number of trials
+			gen (engine): a pYqRand.engine PRNG
+			         out: (optional) a writeable, C-contiguous numpy.ndarray of dtype bool 
+			              (and size sampleSize) to fill in place (and return), instead of a new array
+		
+		The trials are run directly into the array, with the GIL released 
+		(so do not use the same engine in another Python thread at the same time).
+			
+		Raises:
+			ValueError if sampleSize is negative, or if out is not a valid output array'''
+		cdef numpy.ndarray sample = _SampleBuffer(sampleSize, out, numpy.bool_)
+		
+		# Get the C++ pointers before releasing the GIL
+		cdef bool* data = <bool*>numpy.PyArray_DATA(sample)
+		cdef size_t size = <size_t>sample.size
+		cdef bernoulli_c* dist = self.dist
+		cdef engine_c* c_gen = gen.c_engine
+		
+		with nogil:
+			dist.Fill(data, size, deref(c_gen))
+		
+		return sample
+		
+	def GetPacked(self, numTrials, engine gen):
+		'''
+		Run many trials and return them as a packed bitset: a numpy.ndarray of dtype uint64,
+		where trial i is bit (i % 64) of word (i // 64) (unused bits of the last word are zero).
+		Use numpy.unpackbits(words.view(numpy.uint8), bitorder = "little") to unpack (on little-endian machines).
+		
+		Args:
+			   numTrials: the number of trials
+			gen (engine): a pYqRand.engine PRNG
+			
+		Raises:
+			ValueError if numTrials is negative'''
+		if numTrials < 0:
+			raise ValueError("pYqRand.bernoulli: numTrials must be non-negative")
+		
+		cdef numpy.ndarray words = numpy.empty((numTrials + 63) // 64, dtype = numpy.uint64)
+		
+		cdef uint64_t* data = <uint64_t*>numpy.PyArray_DATA(words)
+		cdef size_t size = <size_t>numTrials
+		cdef bernoulli_c* dist = self.dist
+		cdef engine_c* c_gen = gen.c_engine
+		
+		with nogil:
+			dist.FillPacked(data, size, deref(c_gen))
+		
+		return words
+		
+	def Mean(self):
+		'''The mean of the distribution.'''
+		return self.dist.Mean()
+		
+	def Variance(self):
+		'''The variance of the distribution.'''
+		return self.dist.Variance()
+		
+	def p(self):
+		'''The probability of True'''
+		return self.dist.p()
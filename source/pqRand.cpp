@@ -26,6 +26,62 @@
 #include <assert.h>
 #include <sstream>
 #include <random> // random_device, mt19937
+#include <cstring> // memcpy
+#include <algorithm> // copy
+#include <type_traits> // conditional
+#include <cstdlib> // getenv
+#include "dispatch.hpp"
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// The best tier the CPU (and OS) supports
+static pqRand::isa SupportedISA()
+{
+	#if PQR_CAN_DISPATCH
+		__builtin_cpu_init(); // In case we're called before libgcc's constructors
+
+		if(__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512dq")
+			and __builtin_cpu_supports("avx512vl"))
+			return pqRand::isa::avx512;
+		else if(__builtin_cpu_supports("avx2"))
+			return pqRand::isa::avx2;
+	#endif
+	return pqRand::isa::baseline;
+}
+
+// Select the tier (once); PQR_ISA can only select a tier the CPU supports
+static pqRand::isa SelectISA()
+{
+	pqRand::isa const supported = SupportedISA();
+	char const* const request = std::getenv("PQR_ISA");
+
+	if(request)
+	{
+		for(pqRand::isa const tier : {pqRand::isa::baseline, pqRand::isa::avx2, pqRand::isa::avx512})
+		{
+			if(std::strcmp(request, pqRand::ISA_Name(tier)) == 0)
+				return (tier < supported) ? tier : supported;
+		}
+	}
+	return supported;
+}
+
+pqRand::isa pqRand::ActiveISA()
+{
+	static isa const active = SelectISA(); // Thread-safe, and only once
+	return active;
+}
+
+char const* pqRand::ISA_Name(isa const tier)
+{
+	switch(tier)
+	{
+		case isa::avx512: return "avx512";
+		case isa::avx2: return "avx2";
+		default: return "baseline";
+	}
+}
 
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
@@ -173,6 +229,21 @@ uint64_t pqRand::xorshift1024_star::operator()()
 	return s1 * 0x9e3779b97f4a7c13;
 }
 
+void pqRand::xorshift1024_star::Fill(uint64_t* const words, size_t const numWords)
+{
+	// operator() with s0 kept in a register; state[p] always equals the last s1
+	uint64_t s0 = state[p];
+	
+	for(size_t i = 0; i < numWords; ++i)
+	{
+		uint64_t s1 = state[p = (p + 1) & 15];
+		s1 ^= s1 << 31; // a
+		s1 = s1 ^ s0 ^ (s1 >> 11) ^ (s0 >> 30); // b,c
+		state[p] = s0 = s1;
+		words[i] = s1 * 0x9e3779b97f4a7c13;
+	}
+}
+
 void pqRand::xorshift1024_star::Jump()
 {
 	static constexpr uint64_t JUMP[] = { 0x84242f96eca9c41d,
@@ -263,12 +334,18 @@ template class pqRand::seeded_uPRNG<pqRand::PRNG_t>;
 ////////////////////////////////////////////////////////////////////////
 
 // When randUint does not have enough entropy, we make sure it has P+2 bits
-typename pqRand::real_t pqRand::engine::U_uneven_TopUpEntropy(result_type randUint)
+template<class prng_t>
+typename pqRand::real_t pqRand::basic_engine<prng_t>::U_uneven_TopUpEntropy(result_type randUint)
 {
 	// downScale reverses the leftward shift, so the uniform variate doesn't move
 	// We need to shift randUint left at least once, so we start with that
 	
 	real_t downScale = real_t(0.5) * scaleToU_uneven;
+	
+	#if PQR_ENGINE_STATS
+	++stats.topUps;
+	#endif
+	
 	{
 		size_t shiftLeft = 1; // Must use signed type, for negative exponent in exp2()
 		randUint <<= 1;
@@ -281,7 +358,12 @@ typename pqRand::real_t pqRand::engine::U_uneven_TopUpEntropy(result_type randUi
 			// ... every time we draw a zero, do a 64-bit leftward shift.
 			// It's like we have an infinite bit stream which we keep shifting left
 			do // We already drew one zero, so we have to downscale at least once
+			{
+				#if PQR_ENGINE_STATS
+				++stats.zeroWords;
+				#endif
 				downScale *= scaleToU_uneven;
+			}
 			while((randUint = (*this)()) == 0);
 		}
 		
@@ -313,10 +395,11 @@ typename pqRand::real_t pqRand::engine::U_uneven_TopUpEntropy(result_type randUi
 
 ////////////////////////////////////////////////////////////////////////
 
-void pqRand::engine::Seed_FromStream(std::istream& stream)
+template<class prng_t>
+void pqRand::basic_engine<prng_t>::Seed_FromStream(std::istream& stream)
 {
 	// Seed the base class, advancing the stream
-	seeded_uPRNG<PRNG_t>::Seed_FromStream(stream);
+	seeded_uPRNG<prng_t>::Seed_FromStream(stream);
 		
 	// The internal state of pqRand_engine contains the bitCache,
 	// which should be appended to the seed stream after PRNG details
@@ -341,10 +424,11 @@ void pqRand::engine::Seed_FromStream(std::istream& stream)
 
 ////////////////////////////////////////////////////////////////////////
 
-void pqRand::engine::WriteState_ToStream(std::ostream& stream)
+template<class prng_t>
+void pqRand::basic_engine<prng_t>::WriteState_ToStream(std::ostream& stream)
 {
 	// Write out the state of the underlying PRNG
-	seeded_uPRNG<PRNG_t>::WriteState_ToStream(stream);
+	seeded_uPRNG<prng_t>::WriteState_ToStream(stream);
 	
 	// Now write out the state of the bitCache and the cacheMask
 	stream  << " " <<  bitCache << " " << cacheMask;
@@ -352,7 +436,8 @@ void pqRand::engine::WriteState_ToStream(std::ostream& stream)
 
 ////////////////////////////////////////////////////////////////////////
 
-void pqRand::engine::DefaultInitializeBitCache()
+template<class prng_t>
+void pqRand::basic_engine<prng_t>::DefaultInitializeBitCache()
 {
 	// By setting cacheMask to this value, we ensure that the next call to RandBool()
 	// will induce the bitCache to be replenished and reset.
@@ -364,7 +449,8 @@ void pqRand::engine::DefaultInitializeBitCache()
 
 ////////////////////////////////////////////////////////////////////////
 
-bool pqRand::engine::RandBool()
+template<class prng_t>
+bool pqRand::basic_engine<prng_t>::RandBool()
 {
 	// The cacheMask starts at the leftmost bit and moves right
 	if(cacheMask == replenishBitCache)
@@ -372,9 +458,306 @@ bool pqRand::engine::RandBool()
 		// When the cacheMask has moved too far right ... 
 		bitCache = (*this)(); // Get a new set of random bits
 		cacheMask = (result_type(1) << (numBitsPRNG - 1)); // Reset the cacheMask
+		
+		#if PQR_ENGINE_STATS
+		++stats.bitCacheRefills;
+		#endif
 	}
 	
+	#if PQR_ENGINE_STATS
+	++stats.bitsUsed;
+	#endif
+	
 	bool const decision = bool(cacheMask bitand bitCache);
 	cacheMask >>= 1;
 	return decision;
 }
+
+////////////////////////////////////////////////////////////////////////
+
+template<class prng_t>
+typename pqRand::basic_engine<prng_t>::result_type pqRand::basic_engine<prng_t>::RandBits(size_t const numBits)
+{
+	if(numBits > maxRandBits)
+		throw std::domain_error("pqRand::engine::RandBits: cannot draw more than maxRandBits at once!");
+
+	result_type bits = 0;
+	size_t needed = numBits;
+
+	// Take the bits in the same order as RandBool (from the cacheMask rightward),
+	// as many as the bitCache still holds, then replenish it (exactly as RandBool does).
+	while(needed)
+	{
+		if(cacheMask == replenishBitCache)
+		{
+			bitCache = (*this)();
+			cacheMask = (result_type(1) << (numBitsPRNG - 1));
+
+			#if PQR_ENGINE_STATS
+			++stats.bitCacheRefills;
+			#endif
+		}
+
+		// cacheMask has a single bit set, and the bits [badBits, position] are still unused
+		size_t const position = size_t(__builtin_ctzll(cacheMask));
+		size_t const available = position + 1 - size_t(badBits);
+		size_t const taken = (needed < available) ? needed : available;
+
+		result_type const chunk = (bitCache >> (position + 1 - taken)) bitand
+			(compl result_type(0) >> (numBitsPRNG - taken));
+
+		// (taken == numBitsPRNG) is only possible when (badBits == 0), in one step
+		bits = (taken < numBitsPRNG) ? ((bits << taken) bitor chunk) : chunk;
+		cacheMask >>= taken;
+		needed -= taken;
+	}
+
+	#if PQR_ENGINE_STATS
+	stats.bitsUsed += numBits;
+	#endif
+
+	return bits;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Reverse the order of the 64 bits
+static inline uint64_t ReverseBits(uint64_t x)
+{
+	x = ((x >> 1) bitand 0x5555555555555555) bitor ((x bitand 0x5555555555555555) << 1);
+	x = ((x >> 2) bitand 0x3333333333333333) bitor ((x bitand 0x3333333333333333) << 2);
+	x = ((x >> 4) bitand 0x0F0F0F0F0F0F0F0F) bitor ((x bitand 0x0F0F0F0F0F0F0F0F) << 4);
+	return __builtin_bswap64(x);
+}
+
+template<class prng_t>
+void pqRand::basic_engine<prng_t>::FillBools(uint64_t* const words, size_t const numBools)
+{
+	static_assert(maxRandBits >= 32, "pqRand::engine::FillBools assumes at least 32 good bits per word");
+
+	size_t const numFull = numBools / 64;
+
+	// RandBits puts the first bool in the most significant bit;
+	// reverse them so that the first bool is the least significant bit.
+	for(size_t i = 0; i < numFull; ++i)
+	{
+		uint64_t const high = RandBits(32);
+		words[i] = ReverseBits((high << 32) bitor RandBits(32));
+	}
+
+	size_t const remainder = numBools % 64;
+	if(remainder)
+	{
+		uint64_t const high = RandBits(remainder / 2);
+		size_t const numLow = remainder - remainder / 2;
+		uint64_t const packed = (high << numLow) bitor RandBits(numLow);
+
+		// Left-align the remainder before reversing it
+		words[numFull] = ReverseBits(packed << (64 - remainder));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// The sign bit of real_t, as an unsigned integer of the same size
+typedef std::conditional<sizeof(pqRand::real_t) == sizeof(uint64_t), uint64_t, uint32_t>::type realBits_t;
+static_assert(sizeof(pqRand::real_t) == sizeof(realBits_t), "pqRand: real_t must be 32 or 64 bits");
+
+// XOR the signs into the sign bits of chunk. Each word of signs holds the signs of (up to) bitsPerWord 
+// consecutive variates, the first in its most significant used bit (as returned by RandBits).
+PQR_ALWAYS_INLINE void SignsKernel(pqRand::real_t* const chunk, size_t const count, 
+	uint64_t const* const signs, size_t const bitsPerWord)
+{
+	size_t static constexpr signShift = 8 * sizeof(realBits_t) - 1;
+	
+	for(size_t begin = 0, w = 0; begin < count; begin += bitsPerWord, ++w)
+	{
+		size_t const n = ((count - begin) < bitsPerWord) ? (count - begin) : bitsPerWord;
+		
+		// memcpy is the defined way to access the bits of a real_t (and compiles to nothing).
+		for(size_t i = 0; i < n; ++i)
+		{
+			realBits_t victim;
+			std::memcpy(&victim, chunk + begin + i, sizeof(realBits_t));
+			victim xor_eq realBits_t((signs[w] >> (n - 1 - i)) bitand 1) << signShift;
+			std::memcpy(chunk + begin + i, &victim, sizeof(realBits_t));
+		}
+	}
+}
+
+PQR_DEFINE_TIERS(SignsKernel, SignsKernel, 
+	(pqRand::real_t* const chunk, size_t const count, uint64_t const* const signs, size_t const bitsPerWord), 
+	(chunk, count, signs, bitsPerWord))
+
+template<class prng_t>
+void pqRand::basic_engine<prng_t>::ApplyRandomSigns(real_t* const victims, size_t const numVictims)
+{
+	// Draw the signs of a whole chunk first, then dispatch once per chunk
+	size_t static constexpr chunkWords = 16;
+	size_t static constexpr chunkSize = chunkWords * maxRandBits;
+	uint64_t signs[chunkWords];
+	
+	for(size_t begin = 0; begin < numVictims; begin += chunkSize)
+	{
+		size_t const count = ((numVictims - begin) < chunkSize) ? (numVictims - begin) : chunkSize;
+		
+		for(size_t drawn = 0, w = 0; drawn < count; drawn += maxRandBits, ++w)
+			signs[w] = RandBits(((count - drawn) < maxRandBits) ? (count - drawn) : size_t(maxRandBits));
+		
+		PQR_DISPATCH(SignsKernel, (victims + begin, count, signs, size_t(maxRandBits)))
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+// Convert each word to an even uniform variate (the kernel of U_even).
+// AVX2 cannot convert 64-bit integers to double, so for double we build the variate exactly
+// with integer operations: the low 52 bits of (word >> shift) become the mantissa of 2^52 + low,
+// and the top bit (worth 2^52) is added back as either 0 or 2^52 (every step is exact).
+PQR_ALWAYS_INLINE void U_evenKernel(uint64_t const* const words, pqRand::real_t* const sample, 
+	size_t const n, size_t const shift, pqRand::real_t const scale)
+{
+	if(std::is_same<pqRand::real_t, double>::value and (64 - shift == 53))
+	{
+		uint64_t static constexpr twoTo52_bits = 0x4330000000000000; // 2^52
+		uint64_t static constexpr lowMask = (uint64_t(1) << 52) - 1;
+		double static constexpr twoTo52 = 4503599627370496.;
+		
+		for(size_t i = 0; i < n; ++i)
+		{
+			uint64_t const mantissa = words[i] >> shift;
+			uint64_t const lowBits = (mantissa bitand lowMask) bitor twoTo52_bits;
+			uint64_t const highBits = (mantissa >> 52) * twoTo52_bits; // 0 or 2^52
+			
+			double low, high;
+			std::memcpy(&low, &lowBits, sizeof(double));
+			std::memcpy(&high, &highBits, sizeof(double));
+			
+			sample[i] = pqRand::real_t(scale * ((low - twoTo52) + high));
+		}
+	}
+	else
+	{
+		for(size_t i = 0; i < n; ++i)
+			sample[i] = scale * pqRand::real_t(words[i] >> shift);
+	}
+}
+
+PQR_DEFINE_TIERS(U_evenKernel, U_evenKernel, 
+	(uint64_t const* const words, pqRand::real_t* const sample, size_t const n, size_t const shift, pqRand::real_t const scale), 
+	(words, sample, n, shift, scale))
+
+template<class prng_t>
+void pqRand::basic_engine<prng_t>::Fill_U_even(real_t* const sample, size_t const sampleSize)
+{
+	if(recycleEntropy)
+	{
+		// Every word may reload the bitCache, so they can't be drawn in bulk
+		for(size_t i = 0; i < sampleSize; ++i)
+			sample[i] = U_even();
+		return;
+	}
+	
+	size_t static constexpr blockSize = 256;
+	result_type words[blockSize];
+	
+	for(size_t begin = 0; begin < sampleSize; begin += blockSize)
+	{
+		size_t const count = ((sampleSize - begin) < blockSize) ? (sampleSize - begin) : blockSize;
+		
+		#if PRNG_CAN_FILL
+			prng_t::Fill(words, count);
+			
+			#if PQR_ENGINE_STATS
+			stats.words += count;
+			#endif
+		#else
+			for(size_t i = 0; i < count; ++i)
+				words[i] = (*this)();
+		#endif
+		
+		PQR_DISPATCH(U_evenKernel, (words, sample + begin, count, size_t(bitShiftRight_even), scaleToU_even))
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+template<class prng_t>
+typename pqRand::buffered_prng<prng_t>::result_type pqRand::buffered_prng<prng_t>::Refill()
+{
+	// Remember where the buffer starts, so Unbuffered can rewind the PRNG
+	origin = *this;
+	
+	#if PRNG_CAN_FILL
+		prng_t::Fill(buffer.data(), bufferSize);
+	#else
+		for(result_type& word : buffer)
+			word = prng_t::operator()();
+	#endif
+	
+	index = 1;
+	return buffer.front();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<class prng_t>
+prng_t pqRand::buffered_prng<prng_t>::Unbuffered() const
+{
+	if(index < bufferSize)
+	{
+		// Rewind the PRNG, then replay the words which have already been used
+		prng_t prng(origin);
+		
+		for(size_t i = 0; i < index; ++i)
+			prng();
+		
+		return prng;
+	}
+	else
+		return *this;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+template<class prng_t>
+void pqRand::buffered_prng<prng_t>::Fill(result_type* const words, size_t const numWords)
+{
+	// First the words left in the buffer ...
+	size_t const fromBuffer = ((bufferSize - index) < numWords) ? (bufferSize - index) : numWords;
+	std::copy(buffer.data() + index, buffer.data() + index + fromBuffer, words);
+	index += fromBuffer;
+	
+	// ... then the words after the buffer (where the PRNG already is)
+	#if PRNG_CAN_FILL
+		prng_t::Fill(words + fromBuffer, numWords - fromBuffer);
+	#else
+		for(size_t i = fromBuffer; i < numWords; ++i)
+			words[i] = prng_t::operator()();
+	#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
+#if PRNG_CAN_JUMP
+template<class prng_t>
+void pqRand::buffered_prng<prng_t>::Jump()
+{
+	// Jump from the unbuffered state, discarding the rest of the buffer
+	prng_t::operator=(Unbuffered());
+	index = bufferSize;
+	
+	prng_t::Jump();
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// Need to instantiate the template classes for the object file or shared library
+template class pqRand::basic_engine<pqRand::PRNG_t>;
+
+template class pqRand::buffered_prng<pqRand::PRNG_t>;
+template class pqRand::seeded_uPRNG<pqRand::buffered_prng<pqRand::PRNG_t>>;
+template class pqRand::basic_engine<pqRand::buffered_prng<pqRand::PRNG_t>>;
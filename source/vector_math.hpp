@@ -0,0 +1,622 @@
+/* pqRand: The precise quantile random package
+ * Copyright (C) 2017 Keith Pedersen (Keith.David.Pedersen@gmail.com)
+ *
+ * This package is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the COPYRIGHT_NOTICE for more details.
+ *
+ * Under Section 7 of GPL version 3, you are granted additional
+ * permissions described in the GCC Runtime Library Exception, version
+ * 3.1, as published by the Free Software Foundation.
+ *
+ * You should have received a copy of the GNU General Public License and
+ * a copy of the GCC Runtime Library Exception along with this package;
+ * see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * The algorithms and coefficients of Exp, Expm1, Log, Log1p and Erfc are from fdlibm:
+ *
+ *    Copyright (C) 1993 by Sun Microsystems, Inc. All rights reserved.
+ *
+ *    Developed at SunPro, a Sun Microsystems, Inc. business.
+ *    Permission to use, copy, modify, and distribute this
+ *    software is freely granted, provided that this notice
+ *    is preserved.
+*/
+
+// Internal to libpqr: log, log1p, exp, expm1, pow and erfc which the compiler can vectorize.
+//
+// libm's functions are opaque calls, so a loop which calls them can't be vectorized.
+// These are written without branches (every case is computed, then selected)
+// and without tables, from operations which vectorize in every tier of dispatch.hpp.
+// Each is within 1 ulp of the correctly rounded result (bench/vector_math_bench.cpp
+// measures this against long double libm), including near zero, where the quantile
+// flip-flop depends on log1p and expm1. Any tier gives bit-identical results
+// (they are correctly rounded operations in a fixed order, without contraction).
+//
+// Exp, Expm1, Log and Log1p are fdlibm's algorithms, with its branches turned into selections.
+// Pow is exp(y * log(x)), with log(x) and the product in double-double, so that the error
+// of the exponent's argument stays far below 1 ulp even when |y * log(x)| is ~700.
+// Erfc is fdlibm's rational approximations, with their outer steps in double-double (Horner's
+// method with error-free products and sums), because fdlibm's erfc is ~2 ulp where erfc and
+// its rational function have similar magnitudes, and the tail's exp(-x**2)/x needs
+// a double-double argument and a refined division.
+//
+// Only real_t = double is implemented; the float overloads simply call libm.
+
+#ifndef PQRAND_VECTOR_MATH
+#define PQRAND_VECTOR_MATH
+
+#include "dispatch.hpp"
+#include <algorithm> // min, max
+#include <cmath>
+#include <cstring> // memcpy
+#include <limits>
+
+namespace pqRand
+{
+	namespace vmath
+	{
+		////////////////////////////////////////////////////////////////
+		// Exact helpers
+
+		PQR_ALWAYS_INLINE uint64_t Bits(double const x)
+		{
+			uint64_t bits;
+			std::memcpy(&bits, &x, sizeof(double));
+			return bits;
+		}
+
+		PQR_ALWAYS_INLINE double Real(uint64_t const bits)
+		{
+			double x;
+			std::memcpy(&x, &bits, sizeof(double));
+			return x;
+		}
+
+		/* condition ? a : b, with bit masks. The compiler turns a chain of ?: into one
+		 * many-way branch, which it can't vectorize; use this when a chain has more than two links.
+		*/
+		PQR_ALWAYS_INLINE double Select(bool const condition, double const a, double const b)
+		{
+			uint64_t const mask = condition ? ~uint64_t(0) : uint64_t(0);
+			return Real((Bits(a) bitand mask) bitor (Bits(b) bitand compl mask));
+		}
+
+		double static constexpr roundMagic = 6755399441055744.; // 1.5 * 2^52
+
+		// Round x to the nearest integer (|x| < 2^51), returned as a double and as k
+		PQR_ALWAYS_INLINE double Rint(double const x, int64_t& k)
+		{
+			double const shifted = x + roundMagic;
+			k = int64_t(Bits(shifted) - Bits(roundMagic));
+			return shifted - roundMagic;
+		}
+
+		// Convert a small integer (|k| < 2^51) to double with integer operations
+		// (AVX2 cannot convert 64-bit integers)
+		PQR_ALWAYS_INLINE double ToReal(int64_t const k)
+		{
+			return Real(Bits(roundMagic) + uint64_t(k)) - roundMagic;
+		}
+
+		// 2^k, for -1022 <= k <= 1023
+		PQR_ALWAYS_INLINE double Pow2(int64_t const k)
+		{
+			return Real(uint64_t(k + 1023) << 52);
+		}
+
+		// x * 2^k, for |k| <= 2044, in two steps (only the second can round, into a subnormal)
+		PQR_ALWAYS_INLINE double Scale(double const x, int64_t const k)
+		{
+			// floor(k/2) with a logical shift (SSE2 and AVX2 have no 64-bit arithmetic shift)
+			int64_t const half = int64_t(uint64_t(k + 2046) >> 1) - 1023;
+			return (x * Pow2(half)) * Pow2(k - half);
+		}
+
+		// a * b = product + error, exactly (Dekker; no fused multiply-add), for |a|, |b| < 2^995
+		PQR_ALWAYS_INLINE double TwoProduct(double const a, double const b, double& error)
+		{
+			double static constexpr splitter = 134217729.; // 2^27 + 1
+
+			double const aSplit = splitter * a;
+			double const aHi = aSplit - (aSplit - a);
+			double const aLo = a - aHi;
+
+			double const bSplit = splitter * b;
+			double const bHi = bSplit - (bSplit - b);
+			double const bLo = b - bHi;
+
+			double const product = a * b;
+			error = ((aHi * bHi - product) + aHi * bLo + aLo * bHi) + aLo * bLo;
+			return product;
+		}
+
+		// a + b = sum + error, exactly (Knuth)
+		PQR_ALWAYS_INLINE double TwoSum(double const a, double const b, double& error)
+		{
+			double const sum = a + b;
+			double const bVirtual = sum - a;
+			error = (a - (sum - bVirtual)) + (b - bVirtual);
+			return sum;
+		}
+
+		// One step of Horner's method in double-double: c + (t_hi + t_lo)(hi + lo) = returned + lo
+		PQR_ALWAYS_INLINE double HornerStep(double const c, double const t_hi, double const t_lo, double const hi, double& lo)
+		{
+			double error1, error2;
+			double const sum = TwoSum(c, TwoProduct(t_hi, hi, error1), error2);
+			lo = (error1 + error2) + (t_hi * lo + t_lo * hi);
+			return sum;
+		}
+
+		// (n_hi + n_lo)/(d_hi + d_lo) = hi + lo, refined by the residual of the division
+		PQR_ALWAYS_INLINE double Divide(double const n_hi, double const n_lo, double const d_hi, double const d_lo, double& lo)
+		{
+			double const hi = n_hi / d_hi;
+			double productError;
+			double const product = TwoProduct(hi, d_hi, productError);
+			lo = (((n_hi - product) - productError) + (n_lo - hi * d_lo)) / d_hi;
+			return hi;
+		}
+
+		////////////////////////////////////////////////////////////////
+		// Constants (fdlibm)
+
+		double static constexpr ln2_hi = 6.93147180369123816490e-01; // 0x3fe62e42fee00000 (32 bits, so k * ln2_hi is exact)
+		double static constexpr ln2_lo = 1.90821492927058770002e-10; // 0x3dea39ef35793c76
+		double static constexpr invln2 = 1.44269504088896338700e+00; // 0x3ff71547652b82fe
+		double static constexpr two54 = 1.80143985094819840000e+16;
+
+		double static constexpr infinity = std::numeric_limits<double>::infinity();
+		double static constexpr notANumber = std::numeric_limits<double>::quiet_NaN();
+		double static constexpr maxFinite = std::numeric_limits<double>::max();
+		double static constexpr minNormal = std::numeric_limits<double>::min();
+
+		PQR_ALWAYS_INLINE bool IsZero(double const x) {return (Bits(x) << 1) == 0;} // +/- 0
+
+		////////////////////////////////////////////////////////////////
+		// exp
+
+		/* The kernel of exp (fdlibm e_exp.c), for the argument hi + lo (|hi| < 2^20, |lo| <= ulp(hi)).
+		 * Returns y_hi such that exp(hi + lo) = 2^k * (y_hi + y_lo), where fdlibm's last two
+		 * additions are kept in double-double (so a caller can do more before rounding).
+		 * As in fdlibm, hi - k * ln2_hi is exact (ln2_hi has 32 bits, and |k| < 2^11).
+		*/
+		PQR_ALWAYS_INLINE double ExpKernel(double const hi, double const lo, int64_t& k, double& y_lo)
+		{
+			double static constexpr P1 =  1.66666666666666019037e-01;
+			double static constexpr P2 = -2.77777777770155933842e-03;
+			double static constexpr P3 =  6.61375632143793436117e-05;
+			double static constexpr P4 = -1.65339022054652515390e-06;
+			double static constexpr P5 =  4.13813679705723846039e-08;
+
+			double const kReal = Rint((hi + lo) * invln2, k);
+			double const rHi = hi - kReal * ln2_hi; // Exact
+			double const rLo = kReal * ln2_lo - lo; // r = rHi - rLo
+			double const r = rHi - rLo;
+			double const t = r * r;
+			double const c = r - t*(P1 + t*(P2 + t*(P3 + t*(P4 + t*P5))));
+
+			// 1 - ((rLo - r c/(2 - c)) - rHi)
+			double error1, error2;
+			double const onePlusR = TwoSum(1., rHi, error1);
+			double const y_hi = TwoSum(onePlusR, (r*c)/(2. - c) - rLo, error2);
+			y_lo = error1 + error2;
+			return y_hi;
+		}
+
+		//! exp(x)
+		PQR_ALWAYS_INLINE double Exp(double x)
+		{
+			// exp over/underflows beyond these (NaN is kept)
+			x = (x > 710.) ? 710. : x;
+			x = (x < -746.) ? -746. : x;
+
+			int64_t k;
+			double y_lo;
+			double const y_hi = ExpKernel(x, 0., k, y_lo);
+			return Scale(y_hi + y_lo, k);
+		}
+
+		//! exp(x) - 1 (fdlibm s_expm1.c)
+		PQR_ALWAYS_INLINE double Expm1(double x)
+		{
+			double static constexpr Q1 = -3.33333333333331316428e-02;
+			double static constexpr Q2 =  1.58730158725481460165e-03;
+			double static constexpr Q3 = -7.93650757867487942473e-05;
+			double static constexpr Q4 =  4.00821782732936239552e-06;
+			double static constexpr Q5 = -2.01099218183624371326e-07;
+			double static constexpr halfLn2 = 0.5 * 6.93147180559945286227e-01;
+
+			// expm1 overflows above 710, and rounds to -1 below -40 (NaN is kept)
+			x = (x > 710.) ? 710. : x;
+			x = (x < -40.) ? -40. : x;
+
+			// Reduce x = k ln2 + r, |r| <= ln2/2 (k = 0 when |x| <= ln2/2)
+			int64_t k;
+			double kReal = Rint(x * invln2, k);
+			bool const reduce = (std::fabs(x) > halfLn2);
+			kReal = reduce ? kReal : 0.;
+			k = reduce ? k : 0;
+
+			double const hi = x - kReal * ln2_hi;
+			double const lo = kReal * ln2_lo;
+			double const r = hi - lo;
+			double const c = (hi - r) - lo;
+
+			double const hfx = 0.5 * r;
+			double const hxs = r * hfx;
+			double const r1 = 1. + hxs*(Q1 + hxs*(Q2 + hxs*(Q3 + hxs*(Q4 + hxs*Q5))));
+			double const t = 3. - r1 * hfx;
+			double const e0 = hxs * ((r1 - t)/(6. - r * t));
+
+			double const result_k0 = r - (r * e0 - hxs);
+
+			double const e = (r * (e0 - c) - c) - hxs;
+			double const result_kMinus1 = 0.5 * (r - e) - 0.5;
+			double const result_k1 = (r < -0.25) ? (-2. * (e - (r + 0.5))) : (1. + 2. * (r - e));
+			double const result_kExtreme = Scale(1. - (e - r), k) - 1.; // k <= -2 or k > 56
+
+			// The remaining cases (2 <= k <= 56), with k clamped so every shift is defined
+			int64_t const kc = (k < 1) ? 1 : ((k > 56) ? 56 : k);
+			double const twoToMinusK = Pow2(-kc);
+			double const result_kSmall = ((1. - twoToMinusK) - (e - r)) * Pow2(kc); // k < 20 (1 - 2^-k is exact)
+			double const result_kLarge = ((r - (e + twoToMinusK)) + 1.) * Pow2(kc); // k >= 20
+
+			double result = Select(k < 20, result_kSmall, result_kLarge);
+			result = Select((k <= -2) or (k > 56), result_kExtreme, result);
+			result = Select(k == 1, result_k1, result);
+			result = Select(k == -1, result_kMinus1, result);
+			return Select(k == 0, result_k0, result);
+		}
+
+		////////////////////////////////////////////////////////////////
+		// log
+
+		double static constexpr Lg1 = 6.666666666666735130e-01;
+		double static constexpr Lg2 = 3.999999999940941908e-01;
+		double static constexpr Lg3 = 2.857142874366239149e-01;
+		double static constexpr Lg4 = 2.222219843214978396e-01;
+		double static constexpr Lg5 = 1.818357216161805012e-01;
+		double static constexpr Lg6 = 1.531383769920937332e-01;
+		double static constexpr Lg7 = 1.479819860511658591e-01;
+
+		/* Split x (finite, > 0) into 2^k * m, sqrt(2)/2 <= m < sqrt(2) (as fdlibm e_log.c).
+		 * Returns f = m - 1 (exact); highMantissa is the top 20 bits of x's mantissa.
+		*/
+		PQR_ALWAYS_INLINE double LogReduce(double const x, int64_t& k, uint64_t& highMantissa)
+		{
+			bool const subnormal = (x < minNormal);
+			uint64_t const bits = Bits(subnormal ? (x * two54) : x);
+			uint64_t const mantissa = bits bitand uint64_t(0x000fffffffffffff);
+
+			highMantissa = mantissa >> 32;
+			uint64_t const i = (highMantissa + 0x95f64) bitand 0x100000; // Set when m would be >= sqrt(2)
+
+			k = int64_t(bits >> 52) - 1023 - (subnormal ? 54 : 0) + int64_t(i >> 20);
+			return Real(mantissa bitor ((i xor 0x3ff00000) << 32)) - 1.;
+		}
+
+		//! log(x)
+		PQR_ALWAYS_INLINE double Log(double const x)
+		{
+			int64_t k;
+			uint64_t highMantissa;
+			double const f = LogReduce(x, k, highMantissa);
+
+			double const dk = ToReal(k);
+			double const s = f/(2. + f);
+			double const z = s * s;
+			double const w = z * z;
+			double const t1 = w*(Lg2 + w*(Lg4 + w*Lg6));
+			double const t2 = z*(Lg1 + w*(Lg3 + w*(Lg5 + w*Lg7)));
+			double const R = t2 + t1;
+			double const hfsq = 0.5 * f * f;
+
+			// fdlibm's choice between the two forms (k == 0 is the same formula with dk = 0)
+			bool const useHfsq = ((int64_t(highMantissa) - 0x6147a) bitor (0x6b851 - int64_t(highMantissa))) > 0;
+			double const result = useHfsq ?
+				(dk * ln2_hi - ((hfsq - (s * (hfsq + R) + dk * ln2_lo)) - f)) :
+				(dk * ln2_hi - ((s * (f - R) - dk * ln2_lo) - f));
+
+			double const nonPositive = Select(IsZero(x), -infinity, notANumber);
+			return Select(x > maxFinite, x, Select(x > 0., result, nonPositive));
+		}
+
+		//! log(1 + x) (fdlibm s_log1p.c)
+		PQR_ALWAYS_INLINE double Log1p(double const x)
+		{
+			double static constexpr two53 = 9007199254740992.;
+
+			// Outside of (sqrt(2)/2 - 1, sqrt(2) - 1), reduce 1 + x = 2^k * (1 + f),
+			// with c correcting the rounding of 1 + x.
+			bool const reduce = not ((x > -0.2928932188134524) and (x < 0.4142135623730950));
+			bool const huge = not (x < two53);
+
+			double const onePlusX = 1. + x;
+			double const u = huge ? x : onePlusX;
+			uint64_t const uBits = Bits(u);
+			int64_t const uExponent = int64_t(uBits >> 52) - 1023;
+			double const uError = (uExponent > 0) ? (1. - (onePlusX - x)) : (x - (onePlusX - 1.));
+			double const c_reduced = huge ? 0. : (uError / u);
+
+			uint64_t const highMantissa = (uBits >> 32) bitand 0x000fffff;
+			bool const below = (highMantissa < 0x6a09e); // Normalize to [sqrt(2)/2, sqrt(2))
+			double const f_reduced = Real((uBits bitand uint64_t(0x000fffffffffffff)) bitor
+				(below ? uint64_t(0x3ff0000000000000) : uint64_t(0x3fe0000000000000))) - 1.;
+			int64_t const k_reduced = uExponent + (below ? 0 : 1);
+
+			double const f = reduce ? f_reduced : x;
+			double const c = reduce ? c_reduced : 0.;
+			double const dk = ToReal(reduce ? k_reduced : 0);
+
+			double const hfsq = 0.5 * f * f;
+			double const s = f/(2. + f);
+			double const z = s * s;
+			double const R = z*(Lg1 + z*(Lg2 + z*(Lg3 + z*(Lg4 + z*(Lg5 + z*(Lg6 + z*Lg7))))));
+			double const result = dk * ln2_hi - ((hfsq - (s * (hfsq + R) + (dk * ln2_lo + c))) - f);
+
+			double const belowOne = Select(x >= -1., -infinity, notANumber);
+			return Select(x > maxFinite, x, Select(x > -1., result, belowOne));
+		}
+
+		////////////////////////////////////////////////////////////////
+		// pow
+
+		/* log(x) = hi + lo (x finite, > 0), accurate to ~2^-65 relative.
+		 * With x = 2^k * m, log(m) = 2 atanh(s), s = (m - 1)/(m + 1) (|s| < 0.172),
+		 * where s, s^3 and the 2/3 s^3 term are double-double, and the rest is a double series.
+		*/
+		PQR_ALWAYS_INLINE double LogDoubleDouble(double const x, double& lo)
+		{
+			double static constexpr twoThirds_hi = 6.66666666666666629659e-01;
+			double static constexpr twoThirds_lo = 3.70074341541718826184e-17;
+
+			int64_t k;
+			uint64_t highMantissa;
+			double const f = LogReduce(x, k, highMantissa);
+			double const dk = ToReal(k);
+
+			// s = f/(2 + f) = sHi + sLo, from the residual f - sHi (2 + f) = (f - 2 sHi) - sHi f
+			double const denominator = 2. + f;
+			double const sHi = f / denominator;
+			double productError;
+			double const product = TwoProduct(sHi, f, productError);
+			double const sLo = (((f - 2. * sHi) - product) - productError) / denominator;
+
+			// s^3 = cubeHi + cubeLo
+			double squareError, cubeLo;
+			double const z = TwoProduct(sHi, sHi, squareError);
+			double const cubeHi = TwoProduct(z, sHi, cubeLo);
+			cubeLo += squareError * sHi;
+
+			// 2/3 s^3 = thirdHi + thirdLo
+			double thirdLo;
+			double const thirdHi = TwoProduct(cubeHi, twoThirds_hi, thirdLo);
+			thirdLo += cubeHi * twoThirds_lo + cubeLo * twoThirds_hi;
+
+			// 2 (s^5/5 + s^7/7 + ... + s^25/25), with s^27/27 < 2^-65 |s|
+			double const series = cubeHi * z * (2./5. + z*(2./7. + z*(2./9. + z*(2./11. + z*(2./13. + z*(2./15. +
+				z*(2./17. + z*(2./19. + z*(2./21. + z*(2./23. + z*(2./25.)))))))))));
+
+			// k ln2 + 2 s + 2/3 s^3 + the rest
+			double error1, error2;
+			double const sum1 = TwoSum(dk * ln2_hi, 2. * sHi, error1);
+			double const sum2 = TwoSum(sum1, thirdHi, error2);
+			double const rest = (error1 + error2) + (dk * ln2_lo + (thirdLo + (series + 2. * sLo * (1. + z))));
+
+			double const hi = sum2 + rest;
+			lo = rest - (hi - sum2);
+			return hi;
+		}
+
+		//! x^y, for x >= 0 (negative x returns NaN, as the distributions never need it, and -0 is +0)
+		PQR_ALWAYS_INLINE double Pow(double const x, double const y)
+		{
+			double logLo;
+			double const logHi = LogDoubleDouble(((x > 0.) and (x <= maxFinite)) ? x : 1., logLo);
+
+			// y log(x) = argHi + argLo
+			double argLo;
+			double argHi = TwoProduct(y, logHi, argLo);
+			argLo += y * logLo;
+
+			// Beyond these, x^y over/underflows (and the double-double may be NaN)
+			bool const inRange = (std::fabs(argHi) < 746.);
+			argLo = inRange ? argLo : 0.;
+			argHi = (argHi > 746.) ? 746. : ((argHi < -746.) ? -746. : argHi);
+
+			int64_t k;
+			double y_lo;
+			double const y_hi = ExpKernel(argHi, argLo, k, y_lo);
+			double const result = Scale(y_hi + y_lo, k);
+
+			// IEEE special cases, in order of precedence
+			double const positiveY = (y > 0.) ? infinity : 0.; // x == inf
+			double const negativeY = (y > 0.) ? 0. : infinity; // x == 0
+
+			double value = Select(x > maxFinite, positiveY, result);
+			value = Select(IsZero(x), negativeY, value);
+			value = Select(std::isnan(x) or std::isnan(y) or (x < 0.), notANumber, value);
+			return Select(IsZero(y) or (Bits(x) == Bits(1.)), 1., value);
+		}
+
+		////////////////////////////////////////////////////////////////
+		// erfc (fdlibm s_erf.c)
+
+		//! erfc(x) = 1 - erf(x)
+		PQR_ALWAYS_INLINE double Erfc(double const x)
+		{
+			double static constexpr erx = 8.45062911510467529297e-01;
+
+			// |x| < 0.84375: erfc = 1 - x - x P(x^2)/Q(x^2)
+			double static constexpr pp0 =  1.28379167095512558561e-01;
+			double static constexpr pp1 = -3.25042107247001499370e-01;
+			double static constexpr pp2 = -2.84817495755985104766e-02;
+			double static constexpr pp3 = -5.77027029648944159157e-03;
+			double static constexpr pp4 = -2.37630166566501626084e-05;
+			double static constexpr qq1 =  3.97917223959155352819e-01;
+			double static constexpr qq2 =  6.50222499887672944485e-02;
+			double static constexpr qq3 =  5.08130628187576562776e-03;
+			double static constexpr qq4 =  1.32494738004321644526e-04;
+			double static constexpr qq5 = -3.96022827877536812320e-06;
+
+			// 0.84375 <= |x| < 1.25: erfc = 1 - erx - P(|x| - 1)/Q(|x| - 1)
+			double static constexpr pa0 = -2.36211856075265944077e-03;
+			double static constexpr pa1 =  4.14856118683748331666e-01;
+			double static constexpr pa2 = -3.72207876035701323847e-01;
+			double static constexpr pa3 =  3.18346619901161753674e-01;
+			double static constexpr pa4 = -1.10894694282396677476e-01;
+			double static constexpr pa5 =  3.54783043256182359371e-02;
+			double static constexpr pa6 = -2.16637559486879084300e-03;
+			double static constexpr qa1 =  1.06420880400844228286e-01;
+			double static constexpr qa2 =  5.40397917702171048937e-01;
+			double static constexpr qa3 =  7.18286544141962662868e-02;
+			double static constexpr qa4 =  1.26171219808761642112e-01;
+			double static constexpr qa5 =  1.36370839120290507362e-02;
+			double static constexpr qa6 =  1.19844998467991074170e-02;
+
+			// 1.25 <= |x| < 1/0.35: erfc = exp(-x^2 - 0.5625 + R(1/x^2)/S(1/x^2))/x
+			double static constexpr ra0 = -9.86494403484714822705e-03;
+			double static constexpr ra1 = -6.93858572707181764372e-01;
+			double static constexpr ra2 = -1.05586262253232909814e+01;
+			double static constexpr ra3 = -6.23753324503260060396e+01;
+			double static constexpr ra4 = -1.62396669462573470355e+02;
+			double static constexpr ra5 = -1.84605092906711035994e+02;
+			double static constexpr ra6 = -8.12874355063065934246e+01;
+			double static constexpr ra7 = -9.81432934416914548592e+00;
+			double static constexpr sa1 =  1.96512716674392571292e+01;
+			double static constexpr sa2 =  1.37657754143519042600e+02;
+			double static constexpr sa3 =  4.34565877475229228821e+02;
+			double static constexpr sa4 =  6.45387271733267880336e+02;
+			double static constexpr sa5 =  4.29008140027567833386e+02;
+			double static constexpr sa6 =  1.08635005541779435134e+02;
+			double static constexpr sa7 =  6.57024977031928170135e+00;
+			double static constexpr sa8 = -6.04244152148580987438e-02;
+
+			// 1/0.35 <= |x| < 28: the same, with other coefficients
+			double static constexpr rb0 = -9.86494292470009928597e-03;
+			double static constexpr rb1 = -7.99283237680523006574e-01;
+			double static constexpr rb2 = -1.77579549177547519889e+01;
+			double static constexpr rb3 = -1.60636384855821916062e+02;
+			double static constexpr rb4 = -6.37566443368389627722e+02;
+			double static constexpr rb5 = -1.02509513161107724954e+03;
+			double static constexpr rb6 = -4.83519191608651397019e+02;
+			double static constexpr sb1 =  3.03380607434824582924e+01;
+			double static constexpr sb2 =  3.25792512996573918826e+02;
+			double static constexpr sb3 =  1.53672958608443695994e+03;
+			double static constexpr sb4 =  3.19985821950859553908e+03;
+			double static constexpr sb5 =  2.55305040643316442583e+03;
+			double static constexpr sb6 =  4.74528541206955367215e+02;
+			double static constexpr sb7 = -2.24409524465858183362e+01;
+
+			double const ax = std::fabs(x);
+
+			// The two small regions share one rational function (with selected coefficients).
+			// Its result has about the magnitude of erfc, so t = x^2, P/Q and the outer steps of P and Q
+			// are double-double (the inner steps' rounding is suppressed by powers of t).
+			bool const tiny = (ax < 0.84375);
+			double xSquaredError;
+			double const xSquared = TwoProduct(x, x, xSquaredError);
+			double const t_hi = tiny ? xSquared : (ax - 1.);
+			double const t_lo = tiny ? xSquaredError : 0.;
+			double P_lo = 0., Q_lo = 0., ratio_lo;
+			double P_hi = (tiny ? pp3 : pa3) + t_hi*((tiny ? pp4 : pa4) + t_hi*((tiny ? 0. : pa5) + t_hi*(tiny ? 0. : pa6)));
+			P_hi = HornerStep(tiny ? pp2 : pa2, t_hi, t_lo, P_hi, P_lo);
+			P_hi = HornerStep(tiny ? pp1 : pa1, t_hi, t_lo, P_hi, P_lo);
+			P_hi = HornerStep(tiny ? pp0 : pa0, t_hi, t_lo, P_hi, P_lo);
+			double Q_hi = (tiny ? qq3 : qa3) + t_hi*((tiny ? qq4 : qa4) + t_hi*((tiny ? qq5 : qa5) + t_hi*(tiny ? 0. : qa6)));
+			Q_hi = HornerStep(tiny ? qq2 : qa2, t_hi, t_lo, Q_hi, Q_lo);
+			Q_hi = HornerStep(tiny ? qq1 : qa1, t_hi, t_lo, Q_hi, Q_lo);
+			Q_hi = HornerStep(1., t_hi, t_lo, Q_hi, Q_lo);
+			double const ratio_hi = Divide(P_hi, P_lo, Q_hi, Q_lo, ratio_lo);
+
+			// 1 - x - x P/Q, with 1 - x and x P/Q exact to the last step (fdlibm's form is ~2 ulp near 0.84375)
+			double oneMinusXError, xRatioError, tinyError;
+			double const oneMinusX = TwoSum(1., -x, oneMinusXError);
+			double const xRatio = TwoProduct(x, ratio_hi, xRatioError);
+			double const tinySum = TwoSum(oneMinusX, -xRatio, tinyError);
+			double const result_tiny = tinySum + ((tinyError + oneMinusXError) - (xRatioError + x * ratio_lo));
+
+			// 1 - erx -/+ P/Q (1 - erx is exact)
+			double smallError;
+			double const smallSum = TwoSum(1. - erx, -ratio_hi, smallError);
+			double const result_small = (x < 0.) ? (1. + (erx + (ratio_hi + ratio_lo))) : (smallSum + (smallError - ratio_lo));
+
+			// The tail, as do the two large regions
+			double const a = std::max(1.25, std::min(ax, 28.)); // NaN is kept
+			bool const near = (a < 2.857142639160156250); // 0x4006DB6D00000000
+
+			// s = 1/a^2 = s_hi + s_lo, and R/S in double-double (as above)
+			double aSquaredError, s_lo;
+			double const aSquared = TwoProduct(a, a, aSquaredError);
+			double const s_hi = Divide(1., 0., aSquared, aSquaredError, s_lo);
+			double R_lo = 0., S_lo = 0., tailRatio_lo;
+			double R_hi = (near ? ra5 : rb5) + s_hi*((near ? ra6 : rb6) + s_hi*(near ? ra7 : 0.));
+			R_hi = HornerStep(near ? ra4 : rb4, s_hi, s_lo, R_hi, R_lo);
+			R_hi = HornerStep(near ? ra3 : rb3, s_hi, s_lo, R_hi, R_lo);
+			R_hi = HornerStep(near ? ra2 : rb2, s_hi, s_lo, R_hi, R_lo);
+			R_hi = HornerStep(near ? ra1 : rb1, s_hi, s_lo, R_hi, R_lo);
+			R_hi = HornerStep(near ? ra0 : rb0, s_hi, s_lo, R_hi, R_lo);
+			double S_hi = (near ? sa5 : sb5) + s_hi*((near ? sa6 : sb6) + s_hi*((near ? sa7 : sb7) + s_hi*(near ? sa8 : 0.)));
+			S_hi = HornerStep(near ? sa4 : sb4, s_hi, s_lo, S_hi, S_lo);
+			S_hi = HornerStep(near ? sa3 : sb3, s_hi, s_lo, S_hi, S_lo);
+			S_hi = HornerStep(near ? sa2 : sb2, s_hi, s_lo, S_hi, S_lo);
+			S_hi = HornerStep(near ? sa1 : sb1, s_hi, s_lo, S_hi, S_lo);
+			S_hi = HornerStep(1., s_hi, s_lo, S_hi, S_lo);
+			double const tailRatio_hi = Divide(R_hi, R_lo, S_hi, S_lo, tailRatio_lo);
+
+			// exp(-a^2 - 0.5625 + R/S), with z = a truncated to 21 bits so -z^2 - 0.5625 is exact
+			double const z = Real(Bits(a) bitand uint64_t(0xffffffff00000000));
+			int64_t k;
+			double y_lo, quotient_lo;
+			double argument_lo;
+			double const argument_hi = TwoSum(-z * z - 0.5625, tailRatio_hi, argument_lo);
+			double const y_hi = ExpKernel(argument_hi, argument_lo + ((z - a) * (z + a) + tailRatio_lo), k, y_lo);
+
+			// exp(...)/a (only the last step rounds)
+			double const quotient_hi = Divide(y_hi, y_lo, a, 0., quotient_lo);
+			double const r = Scale(quotient_hi + quotient_lo, k);
+
+			double const result_tail = (x < 0.) ? (2. - r) : r;
+			double const result_huge = (x < 0.) ? 2. : 0.;
+
+			double result = Select(ax < 28., result_tail, result_huge);
+			result = Select(ax < 1.25, result_small, result);
+			result = Select(tiny, result_tiny, result);
+			return Select(std::isnan(x), x, result);
+		}
+
+		////////////////////////////////////////////////////////////////
+		// real_t = float uses libm
+
+		inline float Exp(float const x) {return std::exp(x);}
+		inline float Expm1(float const x) {return std::expm1(x);}
+		inline float Log(float const x) {return std::log(x);}
+		inline float Log1p(float const x) {return std::log1p(x);}
+		inline float Pow(float const x, float const y) {return std::pow(x, y);}
+		inline float Erfc(float const x) {return std::erfc(x);}
+		
+		////////////////////////////////////////////////////////////////
+		
+		//! The math of static_dist's formulas (which default to static_dist::libm), for the array kernels
+		struct math
+		{
+			template<typename T> PQR_ALWAYS_INLINE static T Exp(T const x) {return vmath::Exp(x);}
+			template<typename T> PQR_ALWAYS_INLINE static T Expm1(T const x) {return vmath::Expm1(x);}
+			template<typename T> PQR_ALWAYS_INLINE static T Log(T const x) {return vmath::Log(x);}
+			template<typename T> PQR_ALWAYS_INLINE static T Log1p(T const x) {return vmath::Log1p(x);}
+			template<typename T> PQR_ALWAYS_INLINE static T Pow(T const x, T const y) {return vmath::Pow(x, y);}
+			template<typename T> PQR_ALWAYS_INLINE static T Erfc(T const x) {return vmath::Erfc(x);}
+		};
+	}
+}
+
+#endif